@@ -0,0 +1,68 @@
+#include <agents-cpp/tools/search_index.h>
+#include <agents-cpp/logger.h>
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+using namespace agents;
+using namespace agents::tools;
+
+// Usage:
+//   search_index_example build <index file> <directory or .jsonl file>...
+//   search_index_example search <index file> <query>
+int main(int argc, char* argv[]) {
+    Logger::init(Logger::Level::INFO);
+
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " build <index> <directory or .jsonl>...\n"
+                  << "       " << argv[0] << " search <index> <query>\n";
+        return 1;
+    }
+
+    String command = argv[1];
+    String index_path = argv[2];
+
+    try {
+        if (command == "build") {
+            auto start = std::chrono::steady_clock::now();
+            SearchIndexBuilder builder(index_path);
+            for (int i = 3; i < argc; ++i) {
+                String source = argv[i];
+                size_t added = std::filesystem::is_directory(source) ?
+                    builder.addDirectory(source) : builder.addJsonLines(source);
+                Logger::info("Added {} documents from {}", added, source);
+            }
+            builder.finish();
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            Logger::info("Built index of {} documents in {} ms", builder.size(), elapsed.count());
+            return 0;
+        }
+
+        if (command == "search") {
+            SearchIndex index(index_path);
+            String query;
+            for (int i = 3; i < argc; ++i) {
+                query += (i > 3 ? " " : "") + String(argv[i]);
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            auto hits = index.search(query, 10);
+            auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start);
+
+            for (const auto& hit : hits) {
+                std::cout << hit.score << "  " << hit.title << "  " << hit.url << "\n    " << hit.snippet << "\n";
+            }
+            Logger::info("{} results from {} documents in {} us", hits.size(), index.documentCount(), elapsed.count());
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        Logger::error("{}", e.what());
+        return 1;
+    }
+
+    std::cerr << "Unknown command: " << command << "\n";
+    return 1;
+}
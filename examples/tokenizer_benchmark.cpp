@@ -0,0 +1,97 @@
+#include <agents-cpp/tokenizer.h>
+#include <agents-cpp/context_manager.h>
+#include <agents-cpp/logger.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+using namespace agents;
+
+// Usage: tokenizer_benchmark [vocab file (.tiktoken or SentencePiece .vocab)] [input text file]
+int main(int argc, char* argv[]) {
+    try {
+        std::shared_ptr<BpeTokenizer> tokenizer;
+        if (argc > 1) {
+            String path = argv[1];
+            bool tiktoken = path.size() >= 9 && path.compare(path.size() - 9, 9, ".tiktoken") == 0;
+            tokenizer = BpeTokenizer::fromFile(
+                path, tiktoken ? BpeTokenizer::Format::TIKTOKEN : BpeTokenizer::Format::SENTENCEPIECE);
+        } else {
+            Logger::info("No vocabulary given, using the byte-level vocabulary");
+            tokenizer = BpeTokenizer::byteLevel();
+        }
+        Logger::info("Vocabulary size: {}", tokenizer->vocabSize());
+
+        String sample;
+        if (argc > 2) {
+            std::ifstream file(argv[2], std::ios::binary);
+            if (!file) {
+                Logger::error("Failed to open {}", argv[2]);
+                return 1;
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            sample = buffer.str();
+        } else {
+            sample = "The agent called the weather tool for San Francisco and got 18°C, "
+                     "then asked the user whether they'd like a forecast for tomorrow.\n"
+                     "def count_tokens(text):\n    return len(encoder.encode(text))  # 42\n";
+        }
+
+        // Repeat the sample to get a stable measurement
+        String text;
+        while (text.size() < 32 * 1024 * 1024) {
+            text += sample;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        size_t tokens = tokenizer->countTokens(text);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Logger::info("countTokens: {} tokens in {:.3f}s, {:.1f} MB/s",
+            tokens, seconds, text.size() / seconds / 1e6);
+
+        // Round trip check
+        String head = text.substr(0, 4096);
+        if (tokenizer->decode(tokenizer->encode(head)) != head) {
+            Logger::error("Decode does not round-trip the input");
+            return 1;
+        }
+
+        // Per-message caching as used when prompts are re-assembled every turn
+        auto cache = std::make_shared<TokenCountCache>(tokenizer);
+        std::vector<String> messages;
+        for (size_t offset = 0; offset + 2048 <= text.size() && messages.size() < 256; offset += 2048) {
+            messages.push_back(text.substr(offset, 2048));
+        }
+
+        start = std::chrono::steady_clock::now();
+        size_t total = 0;
+        for (int turn = 0; turn < 100; ++turn) {
+            for (const auto& message : messages) {
+                total += cache->count(message);
+            }
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        Logger::info("TokenCountCache: 100 turns x {} messages in {:.3f}s ({} hits, {} misses)",
+            messages.size(), seconds, cache->hits(), cache->misses());
+
+        Logger::info("Total counted: {}", total);
+
+        // Plugging the tokenizer into prompt assembly
+        ContextManager context_manager;
+        context_manager.setTokenCounter([cache](const String& content) {
+            return cache->count(content);
+        });
+        Message message;
+        message.role = Message::Role::USER;
+        message.content = sample;
+        Logger::info("Sample message costs {} prompt tokens", context_manager.countTokens(message));
+    } catch (const std::exception& e) {
+        Logger::error("Error: {}", e.what());
+        return 1;
+    }
+
+    return 0;
+}
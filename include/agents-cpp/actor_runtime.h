@@ -0,0 +1,83 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <caf/all.hpp>
+#include <chrono>
+#include <memory>
+#include <utility>
+
+namespace agents {
+
+/**
+ * @brief Options for the process-wide actor runtime
+ */
+struct ActorRuntimeOptions {
+    enum class Policy {
+        STEALING,   // Each thread has its own queue and idle threads steal from busy ones
+        SHARING     // All threads pull from one queue
+    };
+
+    // Scheduler threads shared by every actor; 0 uses the hardware concurrency
+    size_t num_threads = 0;
+
+    // Messages an actor may handle before yielding its thread; 0 keeps the CAF default
+    size_t max_throughput = 0;
+
+    Policy policy = Policy::STEALING;
+
+    // Work stealing: an idle thread polls this many times before backing off, then
+    // polls every moderate_sleep until moderate_poll_attempts are spent, then every relaxed_sleep
+    size_t aggressive_poll_attempts = 100;
+    size_t moderate_poll_attempts = 500;
+    std::chrono::microseconds moderate_sleep{50};
+    std::chrono::milliseconds relaxed_sleep{10};
+};
+
+/**
+ * @brief One CAF actor system shared by all actor workflows and agents
+ *
+ * Every actor in the process is scheduled on the same pool of threads, so
+ * creating many workflows or agents adds actors rather than thread pools.
+ * The runtime starts on first use with the options last passed to
+ * configure(); it cannot be reconfigured once it has started.
+ */
+class ActorRuntime {
+public:
+    ~ActorRuntime();
+
+    ActorRuntime(const ActorRuntime&) = delete;
+    ActorRuntime& operator=(const ActorRuntime&) = delete;
+
+    // Set the options of the process-wide runtime; throws std::logic_error if it has already started
+    static void configure(const ActorRuntimeOptions& options);
+
+    // Process-wide runtime, started on first use
+    static ActorRuntime& global();
+
+    // Underlying actor system
+    caf::actor_system& system();
+
+    // Spawn an actor into the shared system
+    template <class... Ts>
+    auto spawn(Ts&&... args) {
+        return system_->spawn(std::forward<Ts>(args)...);
+    }
+
+    // Options the runtime was started with
+    const ActorRuntimeOptions& getOptions() const;
+
+    // Scheduler threads actually running
+    size_t numThreads() const;
+
+private:
+    explicit ActorRuntime(const ActorRuntimeOptions& options);
+
+    ActorRuntimeOptions options_;
+    size_t num_threads_ = 0;
+
+    // The config must outlive the system built from it
+    caf::actor_system_config config_;
+    std::unique_ptr<caf::actor_system> system_;
+};
+
+} // namespace agents
@@ -5,6 +5,8 @@
 #include <agents-cpp/coroutine_utils.h>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 
 namespace agents {
 
@@ -36,6 +38,9 @@ public:
         int max_consecutive_errors = 3;
         bool human_feedback_enabled = true;
         std::function<bool(const String&, const JsonObject&)> human_in_the_loop;
+        bool parallel_tool_calls = true;        // Run the tool calls of one turn concurrently
+        size_t max_parallel_tool_calls = 4;     // Cap on concurrent tool calls per turn (0 = unlimited)
+        int deadline_ms = 0;                    // Abort run() after this long (0 = no deadline)
     };
     
     Agent(std::shared_ptr<AgentContext> context);
@@ -47,7 +52,7 @@ public:
     // Run the agent with a task using coroutines
     virtual Task<JsonObject> run(const String& task) = 0;
     
-    // Stop the agent
+    // Stop the agent, cancelling in-flight LLM and tool calls of every run in progress
     virtual void stop();
     
     // Get the agent's context
@@ -88,6 +93,24 @@ protected:
     
     // Log a status message
     void logStatus(const String& status);
+    
+    /**
+     * @brief Run a task under the agent's cancellation scope
+     * 
+     * The task sees a cancellation token that is triggered by stop(), by
+     * cancellation of the awaiting coroutine, and by Options::deadline_ms.
+     * Throws folly::OperationCancelled when stopped and folly::FutureTimeout
+     * when the deadline passes.
+     */
+    Task<JsonObject> runCancellable(Task<JsonObject> task);
+    
+    // Cancel every task running under runCancellable(), or the next one to start if none is
+    void cancelRun();
+
+private:
+    std::mutex cancellation_mutex_;
+    std::unordered_set<std::shared_ptr<folly::CancellationSource>> run_sources_;
+    bool stop_pending_ = false;
 };
 
 } // namespace agents 
\ No newline at end of file
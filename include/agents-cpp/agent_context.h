@@ -4,7 +4,11 @@
 #include <agents-cpp/tool.h>
 #include <agents-cpp/llm_interface.h>
 #include <agents-cpp/memory.h>
+#include <agents-cpp/context_manager.h>
+#include <agents-cpp/tool_result_cache.h>
+#include <agents-cpp/tools/tool_registry.h>
 #include <agents-cpp/coroutine_utils.h>
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <map>
@@ -19,6 +23,10 @@ public:
     AgentContext();
     ~AgentContext() = default;
 
+    // Lightweight context for one independent unit of work: shares the LLM, tools, tool
+    // cache and context manager, copies the system prompt and starts with empty memory
+    std::shared_ptr<AgentContext> fork() const;
+
     // Set the LLM to use
     void setLLM(std::shared_ptr<LLMInterface> llm);
     
@@ -40,12 +48,50 @@ public:
     // Get all tools
     std::vector<std::shared_ptr<Tool>> getTools() const;
     
-    // Execute a tool by name using coroutines
+    // Immutable view of the registered tools; hold it for a consistent view across one turn
+    tools::ToolRegistry::SnapshotPtr getToolSnapshot() const;
+    
+    // Set the cache serving repeated calls of cacheable tools (defaults to a cache
+    // of this context and its forks; nullptr disables caching)
+    void setToolResultCache(std::shared_ptr<ToolResultCache> cache);
+    
+    // Get the tool result cache
+    std::shared_ptr<ToolResultCache> getToolResultCache() const;
+    
+    // Set the timeout for tools that do not set their own (0 = no limit)
+    void setToolTimeout(std::chrono::milliseconds timeout);
+    
+    // Execute a tool by name using coroutines; honours the awaiting coroutine's cancellation
     Task<ToolResult> executeTool(const String& name, const JsonObject& params);
     
+    /**
+     * @brief Execute the tool calls of one LLM turn concurrently
+     * 
+     * Calls of serial-only tools run one after another, everything else
+     * runs in parallel. A failing call yields an unsuccessful ToolResult
+     * rather than aborting the others.
+     * 
+     * @param calls Tool name and parameters per call, as in LLMResponse::tool_calls
+     * @param max_concurrency Maximum calls in flight at once; 0 means unlimited
+     * @return One result per call, in the order of the calls
+     */
+    Task<std::vector<ToolResult>> executeTools(
+        const std::vector<std::pair<String, JsonObject>>& calls,
+        size_t max_concurrency = 0
+    );
+    
+    // Set the memory backend (e.g. createConcurrentMemory() for contexts shared across threads)
+    void setMemory(std::shared_ptr<Memory> memory);
+    
     // Get memory
     std::shared_ptr<Memory> getMemory() const;
     
+    // Set the manager that fits prompts into the model's context window (nullptr sends full history)
+    void setContextManager(std::shared_ptr<ContextManager> context_manager);
+    
+    // Get the context manager
+    std::shared_ptr<ContextManager> getContextManager() const;
+    
     // Add a message to the conversation history
     void addMessage(const Message& message);
     
@@ -64,8 +110,25 @@ public:
 private:
     std::shared_ptr<LLMInterface> llm_;
     std::shared_ptr<Memory> memory_;
-    std::map<String, std::shared_ptr<Tool>> tools_;
+    std::shared_ptr<ContextManager> context_manager_;
+    std::shared_ptr<ToolResultCache> tool_cache_;
+    tools::ToolRegistry tools_;
     String system_prompt_;
+    std::chrono::milliseconds tool_timeout_{0};
+    
+    // Record the user message and assemble the messages to send to the LLM
+    std::vector<Message> prepareMessages(const Message& user_message);
+    
+    // Execute an already resolved tool, consulting the result cache
+    Task<ToolResult> executeResolvedTool(std::shared_ptr<Tool> tool, const JsonObject& params);
+    
+    // Run the given calls in order, storing each result at its index
+    Task<void> executeToolGroup(
+        const std::vector<std::pair<String, JsonObject>>& calls,
+        const tools::ToolRegistry::SnapshotPtr& snapshot,
+        std::vector<size_t> indices,
+        std::vector<ToolResult>& results
+    );
 };
 
 } // namespace agents 
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <agents-cpp/agent.h>
 #include <agents-cpp/agent_context.h>
+#include <agents-cpp/actor_runtime.h>
 #include <agents-cpp/coroutine_utils.h>
 #include <caf/all.hpp>
 #include <memory>
@@ -15,6 +16,8 @@ namespace agents {
  * 
  * This class uses the C++ Actor Framework (CAF) to implement a flexible agent
  * that can operate autonomously, use tools, and achieve complex tasks.
+ * Its actors run in the process-wide ActorRuntime, shared with other
+ * agents and workflows.
  */
 class ActorAgent : public Agent {
 public:
@@ -46,8 +49,8 @@ public:
     Task<String> waitForFeedback(const String& message, const JsonObject& context) override;
     
 protected:
-    // Actor system
-    std::unique_ptr<caf::actor_system> actor_system_;
+    // Shared actor system the agent's actors run in, owned by ActorRuntime
+    caf::actor_system* actor_system_ = nullptr;
     
     // Main agent actor
     caf::actor agent_actor_;
@@ -76,7 +79,7 @@ protected:
     // Callback for when the agent errors
     virtual void onError(const String& error);
     
-    // Create and configure the actor system
+    // Spawn the agent's actors into the shared actor system
     virtual void setupActorSystem();
     
     // Setup tool actors
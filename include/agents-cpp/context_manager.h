@@ -0,0 +1,133 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <agents-cpp/memory.h>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace agents {
+
+/**
+ * @brief Policy controlling how a prompt is fitted into the model's context window
+ */
+struct ContextPolicy {
+    /**
+     * @brief What to do with messages between the pinned prefix and the recent turns
+     */
+    enum class MiddleStrategy {
+        DROP,       // Drop the oldest messages that do not fit
+        SUMMARIZE   // Replace them with a summary message
+    };
+
+    // Context window in tokens; 0 looks it up from the model name, and a model
+    // with no registered window is sent its full history untrimmed
+    int max_context_tokens = 0;
+
+    // Tokens kept free for the completion; -1 uses LLMOptions::max_tokens
+    int reserved_output_tokens = -1;
+
+    // Always send the system prompt
+    bool pin_system_prompt = true;
+
+    // Number of most recent turns (a user message and everything after it) always kept verbatim
+    size_t keep_last_turns = 4;
+
+    MiddleStrategy middle_strategy = MiddleStrategy::DROP;
+
+    // Per-message framing overhead charged on top of the content
+    int tokens_per_message = 4;
+};
+
+/**
+ * @brief Assembles prompts that fit a per-model token budget
+ *
+ * Token counts are computed once per distinct message and cached, so
+ * re-assembling the prompt every turn only pays for new messages. The
+ * system prompt is pinned, the last K turns are kept verbatim and the
+ * middle of the conversation is dropped or summarized when it does not fit.
+ */
+class ContextManager {
+public:
+    using TokenCounter = std::function<size_t(const String&)>;
+    using Summarizer = std::function<String(const std::vector<Message>&)>;
+
+    /**
+     * @brief Counters describing the manager's recent work
+     */
+    struct Stats {
+        size_t cache_hits = 0;
+        size_t cache_misses = 0;
+        size_t dropped_messages = 0;
+        size_t summarized_messages = 0;
+        size_t last_prompt_tokens = 0;
+    };
+
+    explicit ContextManager(const ContextPolicy& policy = ContextPolicy());
+
+    // Set the budgeting policy
+    void setPolicy(const ContextPolicy& policy);
+
+    // Get the budgeting policy
+    ContextPolicy getPolicy() const;
+
+    // Set the function used to count tokens (defaults to a ~4 bytes/token estimate)
+    void setTokenCounter(TokenCounter counter);
+
+    // Set the function used to summarize dropped messages
+    void setSummarizer(Summarizer summarizer);
+
+    // Override the context window for models named by the prefix, alone or followed by "-", ":", "@", "/" or "_"
+    void setModelContextWindow(const String& model_prefix, int tokens);
+
+    // Get the context window for a model; 0 if the model is unknown
+    int getContextWindow(const String& model) const;
+
+    // Count the tokens of a message, including framing overhead (cached)
+    size_t countTokens(const Message& message);
+
+    /**
+     * @brief Build the messages to send for the next completion
+     *
+     * @param system_prompt System prompt, pinned at the front if non-empty
+     * @param history Conversation history, oldest first
+     * @param model Model the prompt is sent to
+     * @param max_output_tokens Completion budget used when the policy does not reserve one
+     * @return Messages that fit the model's context window
+     */
+    std::vector<Message> buildPrompt(
+        const String& system_prompt,
+        const std::vector<Message>& history,
+        const String& model,
+        int max_output_tokens
+    );
+
+    // Get counters
+    Stats getStats() const;
+
+private:
+    mutable std::mutex mutex_;
+    ContextPolicy policy_;
+    TokenCounter token_counter_;
+    Summarizer summarizer_;
+    std::map<String, int> context_windows_;
+    // Keyed by message hash; the message is kept so that a hash collision is a miss
+    struct CachedCount {
+        Message message;
+        size_t tokens;
+    };
+    std::unordered_map<size_t, CachedCount> token_cache_;
+    Stats stats_;
+
+    static constexpr size_t kMaxCachedMessages = 1 << 16;
+
+    static size_t hashMessage(const Message& message);
+    static bool sameMessage(const Message& a, const Message& b);
+
+    // Default summarizer: the rendered messages, truncated
+    static String defaultSummary(const std::vector<Message>& messages);
+};
+
+} // namespace agents
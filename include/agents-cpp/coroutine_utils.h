@@ -3,25 +3,39 @@
 #include <agents-cpp/types.h>
 #include <vector>
 #include <memory>
+#include <type_traits>
+#include <utility>
 
 // Try to include from both possible locations
 #if __has_include(<folly/experimental/coro/Task.h>)
   #include <folly/experimental/coro/Task.h>
   #include <folly/experimental/coro/AsyncGenerator.h>
   #include <folly/experimental/coro/BlockingWait.h>
+  #include <folly/experimental/coro/Collect.h>
   #include <folly/experimental/coro/AsyncScope.h>
+  #include <folly/experimental/coro/Baton.h>
+  #include <folly/experimental/coro/BoundedQueue.h>
+  #include <folly/experimental/coro/UnboundedQueue.h>
+  #include <folly/experimental/coro/Timeout.h>
   #include <folly/io/async/ScopedEventBaseThread.h>
   #include <folly/executors/CPUThreadPoolExecutor.h>
   #include <folly/executors/GlobalExecutor.h>
+  #include <folly/CancellationToken.h>
   #define HAS_FOLLY_CORO 1
 #elif __has_include(<folly/coro/Task.h>)
   #include <folly/coro/Task.h>
   #include <folly/coro/AsyncGenerator.h>
   #include <folly/coro/BlockingWait.h>
+  #include <folly/coro/Collect.h>
   #include <folly/coro/AsyncScope.h>
+  #include <folly/coro/Baton.h>
+  #include <folly/coro/BoundedQueue.h>
+  #include <folly/coro/UnboundedQueue.h>
+  #include <folly/coro/Timeout.h>
   #include <folly/io/async/ScopedEventBaseThread.h>
   #include <folly/executors/CPUThreadPoolExecutor.h>
   #include <folly/executors/GlobalExecutor.h>
+  #include <folly/CancellationToken.h>
   #define HAS_FOLLY_CORO 1
 #else
   #include <functional>
@@ -39,10 +53,54 @@ using Task = folly::coro::Task<T>;
 template <typename T>
 using AsyncGenerator = folly::coro::AsyncGenerator<T>;
 
-// Helper to run a coroutine and get the result synchronously
+// Executor for running coroutines
+inline folly::Executor* getExecutor() {
+    static folly::CPUThreadPoolExecutor executor(
+        std::thread::hardware_concurrency(),
+        std::make_shared<folly::NamedThreadFactory>("AgentExecutor"));
+    return &executor;
+}
+
+// Executor for blocking calls (HTTP requests, user callbacks), so they never hold
+// the threads that run coroutines. Threads are added on demand and exit when idle.
+inline folly::Executor* getBlockingExecutor() {
+    static folly::CPUThreadPoolExecutor executor(
+        std::make_pair<size_t, size_t>(256, 0),
+        std::make_shared<folly::NamedThreadFactory>("AgentBlocking"));
+    return &executor;
+}
+
+// Cancellation token of the coroutine on whose behalf the current thread is blocking.
+// Blocking code (tool callbacks, HTTP calls) polls it to give up early.
+inline folly::CancellationToken& currentCancellationToken() {
+    thread_local folly::CancellationToken token;
+    return token;
+}
+
+// Makes a coroutine's cancellation token visible to blocking code on this thread
+class ScopedCancellationToken {
+public:
+    explicit ScopedCancellationToken(folly::CancellationToken token)
+        : previous_(std::exchange(currentCancellationToken(), std::move(token))) {}
+
+    ~ScopedCancellationToken() {
+        currentCancellationToken() = std::move(previous_);
+    }
+
+    ScopedCancellationToken(const ScopedCancellationToken&) = delete;
+    ScopedCancellationToken& operator=(const ScopedCancellationToken&) = delete;
+
+private:
+    folly::CancellationToken previous_;
+};
+
+// Helper to run a coroutine and get the result synchronously. The coroutine observes
+// the cancellation token installed on this thread, so a blocking run nested in a
+// cancellable call is cancelled along with it.
 template <typename T>
 T blockingWait(Task<T>&& task) {
-    return folly::coro::blockingWait(std::move(task));
+    return folly::coro::blockingWait(
+        folly::coro::co_withCancellation(currentCancellationToken(), std::move(task)));
 }
 
 // Helper to run an async generator and collect results
@@ -51,12 +109,37 @@ std::vector<T> collectAll(AsyncGenerator<T>&& generator) {
     return blockingWait(folly::coro::collectAll(std::move(generator)));
 }
 
-// Executor for running coroutines
-inline folly::Executor* getExecutor() {
-    static folly::CPUThreadPoolExecutor executor(
-        std::thread::hardware_concurrency(),
-        std::make_shared<folly::NamedThreadFactory>("AgentExecutor"));
-    return &executor;
+// Run a blocking call on the blocking executor on behalf of the awaiting coroutine.
+// The call sees the coroutine's cancellation token through currentCancellationToken(),
+// the coroutine resumes on its own executor, and folly::OperationCancelled is thrown
+// if the coroutine was cancelled before or during the call.
+template <typename Fn>
+Task<std::invoke_result_t<Fn&>> runBlocking(Fn fn) {
+    using Result = std::invoke_result_t<Fn&>;
+
+    const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+    if (token.isCancellationRequested()) {
+        throw folly::OperationCancelled();
+    }
+
+    auto call = [](Fn fn, folly::CancellationToken token) -> Task<Result> {
+        ScopedCancellationToken scope(std::move(token));
+        co_return fn();
+    };
+    auto task = call(std::move(fn), token).scheduleOn(getBlockingExecutor());
+
+    if constexpr (std::is_void_v<Result>) {
+        co_await std::move(task);
+        if (token.isCancellationRequested()) {
+            throw folly::OperationCancelled();
+        }
+    } else {
+        Result result = co_await std::move(task);
+        if (token.isCancellationRequested()) {
+            throw folly::OperationCancelled();
+        }
+        co_return result;
+    }
 }
 #else
 // Provide a future-based fallback for Task
@@ -3,7 +3,9 @@
 #include <agents-cpp/types.h>
 #include <agents-cpp/tool.h>
 #include <agents-cpp/coroutine_utils.h>
+#include <exception>
 #include <functional>
+#include <optional>
 #include <vector>
 #include <memory>
 
@@ -77,24 +79,24 @@ public:
         std::function<void(const String&, bool)> callback
     ) = 0;
 
-    // Coroutine versions of the above methods
+    // Coroutine versions of the above methods.
+    // The defaults run the blocking method on the blocking executor with the awaiting
+    // coroutine's cancellation token installed, so providers can abort the HTTP transfer
+    // when it is cancelled and the coroutine threads stay free meanwhile.
     
     // Async complete from a prompt
     virtual Task<LLMResponse> completeAsync(const String& prompt) {
-        // Default implementation falls back to synchronous method
-        co_return complete(prompt);
+        co_return co_await runCancellable([&]() { return complete(prompt); });
     }
     
     // Async complete from a list of messages
     virtual Task<LLMResponse> completeAsync(const std::vector<Message>& messages) {
-        // Default implementation falls back to synchronous method
-        co_return complete(messages);
+        co_return co_await runCancellable([&]() { return complete(messages); });
     }
     
     // Async chat from a list of messages
     virtual Task<LLMResponse> chatAsync(const std::vector<Message>& messages) {
-        // Default implementation falls back to synchronous method
-        co_return chat(messages);
+        co_return co_await runCancellable([&]() { return chat(messages); });
     }
     
     // Async chat with tools
@@ -102,19 +104,51 @@ public:
         const std::vector<Message>& messages,
         const std::vector<std::shared_ptr<Tool>>& tools
     ) {
-        // Default implementation falls back to synchronous method
-        co_return chatWithTools(messages, tools);
+        co_return co_await runCancellable([&]() { return chatWithTools(messages, tools); });
     }
     
-    // Stream chat with AsyncGenerator
+    // Stream chat with AsyncGenerator.
+    // The default runs the callback-based streamChat on the blocking executor and yields
+    // chunks as they arrive. The provider must outlive the request, which keeps running
+    // until the transfer ends or the consumer's cancellation token aborts it.
     virtual AsyncGenerator<String> streamChatAsync(
         const std::vector<Message>& messages
     ) {
-        // Default implementation uses the callback-based method
-        // and converts it to an AsyncGenerator
+        struct Stream {
+            folly::coro::UnboundedQueue<std::optional<String>, true, true> chunks;
+            std::exception_ptr error;
+        };
+        auto stream = std::make_shared<Stream>();
         
-        // This will be implemented by derived classes for better performance
-        co_yield "Not implemented";
+        const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+        getBlockingExecutor()->add([this, stream, messages, token]() {
+            try {
+                ScopedCancellationToken scope(token);
+                streamChat(messages, [&stream](const String& chunk, bool /*done*/) {
+                    if (!chunk.empty()) {
+                        stream->chunks.enqueue(chunk);
+                    }
+                });
+            } catch (...) {
+                stream->error = std::current_exception();
+            }
+            stream->chunks.enqueue(std::nullopt);
+        });
+        
+        while (auto chunk = co_await stream->chunks.dequeue()) {
+            co_yield std::move(*chunk);
+        }
+        if (stream->error) {
+            std::rethrow_exception(stream->error);
+        }
+    }
+
+protected:
+    // Run a blocking call on behalf of the awaiting coroutine, throwing
+    // folly::OperationCancelled if that coroutine was cancelled meanwhile
+    template <typename Fn>
+    static Task<LLMResponse> runCancellable(Fn fn) {
+        co_return co_await runBlocking(std::move(fn));
     }
 };
 
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <agents-cpp/coroutine_utils.h>
+#include <cpr/cpr.h>
+
+namespace agents {
+
+/**
+ * @brief Progress callback that aborts an HTTP transfer once the calling coroutine is cancelled
+ *
+ * Captures currentCancellationToken() of the calling thread, which the
+ * LLMInterface async methods install while running a blocking request.
+ */
+inline cpr::ProgressCallback cancellationProgressCallback() {
+    return cpr::ProgressCallback{[token = currentCancellationToken()](auto&&...) {
+        return !token.isCancellationRequested();
+    }};
+}
+
+} // namespace agents
@@ -1,12 +1,54 @@
 #pragma once
 
 #include <agents-cpp/types.h>
+#include <chrono>
+#include <functional>
 #include <vector>
 #include <memory>
 #include <optional>
 
 namespace agents {
 
+class ConversationSummarizer;
+
+/**
+ * @brief Capacity limits for the entries of one memory type
+ * 
+ * A limit of zero is disabled. When a limit is exceeded the least
+ * recently used entries are evicted; entries older than the TTL are
+ * dropped lazily on access and on insertion.
+ */
+struct MemoryCapacityPolicy {
+    size_t max_entries = 0;
+    size_t max_bytes = 0;
+    std::chrono::milliseconds ttl{0};
+};
+
+/**
+ * @brief Capacity limits for the conversation message log
+ * 
+ * The log behaves as a ring buffer: once full, the oldest messages are
+ * dropped and handed to the spill handler (if any). With
+ * spill_to_long_term set, dropped messages are also copied into
+ * LONG_TERM memory under "message:<sequence>".
+ */
+struct MessageLogPolicy {
+    size_t max_messages = 0;
+    size_t max_bytes = 0;
+    bool spill_to_long_term = false;
+};
+
+/**
+ * @brief Size and eviction counters for a memory store
+ */
+struct MemoryStats {
+    size_t entries = 0;
+    size_t bytes = 0;
+    size_t evicted_by_count = 0;
+    size_t evicted_by_bytes = 0;
+    size_t expired = 0;
+};
+
 /**
  * @brief Interface for agent memory storage
  * 
@@ -48,6 +90,24 @@ public:
         MemoryType type = MemoryType::LONG_TERM,
         int max_results = 5
     ) const = 0;
+    
+    // Set capacity limits for a memory type (unbounded by default)
+    virtual void setCapacityPolicy(MemoryType /*type*/, const MemoryCapacityPolicy& /*policy*/) {}
+    
+    // Set capacity limits for the conversation log (unbounded by default)
+    virtual void setMessageLogPolicy(const MessageLogPolicy& /*policy*/) {}
+    
+    // Set a callback that receives messages evicted from the conversation log
+    virtual void setSpillHandler(std::function<void(const Message&)> /*handler*/) {}
+    
+    // Get size and eviction counters for a memory type
+    virtual MemoryStats getStats(MemoryType /*type*/) const { return {}; }
+    
+    // Get size and eviction counters for the conversation log
+    virtual MemoryStats getMessageStats() const { return {}; }
+    
+    // Feed new messages to a summarizer and serve getConversationSummary() from it
+    virtual void setSummarizer(std::shared_ptr<ConversationSummarizer> /*summarizer*/) {}
 };
 
 /**
@@ -55,4 +115,19 @@ public:
  */
 std::shared_ptr<Memory> createMemory();
 
+/**
+ * @brief Render a single message the way conversation summaries show it
+ */
+String renderMessage(const Message& message);
+
+/**
+ * @brief Approximate heap footprint of a JSON value in bytes
+ */
+size_t estimateJsonBytes(const JsonObject& value);
+
+/**
+ * @brief Approximate heap footprint of a message in bytes
+ */
+size_t estimateMessageBytes(const Message& message);
+
 } // namespace agents 
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <agents-cpp/memory.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace agents {
+
+/**
+ * @brief Thread-safe memory for contexts shared between threads
+ * 
+ * Key/value entries are striped over a fixed number of shards per
+ * MemoryType, each guarded by its own reader/writer lock, so writers
+ * only contend when they hash to the same shard.
+ * 
+ * Conversation messages are kept in an append-only log. Writers claim
+ * a slot with a single atomic increment and publish it with a release
+ * store; readers copy the longest published prefix without taking any
+ * lock, so getMessages() always returns a consistent snapshot.
+ */
+class ConcurrentMemory : public Memory {
+public:
+    explicit ConcurrentMemory(size_t shard_count = 16);
+    ~ConcurrentMemory() override;
+
+    ConcurrentMemory(const ConcurrentMemory&) = delete;
+    ConcurrentMemory& operator=(const ConcurrentMemory&) = delete;
+
+    void add(const String& key, const JsonObject& value, MemoryType type = MemoryType::SHORT_TERM) override;
+    
+    std::optional<JsonObject> get(const String& key, MemoryType type = MemoryType::SHORT_TERM) const override;
+    
+    bool has(const String& key, MemoryType type = MemoryType::SHORT_TERM) const override;
+    
+    void remove(const String& key, MemoryType type = MemoryType::SHORT_TERM) override;
+    
+    void clear(MemoryType type = MemoryType::SHORT_TERM) override;
+    
+    void addMessage(const Message& message) override;
+    
+    std::vector<Message> getMessages() const override;
+    
+    String getConversationSummary(int max_length = 0) const override;
+    
+    void setSummarizer(std::shared_ptr<ConversationSummarizer> summarizer) override;
+    
+    std::vector<std::pair<JsonObject, float>> search(
+        const String& query, 
+        MemoryType type = MemoryType::LONG_TERM,
+        int max_results = 5
+    ) const override;
+
+    // Number of messages visible to readers
+    size_t messageCount() const;
+
+private:
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<String, JsonObject> entries;
+    };
+
+    // Append-only message log made of geometrically growing segments
+    class MessageLog {
+    public:
+        MessageLog() = default;
+        ~MessageLog();
+
+        void append(const Message& message);
+        std::vector<Message> snapshot() const;
+        size_t size() const;
+
+    private:
+        struct Slot {
+            std::atomic<bool> ready{false};
+            alignas(Message) unsigned char storage[sizeof(Message)];
+
+            const Message& message() const {
+                return *reinterpret_cast<const Message*>(storage);
+            }
+        };
+
+        static constexpr size_t kFirstSegmentBits = 6;
+        static constexpr size_t kMaxSegments = 48;
+
+        std::array<std::atomic<Slot*>, kMaxSegments> segments_{};
+        std::atomic<size_t> reserved_{0};
+        mutable std::atomic<size_t> committed_{0};
+
+        Slot& slot(size_t index) const;
+        Slot& slotForWrite(size_t index);
+        size_t advanceCommitted() const;
+    };
+
+    static constexpr size_t kMemoryTypeCount = 3;
+
+    size_t shard_mask_;
+    std::array<std::unique_ptr<Shard[]>, kMemoryTypeCount> shards_;
+    MessageLog messages_;
+    std::shared_ptr<ConversationSummarizer> summarizer_;
+
+    Shard& shardFor(const String& key, MemoryType type) const;
+};
+
+/**
+ * @brief Create a thread-safe Memory instance
+ * 
+ * @param shard_count Number of lock stripes per memory type, rounded up to a power of two
+ */
+std::shared_ptr<Memory> createConcurrentMemory(size_t shard_count = 16);
+
+} // namespace agents
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <agents-cpp/llm_interface.h>
+#include <functional>
+#include <memory>
+
+namespace agents {
+
+/**
+ * @brief Options for incremental conversation summarization
+ */
+struct ConversationSummarizerOptions {
+    // Turns (a user message and everything after it) per summarized chunk
+    size_t turns_per_chunk = 8;
+
+    // Summaries per level before they are merged into one summary a level up
+    size_t summaries_per_level = 4;
+
+    // Upper bound on a single summary, in characters
+    size_t max_summary_length = 2000;
+
+    // Summarize closed chunks on the shared executor instead of inline
+    bool background = true;
+};
+
+/**
+ * @brief Maintains a hierarchical summary of a conversation as it grows
+ *
+ * Messages are rendered once as they arrive. When a chunk of turns
+ * closes, it is summarized (by the LLM, or by a custom summarize
+ * function) in the background; once a level holds enough summaries they
+ * are merged into a single summary one level up, so the summary stays
+ * bounded however long the session runs. Until its summary is ready a
+ * closed chunk is reported verbatim, so reads never block on the LLM.
+ *
+ * The assembled summary is cached and only rebuilt when a chunk closes or
+ * a summary lands, so reading it does not depend on the history length.
+ * Thread-safe.
+ */
+class ConversationSummarizer {
+public:
+    // Produces a summary of rendered conversation text within a character budget
+    using SummarizeFunction = std::function<String(const String& text, size_t max_length)>;
+
+    /**
+     * @brief Counters describing the summarizer's work
+     */
+    struct Stats {
+        size_t messages = 0;
+        size_t chunks_closed = 0;
+        size_t summaries = 0;
+        size_t merges = 0;
+        size_t failures = 0;
+    };
+
+    // Throws std::invalid_argument when llm is null
+    explicit ConversationSummarizer(
+        std::shared_ptr<LLMInterface> llm,
+        const ConversationSummarizerOptions& options = ConversationSummarizerOptions()
+    );
+
+    // Throws std::invalid_argument when summarize is empty
+    ConversationSummarizer(
+        SummarizeFunction summarize,
+        const ConversationSummarizerOptions& options = ConversationSummarizerOptions()
+    );
+
+    // Record a message; closes the current chunk when a new turn starts past the chunk size
+    void observe(const Message& message);
+
+    // Summaries of closed chunks followed by the verbatim text of the open chunk
+    String getSummary() const;
+
+    // Close the open chunk and wait until all pending summaries are done
+    void flush();
+
+    // Forget everything, keeping options and summarize function
+    void clear();
+
+    // Get counters
+    Stats getStats() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+
+    // Summarize with the LLM
+    static String summarizeWithLLM(
+        const std::shared_ptr<LLMInterface>& llm,
+        const String& text,
+        size_t max_length
+    );
+};
+
+/**
+ * @brief Create a summarizer backed by an LLM
+ */
+std::shared_ptr<ConversationSummarizer> createConversationSummarizer(
+    std::shared_ptr<LLMInterface> llm,
+    const ConversationSummarizerOptions& options = ConversationSummarizerOptions()
+);
+
+} // namespace agents
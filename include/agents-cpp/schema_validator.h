@@ -0,0 +1,103 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace agents {
+
+/**
+ * @brief A JSON Schema subset compiled into a flat validator program
+ *
+ * Supports "type" (a name or a list of names), "enum", "minimum",
+ * "maximum", "minLength", "maxLength", "minItems", "maxItems", "items",
+ * "properties", "required", "additionalProperties": false and "default".
+ * Unknown type names accept any value.
+ * The schema is compiled once into an array of nodes referencing shared
+ * pools of property and enum entries; validating a value walks that array
+ * and allocates nothing unless it fails or has to rewrite the value.
+ */
+class SchemaValidator {
+public:
+    /**
+     * @brief Outcome of checking a value
+     */
+    enum class Status {
+        VALID,              // The value can be used as is
+        NEEDS_NORMALIZE,    // Valid once defaults are filled in or values coerced
+        INVALID
+    };
+
+    SchemaValidator() = default;
+
+    // Compile a schema; throws std::invalid_argument for malformed schemas
+    explicit SchemaValidator(const JsonObject& schema);
+
+    /**
+     * @brief Check a value without modifying it
+     *
+     * @param value Value to check
+     * @param coerce Whether mismatched scalars whose coerced value is valid (e.g. "3" or 3.0 for an integer) count as valid
+     * @param error Receives a description of the first problem, if any
+     */
+    Status check(const JsonObject& value, bool coerce, String* error = nullptr) const;
+
+    // Fill in defaults and coerce scalars in place; returns false if the value is invalid
+    bool normalize(JsonObject& value, bool coerce, String* error = nullptr) const;
+
+    // Whether a schema has been compiled
+    bool empty() const;
+
+private:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    enum TypeBits : uint8_t {
+        TYPE_NULL = 1 << 0,
+        TYPE_BOOLEAN = 1 << 1,
+        TYPE_INTEGER = 1 << 2,
+        TYPE_NUMBER = 1 << 3,
+        TYPE_STRING = 1 << 4,
+        TYPE_ARRAY = 1 << 5,
+        TYPE_OBJECT = 1 << 6,
+        TYPE_ANY = 0x7f
+    };
+
+    struct Node {
+        uint8_t types = TYPE_ANY;
+        bool closed = false;            // additionalProperties: false
+        std::optional<double> minimum;
+        std::optional<double> maximum;
+        size_t min_length = 0;          // String length or array size
+        size_t max_length = SIZE_MAX;
+        uint32_t enum_begin = 0;
+        uint32_t enum_count = 0;
+        uint32_t properties_begin = 0;  // Sorted by name
+        uint32_t properties_count = 0;
+        uint32_t items = kNone;
+    };
+
+    struct Property {
+        String name;
+        uint32_t node = kNone;
+        bool required = false;
+        std::optional<JsonObject> default_value;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<Property> properties_;
+    std::vector<JsonObject> enums_;
+
+    uint32_t compile(const JsonObject& schema);
+
+    Status checkNode(uint32_t index, const JsonObject& value, bool coerce, String* error) const;
+    bool normalizeNode(uint32_t index, JsonObject& value, bool coerce, String* error) const;
+
+    // Type and range checks shared by check and normalize; sets coercible if a coercion would fix it
+    bool checkScalar(const Node& node, const JsonObject& value, bool coerce, bool& coercible, String* error) const;
+    static bool coerceScalar(uint8_t types, JsonObject& value);
+    static uint8_t typeOf(const JsonObject& value);
+    static bool lookupProperty(const Property* begin, const Property* end, const String& name);
+};
+
+} // namespace agents
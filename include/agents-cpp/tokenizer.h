@@ -0,0 +1,152 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace agents {
+
+/**
+ * @brief Byte-pair-encoding tokenizer for client-side token counting
+ *
+ * Loads tiktoken-style rank files (cl100k_base, o200k_base: one
+ * "<base64 token> <rank>" per line) and SentencePiece vocab exports
+ * ("<piece>\t<score>" per line). Merges follow the tiktoken algorithm:
+ * adjacent parts are merged lowest rank first, looking each candidate up
+ * as a slice of the input in a flat open-addressing table, so encoding a
+ * word allocates nothing.
+ *
+ * Pre-tokenization is a hand-written scanner equivalent to the cl100k
+ * split pattern for ASCII text; non-ASCII code points are treated as
+ * letters.
+ */
+class BpeTokenizer {
+public:
+    using TokenId = uint32_t;
+
+    /**
+     * @brief Vocabulary file flavours
+     */
+    enum class Format {
+        TIKTOKEN,       // base64 byte strings ranked by merge priority
+        SENTENCEPIECE   // UTF-8 pieces with scores, "▁" for spaces
+    };
+
+    // Load a vocabulary file, throws std::runtime_error on failure
+    static std::shared_ptr<BpeTokenizer> fromFile(const String& path, Format format);
+
+    // Load a tiktoken-style rank file
+    static std::shared_ptr<BpeTokenizer> fromTiktoken(const String& contents);
+
+    // Load a SentencePiece vocab export
+    static std::shared_ptr<BpeTokenizer> fromSentencePiece(const String& contents);
+
+    // A vocabulary of the 256 single bytes without merges (one token per byte)
+    static std::shared_ptr<BpeTokenizer> byteLevel();
+
+    // Encode text into token ids
+    std::vector<TokenId> encode(const String& text) const;
+
+    // Count tokens without materializing ids
+    size_t countTokens(const String& text) const;
+
+    // Decode token ids back to text
+    String decode(const std::vector<TokenId>& tokens) const;
+
+    // Number of tokens in the vocabulary
+    size_t vocabSize() const;
+
+    // Vocabulary format
+    Format getFormat() const;
+
+private:
+    static constexpr uint32_t kNoRank = UINT32_MAX;
+
+    // Slot of the merge table; empty slots have len == 0
+    struct Entry {
+        uint64_t hash = 0;
+        uint32_t offset = 0;
+        uint32_t len = 0;
+        uint32_t rank = kNoRank;
+        TokenId id = 0;
+    };
+
+    Format format_;
+
+    // Token bytes packed into one arena, indexed by id
+    String arena_;
+    std::vector<uint32_t> token_offsets_;
+    std::vector<uint32_t> token_lengths_;
+
+    // Merge table keyed by token bytes
+    std::vector<Entry> table_;
+    uint64_t table_mask_ = 0;
+
+    // Cheap rejection before hashing: longest token, and which two-byte prefixes exist
+    size_t max_token_length_ = 0;
+    std::vector<uint64_t> prefix_bits_;
+
+    // Byte fallback ids (SentencePiece) or single-byte tokens (tiktoken)
+    std::vector<TokenId> byte_tokens_;
+    bool has_byte_tokens_ = false;
+    TokenId unknown_id_ = 0;
+
+    explicit BpeTokenizer(Format format);
+
+    void addToken(TokenId id, const String& bytes);
+    void buildTable(const std::vector<std::pair<TokenId, uint32_t>>& mergeable);
+
+    const Entry* lookup(const char* data, size_t len) const;
+
+    // Visit each pre-tokenized piece of the text
+    template <typename Fn>
+    void forEachPiece(const String& text, Fn&& fn) const;
+
+    // Run BPE over one piece, calling emit(id) per resulting token
+    template <typename Emit>
+    void encodePiece(const char* data, size_t len, Emit&& emit) const;
+
+    // SentencePiece normalization: dummy prefix and space markers
+    String normalize(const String& text) const;
+};
+
+/**
+ * @brief Thread-safe, bounded cache of token counts keyed by text
+ *
+ * Sharded so concurrent agents counting different messages rarely
+ * contend. Meant for counting the same conversation messages turn after
+ * turn without re-tokenizing them.
+ */
+class TokenCountCache {
+public:
+    explicit TokenCountCache(std::shared_ptr<const BpeTokenizer> tokenizer, size_t max_entries = 1 << 16);
+
+    // Count tokens, serving repeated texts from the cache
+    size_t count(const String& text);
+
+    // Drop all cached counts
+    void clear();
+
+    size_t hits() const;
+    size_t misses() const;
+
+private:
+    static constexpr size_t kShardCount = 16;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<uint64_t, uint32_t> counts;
+    };
+
+    std::shared_ptr<const BpeTokenizer> tokenizer_;
+    size_t max_entries_per_shard_;
+    Shard shards_[kShardCount];
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+};
+
+} // namespace agents
@@ -1,10 +1,21 @@
 #pragma once
 
 #include <agents-cpp/types.h>
+#include <agents-cpp/coroutine_utils.h>
+#include <agents-cpp/schema_validator.h>
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <vector>
+
+namespace folly::fibers {
+class Semaphore;
+}
 
 namespace agents {
 
+class ToolExecutor;
+
 // Result of a tool execution
 struct ToolResult {
     bool success;
@@ -15,13 +26,20 @@ struct ToolResult {
 // Callback type for tool execution
 using ToolCallback = std::function<ToolResult(const JsonObject&)>;
 
+// Callback type for tools that are natively asynchronous (they must not block)
+using AsyncToolCallback = std::function<Task<ToolResult>(const JsonObject&)>;
+
 /**
  * @brief Interface for tools that an agent can use
  * 
  * Tools are capabilities that the LLM can use to interact with the outside world.
  * Each tool has a name, description, set of parameters, and execution logic.
+ * 
+ * Blocking callbacks are run by executeAsync() on a ToolExecutor pool,
+ * limited to the tool's maximum concurrency; async callbacks run inline
+ * on the caller's executor.
  */
-class Tool {
+class Tool : public std::enable_shared_from_this<Tool> {
 public:
     Tool(const String& name, const String& description);
     virtual ~Tool() = default;
@@ -38,21 +56,82 @@ public:
     // Set the execution callback
     void setCallback(ToolCallback callback);
     
+    // Set a non-blocking execution callback, used by executeAsync() instead of the pool
+    void setAsyncCallback(AsyncToolCallback callback);
+    
+    // Limit how many calls of this tool run at once (0 = unlimited)
+    void setMaxConcurrency(size_t max_concurrency);
+    size_t getMaxConcurrency() const;
+    
+    // Abandon calls that run longer than this with a timeout result (0 = no limit)
+    void setTimeout(std::chrono::milliseconds timeout);
+    std::chrono::milliseconds getTimeout() const;
+    
+    // Declare the tool pure enough to memoize successful results for ttl (0 = until evicted)
+    void setCacheable(bool cacheable, std::chrono::milliseconds ttl = std::chrono::milliseconds(0));
+    bool isCacheable() const;
+    std::chrono::milliseconds getCacheTtl() const;
+    
+    // Tools whose cached results a successful call of this tool makes stale
+    void setInvalidates(const std::vector<String>& tool_names);
+    const std::vector<String>& getInvalidates() const;
+    
+    // Never run two calls of this tool at the same time within one turn
+    void setSerialOnly(bool serial_only);
+    bool isSerialOnly() const;
+    
+    // Run blocking callbacks on this executor instead of ToolExecutor::global()
+    void setExecutor(std::shared_ptr<ToolExecutor> executor);
+    
+    // Complete work deferred by earlier calls (e.g. batched fsyncs); run at the end of each turn
+    void setFlushCallback(std::function<void()> callback);
+    bool hasFlushCallback() const;
+    
+    // Run the flush callback on the tool's executor, if there is one
+    Task<void> flushAsync() const;
+    
     // Execute the tool with the given parameters
     virtual ToolResult execute(const JsonObject& params) const;
     
+    // Execute the tool without blocking the calling coroutine's executor. Honours the
+    // awaiting coroutine's cancellation; the timeout applies when the tool has none of its own.
+    virtual Task<ToolResult> executeAsync(
+        const JsonObject& params,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0)
+    ) const;
+    
     // Validate parameters against schema
     bool validateParameters(const JsonObject& params) const;
+    
+    // Accept scalars of the wrong JSON type when they convert cleanly, e.g. "3" for an integer
+    void setCoerceParameters(bool coerce);
 
 protected:
     String name_;
     String description_;
     ParameterMap parameters_;
     ToolCallback callback_;
+    AsyncToolCallback async_callback_;
     JsonObject schema_;
+    size_t max_concurrency_ = 0;
+    bool serial_only_ = false;
+    std::chrono::milliseconds timeout_{0};
+    bool cacheable_ = false;
+    std::chrono::milliseconds cache_ttl_{0};
+    std::vector<String> invalidates_;
+    std::shared_ptr<folly::fibers::Semaphore> concurrency_limit_;
+    std::shared_ptr<ToolExecutor> executor_;
+    std::function<void()> flush_callback_;
+
+    // Compiled from the parameter schema by updateSchema()
+    SchemaValidator validator_;
+    bool coerce_parameters_ = false;
 
     // Update schema when parameters change
     void updateSchema();
+    
+    // Validate params, filling normalized when defaults or coercions apply; returns an error message if invalid
+    std::optional<String> checkParameters(const JsonObject& params, std::optional<JsonObject>& normalized) const;
 };
 
 /**
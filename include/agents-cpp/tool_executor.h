@@ -0,0 +1,90 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <agents-cpp/tool.h>
+#include <agents-cpp/coroutine_utils.h>
+#include <folly/fibers/Semaphore.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
+namespace agents {
+
+/**
+ * @brief Options for the pool that runs blocking tool callbacks
+ */
+struct ToolExecutorOptions {
+    // Threads dedicated to tool work
+    size_t num_threads = 8;
+
+    // Tool calls allowed to run or queue on the pool at once; 0 means unlimited
+    size_t max_in_flight = 64;
+
+    // Timeout for calls that do not set one; 0 means none
+    std::chrono::milliseconds default_timeout{0};
+};
+
+/**
+ * @brief Bounded thread pool for blocking tool callbacks
+ *
+ * Tools whose callbacks block (HTTP, subprocesses, file I/O) run here
+ * rather than on the coroutine executor, so a slow tool cannot pin the
+ * threads that drive agents and LLM calls. Callers suspend, without
+ * holding a thread, while waiting for a per-tool slot and then a global
+ * slot; the awaiting coroutine resumes on its own executor afterwards.
+ *
+ * A call stops being awaited as soon as it times out or the awaiting
+ * coroutine is cancelled, and a structured timeout or cancellation result
+ * is returned. The callback itself cannot be interrupted: it keeps its
+ * pool slot until it returns and should poll currentCancellationToken().
+ */
+class ToolExecutor {
+public:
+    explicit ToolExecutor(const ToolExecutorOptions& options = ToolExecutorOptions());
+    ~ToolExecutor();
+
+    ToolExecutor(const ToolExecutor&) = delete;
+    ToolExecutor& operator=(const ToolExecutor&) = delete;
+
+    // Process-wide pool used by tools without an executor of their own
+    static ToolExecutor& global();
+
+    /**
+     * @brief Run a blocking callback on the pool
+     *
+     * @param work The blocking callback
+     * @param tool_limit Per-tool concurrency limit to hold while running, or nullptr
+     * @param timeout Time after which the call is abandoned; 0 uses the default timeout
+     * @return The callback's result; exceptions propagate to the caller
+     */
+    Task<ToolResult> run(
+        std::function<ToolResult()> work,
+        std::shared_ptr<folly::fibers::Semaphore> tool_limit = nullptr,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0)
+    );
+
+    // Result reported for a call abandoned after the given timeout
+    static ToolResult timeoutResult(std::chrono::milliseconds timeout);
+
+    // Result reported for a call abandoned because its caller was cancelled
+    static ToolResult cancelledResult();
+
+    // Underlying executor, for callers that want to schedule their own tasks on it
+    folly::Executor* getExecutor();
+
+    // Calls currently running or queued on the pool
+    size_t inFlight() const;
+
+    // Calls finished since construction
+    size_t completed() const;
+
+private:
+    ToolExecutorOptions options_;
+    std::unique_ptr<folly::CPUThreadPoolExecutor> pool_;
+    std::unique_ptr<folly::fibers::Semaphore> in_flight_limit_;
+    std::atomic<size_t> in_flight_{0};
+    std::atomic<size_t> completed_{0};
+};
+
+} // namespace agents
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <agents-cpp/tool.h>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace agents {
+
+/**
+ * @brief Options for the tool result cache
+ */
+struct ToolResultCacheOptions {
+    // Upper bound on the approximate size of cached results
+    size_t max_bytes = 64 * 1024 * 1024;
+
+    // Upper bound on the number of cached results; 0 means unlimited
+    size_t max_entries = 0;
+
+    // Number of independently locked shards (rounded up to a power of two)
+    size_t shard_count = 16;
+};
+
+/**
+ * @brief Memoizes successful results of cacheable tools
+ *
+ * Keys are the tool name plus the canonical serialization of the
+ * parameters (nlohmann::json keeps object keys sorted), so the same call
+ * with differently ordered arguments hits the same entry. Each shard is an
+ * LRU list under its own mutex and gets an equal share of the limits.
+ * The cache can be saved to and loaded from disk to carry results across
+ * sessions.
+ */
+class ToolResultCache {
+public:
+    /**
+     * @brief Hit and eviction counters
+     */
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t insertions = 0;
+        size_t evictions = 0;
+        size_t expirations = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+
+        double hitRate() const {
+            size_t lookups = hits + misses;
+            return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+        }
+    };
+
+    explicit ToolResultCache(const ToolResultCacheOptions& options = ToolResultCacheOptions());
+
+    ToolResultCache(const ToolResultCache&) = delete;
+    ToolResultCache& operator=(const ToolResultCache&) = delete;
+
+    // Process-wide cache for contexts that opt in to sharing results with setToolResultCache()
+    static ToolResultCache& global();
+
+    // Look up a cached result
+    std::optional<ToolResult> get(const String& tool_name, const JsonObject& params);
+
+    // Cache a result; ttl of zero never expires
+    void put(const String& tool_name, const JsonObject& params, const ToolResult& result,
+             std::chrono::milliseconds ttl);
+
+    // Drop every cached result of a tool
+    void invalidate(const String& tool_name);
+
+    // Drop everything
+    void clear();
+
+    // Get counters
+    Stats getStats() const;
+
+    // Persist unexpired entries as JSON lines; returns the number written
+    size_t save(const String& path) const;
+
+    // Load entries written by save(), skipping expired ones; returns the number loaded
+    size_t load(const String& path);
+
+private:
+    using Clock = std::chrono::system_clock;
+
+    struct Entry {
+        String key;
+        String tool_name;
+        ToolResult result;
+        size_t bytes = 0;
+        std::optional<Clock::time_point> expires_at;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;
+        std::unordered_map<String, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+    };
+
+    ToolResultCacheOptions options_;
+    size_t shard_mask_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+    std::atomic<size_t> insertions_{0};
+    std::atomic<size_t> evictions_{0};
+    std::atomic<size_t> expirations_{0};
+
+    static String makeKey(const String& tool_name, const JsonObject& params);
+    Shard& shardFor(const String& key);
+    void insert(Entry entry);
+    void erase(Shard& shard, std::list<Entry>::iterator it);
+};
+
+} // namespace agents
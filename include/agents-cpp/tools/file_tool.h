@@ -0,0 +1,225 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <agents-cpp/tool.h>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <thread>
+
+namespace agents {
+namespace tools {
+
+/**
+ * @brief Options for the file_read tool
+ */
+struct FileReadOptions {
+    // Files at least this large are memory mapped by streamFile; smaller ones are read with pread.
+    // file_read always reads just the windows it returns. Reading a mapped file that another
+    // process truncates raises SIGBUS, so mapping is off by default; lower it only for files
+    // nothing rewrites while they are read.
+    size_t mmap_threshold = SIZE_MAX;
+
+    // Bytes scanned when looking for lines, and read from files that report no size (/proc)
+    size_t max_read_bytes = 64 * 1024 * 1024;
+
+    // Hard cap on the content returned by one call; larger selections keep a head and tail window
+    size_t max_output_bytes = 64 * 1024;
+
+    // Content returned per call in streaming mode
+    size_t stream_chunk_bytes = 16 * 1024;
+
+    // How long results may be served from the tool result cache; 0 never caches them.
+    // Only file_write and the sandbox tools invalidate cached reads, so a file changed
+    // any other way is served stale until the entry expires.
+    std::chrono::milliseconds cache_ttl{0};
+};
+
+/**
+ * @brief Read-only view of a file's bytes
+ *
+ * Large regular files are mapped, so selecting a range or scanning for
+ * lines never copies the file; small files and files whose size is not
+ * known up front (/proc) are read into a buffer with pread, up to a limit.
+ * Only regular files can be viewed; pipes and devices may never end.
+ */
+class FileView {
+public:
+    // Open a file; throws std::runtime_error if it cannot be read or is not a regular file
+    FileView(const String& path, size_t mmap_threshold, size_t max_read_bytes = SIZE_MAX);
+    ~FileView();
+
+    FileView(const FileView&) = delete;
+    FileView& operator=(const FileView&) = delete;
+
+    // The file's bytes
+    std::string_view bytes() const;
+
+    // Whether the bytes are mapped rather than copied
+    bool isMapped() const;
+
+    // Whether reading stopped at max_read_bytes before the end of the file
+    bool isTruncated() const;
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    size_t mapped_size_ = 0;
+    bool truncated_ = false;
+    String buffer_;
+};
+
+// Append bytes as valid UTF-8, replacing malformed sequences with U+FFFD so the text serializes to JSON
+void appendValidUtf8(String& out, std::string_view in);
+
+/**
+ * @brief Visit a byte range of a file in chunks without copying it
+ *
+ * @param path File to read
+ * @param offset First byte to visit
+ * @param length Bytes to visit; 0 visits up to the end of the file
+ * @param chunk_bytes Size of each chunk
+ * @param on_chunk Called with each chunk and its offset; return false to stop
+ * @param options Read options (for the mmap threshold); unmapped files are read chunk by chunk
+ * @return Bytes visited
+ */
+size_t streamFile(
+    const String& path,
+    size_t offset,
+    size_t length,
+    size_t chunk_bytes,
+    const std::function<bool(std::string_view chunk, size_t offset)>& on_chunk,
+    const FileReadOptions& options = FileReadOptions()
+);
+
+/**
+ * @brief Creates a file_read tool with the given limits
+ */
+std::shared_ptr<Tool> createFileReadTool(const FileReadOptions& options);
+
+/**
+ * @brief Options for a write-behind buffer
+ */
+struct WriteBehindOptions {
+    // Longest a written file waits to be made durable
+    std::chrono::milliseconds max_delay{100};
+
+    // Pending files that trigger an immediate flush
+    size_t max_pending_files = 64;
+
+    // Pending files on one filesystem from which a single syncfs() replaces per-file fsyncs
+    size_t syncfs_threshold = 16;
+};
+
+/**
+ * @brief Defers and batches the fsyncs of file writes
+ *
+ * Writes land in the page cache immediately, so they are visible to
+ * readers, and only durability is deferred: the files and the directories
+ * whose entries changed are synced together on flush(), which happens at
+ * the end of each agent turn, when max_delay has passed or when too many
+ * files are pending. Many files on one filesystem are synced with a single
+ * syncfs() call.
+ */
+class WriteBehindBuffer {
+public:
+    /**
+     * @brief Flush counters
+     */
+    struct Stats {
+        size_t flushes = 0;
+        size_t files_synced = 0;
+        size_t directories_synced = 0;
+        size_t syncfs_calls = 0;
+    };
+
+    explicit WriteBehindBuffer(const WriteBehindOptions& options = WriteBehindOptions());
+
+    // Flushes anything still pending
+    ~WriteBehindBuffer();
+
+    WriteBehindBuffer(const WriteBehindBuffer&) = delete;
+    WriteBehindBuffer& operator=(const WriteBehindBuffer&) = delete;
+
+    // Record a written file, and its directory if an entry was created or renamed
+    void add(const String& path, const String& directory = "");
+
+    // Sync everything pending; returns the number of files synced
+    size_t flush();
+
+    // Files waiting to be synced
+    size_t pending() const;
+
+    // Get counters
+    Stats getStats() const;
+
+private:
+    WriteBehindOptions options_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::set<String> files_;
+    std::set<String> directories_;
+    std::chrono::steady_clock::time_point oldest_;
+    bool stopping_ = false;
+    Stats stats_;
+
+    // Serializes flushes so a file is never synced by two of them at once
+    std::mutex flush_mutex_;
+    std::thread flusher_;
+
+    void run();
+};
+
+/**
+ * @brief Options for the file_write tool
+ */
+struct FileWriteOptions {
+    // Overwrite through a temporary file and rename, so readers never see a partial file
+    bool atomic = true;
+
+    // Make each write durable before returning; ignored when a write-behind buffer is set
+    bool sync = true;
+
+    // Defer fsyncs to this buffer, batching them across the calls of a turn
+    std::shared_ptr<WriteBehindBuffer> write_behind;
+};
+
+/**
+ * @brief Outcome of a file write
+ */
+struct FileWriteResult {
+    size_t bytes_written = 0;
+    std::chrono::microseconds latency{0};
+    bool synced = false;    // Durable before returning
+    bool deferred = false;  // Handed to a write-behind buffer
+};
+
+/**
+ * @brief Write or append content to a file
+ *
+ * @param path File to write; symlinks are written through
+ * @param content Bytes to write
+ * @param append Append instead of replacing the file
+ * @param options Atomicity and durability settings
+ * @return Bytes written and latency; throws std::runtime_error on failure
+ */
+FileWriteResult writeFile(
+    const String& path,
+    const String& content,
+    bool append,
+    const FileWriteOptions& options = FileWriteOptions()
+);
+
+/**
+ * @brief Creates a file_write tool with the given settings
+ */
+std::shared_ptr<Tool> createFileWriteTool(const FileWriteOptions& options);
+
+} // namespace tools
+} // namespace agents
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <agents-cpp/tool.h>
+#include <sys/types.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace agents {
+namespace tools {
+
+/**
+ * @brief Interpreter run by the workers of a sandbox pool
+ */
+enum class SandboxLanguage {
+    SHELL,      // Jobs are bash scripts, each run in a subshell
+    PYTHON      // Jobs are Python source, each run with fresh globals
+};
+
+/**
+ * @brief Options for a pool of sandboxed worker processes
+ */
+struct SandboxPoolOptions {
+    SandboxLanguage language = SandboxLanguage::SHELL;
+
+    // Interpreter executable; empty picks bash or python3 from PATH
+    String interpreter;
+
+    // Workers kept warm
+    size_t pool_size = 2;
+
+    // Jobs a worker runs before it is replaced by a fresh one (0 = never recycle)
+    size_t max_jobs_per_worker = 100;
+
+    // Wall clock limit per job; the worker is killed and replaced when exceeded (0 = none)
+    std::chrono::milliseconds job_timeout{30000};
+
+    // CPU seconds per job (0 = unlimited)
+    size_t cpu_seconds = 30;
+
+    // Address space limit for a worker and its children in bytes (0 = unlimited)
+    size_t memory_bytes = 1024ull * 1024 * 1024;
+
+    // Largest file a job may write in bytes (0 = unlimited)
+    size_t max_file_size = 64 * 1024 * 1024;
+
+    // Open file descriptors per process (0 = unlimited)
+    size_t max_open_files = 256;
+
+    // Processes per user; counts all of the user's processes, so off by default (0 = unlimited)
+    size_t max_processes = 0;
+
+    // Output kept per stream and job; the rest is dropped and reported as truncated
+    size_t max_output_bytes = 1024 * 1024;
+
+    // Directory jobs start in; empty inherits the current directory
+    String working_directory;
+
+    // Pass the whole environment (including any API keys) to workers instead of just PATH, HOME and locale
+    bool inherit_environment = false;
+
+    // cgroup v2 directory to create a child group per worker in; empty or unusable disables cgroups
+    String cgroup_root;
+};
+
+/**
+ * @brief Outcome of a job run in a sandbox worker
+ */
+struct SandboxResult {
+    int exit_code = -1;
+    String stdout_output;
+    String stderr_output;
+    bool timed_out = false;
+    bool cancelled = false;
+    bool truncated = false;
+    std::chrono::milliseconds duration{0};
+};
+
+// Receives output as it is produced; is_stderr tells the streams apart
+using SandboxOutputCallback = std::function<void(bool is_stderr, const String& chunk)>;
+
+/**
+ * @brief Pool of pre-spawned, resource limited interpreter processes
+ *
+ * Each worker is a bash or python3 process started once under rlimits
+ * (and in its own cgroup where one is configured and writable), then fed
+ * jobs so calls pay neither fork/exec nor interpreter startup. Jobs are
+ * sent over a request pipe as "<length>\n<source>" frames; the worker
+ * answers with "<exit code>\n" on a status pipe once the job's output has
+ * been flushed to its stdout and stderr pipes, which are read as the job
+ * runs and forwarded to the output callback.
+ *
+ * Workers are recycled after max_jobs_per_worker jobs, and killed and
+ * replaced when a job times out, is cancelled through
+ * currentCancellationToken() or crashes the interpreter. Jobs share a
+ * worker sequentially, so state a job leaves behind (imported modules,
+ * files, background processes) can be seen by later jobs on it; the pool
+ * limits resources, it does not isolate tenants from each other.
+ *
+ * run() blocks, so tools should call it from a blocking callback, which
+ * ToolExecutor keeps off the coroutine executor.
+ */
+class SandboxPool {
+public:
+    explicit SandboxPool(const SandboxPoolOptions& options = SandboxPoolOptions());
+    ~SandboxPool();
+
+    SandboxPool(const SandboxPool&) = delete;
+    SandboxPool& operator=(const SandboxPool&) = delete;
+
+    /**
+     * @brief Run a job on an idle worker, waiting for one if all are busy
+     *
+     * @param source Shell script or Python code to run
+     * @param on_output Called with output chunks as they arrive, or nullptr
+     * @param timeout Wall clock limit for this job; 0 uses the pool's job timeout
+     * @return Exit status and captured output; throws std::runtime_error if no worker can be started
+     */
+    SandboxResult run(
+        const String& source,
+        const SandboxOutputCallback& on_output = nullptr,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0)
+    );
+
+    // Options the pool was created with
+    const SandboxPoolOptions& getOptions() const;
+
+    // Workers currently alive, busy or idle
+    size_t size() const;
+
+    // Workers started since construction, including replacements
+    size_t spawned() const;
+
+    // Stop all idle workers; busy ones stop when their job completes
+    void shutdown();
+
+    // Shared pools used by the standard shell and python tools, started on first use
+    static std::shared_ptr<SandboxPool> shell();
+    static std::shared_ptr<SandboxPool> python();
+
+private:
+    struct Worker {
+        pid_t pid = -1;
+        int request_fd = -1;
+        int status_fd = -1;
+        int stdout_fd = -1;
+        int stderr_fd = -1;
+        size_t jobs = 0;
+        String cgroup;
+    };
+
+    SandboxPoolOptions options_;
+    std::vector<String> argv_;
+    std::vector<String> environment_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable idle_cv_;
+    std::deque<std::unique_ptr<Worker>> idle_;
+    size_t alive_ = 0;
+    size_t spawned_ = 0;
+    bool shutdown_ = false;
+    bool replenishing_ = false;
+
+    // Start a worker process already counted in alive_; throws std::runtime_error on failure
+    std::unique_ptr<Worker> spawn();
+
+    // Kill and reap a worker, removing its cgroup
+    void destroy(std::unique_ptr<Worker> worker);
+
+    // Take an idle worker or start one if below the pool size
+    std::unique_ptr<Worker> acquire();
+
+    // Return a worker after a job, recycling it if it has run enough jobs
+    void release(std::unique_ptr<Worker> worker);
+
+    // Refill the pool up to its size on the blocking executor, unless that is already underway
+    void scheduleReplenish();
+
+    // Start one warm replacement if workers were lost below the pool size; returns false when none was added
+    bool replenish();
+
+    // Feed one job to a worker and collect its output; returns false if the worker must be destroyed
+    bool execute(Worker& worker, const String& source, const SandboxOutputCallback& on_output,
+                 std::chrono::milliseconds timeout, SandboxResult& result);
+};
+
+/**
+ * @brief Creates a shell tool that runs commands on the given pool
+ *
+ * @param pool Pool of shell workers
+ * @param on_output Receives output while commands run, or nullptr
+ */
+std::shared_ptr<Tool> createShellCommandTool(
+    std::shared_ptr<SandboxPool> pool,
+    SandboxOutputCallback on_output = nullptr
+);
+
+/**
+ * @brief Creates a python tool that runs code on the given pool
+ *
+ * @param pool Pool of Python workers
+ * @param on_output Receives output while code runs, or nullptr
+ */
+std::shared_ptr<Tool> createPythonTool(
+    std::shared_ptr<SandboxPool> pool,
+    SandboxOutputCallback on_output = nullptr
+);
+
+} // namespace tools
+} // namespace agents
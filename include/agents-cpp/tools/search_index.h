@@ -0,0 +1,188 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <agents-cpp/tool.h>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace agents {
+namespace tools {
+
+class FileView;
+
+/**
+ * @brief A document in a local search corpus
+ */
+struct SearchDocument {
+    String title;
+    String url;
+    String text;
+};
+
+/**
+ * @brief A ranked search result
+ */
+struct SearchHit {
+    size_t document = 0;
+    double score = 0.0;
+    String title;
+    String url;
+    String snippet;
+};
+
+/**
+ * @brief Options for building a search index
+ */
+struct SearchIndexBuildOptions {
+    // Threads tokenizing documents; 0 uses the hardware concurrency
+    size_t num_threads = 0;
+
+    // File extensions picked up by addDirectory()
+    std::vector<String> extensions = {".txt", ".md", ".rst", ".html", ".htm"};
+
+    // Documents are truncated to this many bytes
+    size_t max_document_bytes = 16 * 1024 * 1024;
+
+    // Postings buffered in memory across all build threads; a thread that
+    // reaches its share writes them to a sorted run on disk
+    size_t max_postings_memory = 256 * 1024 * 1024;
+};
+
+/**
+ * @brief Builds an on-disk inverted index from a local corpus
+ *
+ * Documents are spooled to a temporary file as they are added, so a
+ * large dump does not have to fit in memory as text. finish() tokenizes
+ * contiguous ranges of documents on separate threads, each spilling its
+ * postings to sorted runs on disk whenever its memory budget is spent,
+ * then k-way merges the runs into one file holding the term dictionary,
+ * the postings (delta and varint encoded) and the stored documents used
+ * for snippets. The file is written under a temporary name and renamed
+ * into place.
+ */
+class SearchIndexBuilder {
+public:
+    explicit SearchIndexBuilder(
+        const String& index_path,
+        const SearchIndexBuildOptions& options = SearchIndexBuildOptions()
+    );
+    ~SearchIndexBuilder();
+
+    SearchIndexBuilder(const SearchIndexBuilder&) = delete;
+    SearchIndexBuilder& operator=(const SearchIndexBuilder&) = delete;
+
+    // Add one document
+    void addDocument(const SearchDocument& document);
+
+    // Add every file with a configured extension below a directory; returns the documents added
+    size_t addDirectory(const String& path);
+
+    // Add JSON lines with "title", "text" and optionally "url" (e.g. WikiExtractor --json output)
+    size_t addJsonLines(const String& path);
+
+    // Documents added so far
+    size_t size() const;
+
+    // Write the index; throws std::runtime_error on failure
+    void finish();
+
+private:
+    struct StoredDocument {
+        uint64_t offset;
+        uint32_t title_length;
+        uint32_t url_length;
+        uint64_t text_length;
+    };
+
+    String index_path_;
+    String spool_path_;
+    SearchIndexBuildOptions options_;
+    std::ofstream spool_;
+    uint64_t spool_size_ = 0;
+    std::vector<StoredDocument> documents_;
+    mutable std::mutex mutex_;
+    bool finished_ = false;
+};
+
+/**
+ * @brief Read-only BM25 search over an index written by SearchIndexBuilder
+ *
+ * The index file is memory mapped and every offset in it is checked
+ * against the file size when it is opened; a query decodes only the postings of
+ * its terms, scores them with BM25 into a reusable accumulator and keeps
+ * the top k in a heap, then cuts a snippet around the densest cluster of
+ * query terms in each hit. Searches may run concurrently.
+ */
+class SearchIndex {
+public:
+    // Open an index; throws std::runtime_error if it is missing or malformed
+    explicit SearchIndex(const String& index_path);
+    ~SearchIndex();
+
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+    // Best matches for a free text query, highest score first
+    std::vector<SearchHit> search(const String& query, size_t top_k = 10) const;
+
+    // Number of indexed documents
+    size_t documentCount() const;
+
+    // Number of distinct terms
+    size_t termCount() const;
+
+    // Stored document by number; throws std::out_of_range
+    SearchDocument getDocument(size_t document) const;
+
+    // BM25 parameters
+    void setBM25(double k1, double b);
+
+private:
+    friend class SearchIndexBuilder;
+
+    // On-disk layout, shared with the builder
+    struct Header;
+    struct TermEntry;
+    struct DocumentEntry;
+
+    std::unique_ptr<FileView> file_;
+    const Header* header_ = nullptr;
+    const TermEntry* terms_ = nullptr;
+    const char* term_text_ = nullptr;
+    const uint8_t* postings_ = nullptr;
+    const DocumentEntry* documents_ = nullptr;
+    const char* store_ = nullptr;
+    double k1_ = 1.2;
+    double b_ = 0.75;
+
+    // Score buffers reused across queries, one per concurrent search
+    mutable std::mutex buffers_mutex_;
+    mutable std::vector<std::unique_ptr<std::vector<float>>> buffers_;
+
+    const TermEntry* findTerm(std::string_view term) const;
+    std::string_view termText(const TermEntry& entry) const;
+    String makeSnippet(std::string_view text, const std::vector<String>& terms) const;
+};
+
+/**
+ * @brief Creates a web_search tool answering from a local index
+ *
+ * @param index Index to search
+ * @param top_k Results returned per query
+ */
+std::shared_ptr<Tool> createWebSearchTool(std::shared_ptr<SearchIndex> index, size_t top_k = 5);
+
+/**
+ * @brief Creates a wikipedia tool answering from a local index of a Wikipedia dump
+ *
+ * @param index Index to search
+ * @param top_k Results returned per query
+ */
+std::shared_ptr<Tool> createWikipediaTool(std::shared_ptr<SearchIndex> index, size_t top_k = 3);
+
+} // namespace tools
+} // namespace agents
@@ -1,9 +1,13 @@
 #pragma once
 
 #include <agents-cpp/tool.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
+#include <cstdint>
 #include <map>
-#include <vector>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace agents {
 namespace tools {
@@ -13,15 +17,64 @@ namespace tools {
  * 
  * The ToolRegistry provides a central place to register, retrieve,
  * and manage tools that agents can use.
+ * 
+ * Reads are served from an immutable snapshot that is swapped atomically
+ * on every change (copy-on-write). The snapshot pointer is a lock-free
+ * folly::atomic_shared_ptr, so lookups never wait on a mutex and may
+ * run concurrently with registrations. Writers are serialized and each
+ * published snapshot carries a version number. Callers that need a
+ * consistent view across several lookups, such as one agent turn, should
+ * hold on to snapshot() rather than querying the registry repeatedly.
  */
 class ToolRegistry {
 public:
-    ToolRegistry() = default;
+    /**
+     * @brief Immutable view of the registry at one version
+     */
+    class Snapshot {
+    public:
+        // Version of the registry this snapshot was taken at
+        uint64_t version() const { return version_; }
+        
+        // Number of tools
+        size_t size() const { return sorted_.size(); }
+        
+        // Get a tool by name, or nullptr
+        std::shared_ptr<Tool> getTool(const String& name) const;
+        
+        // Check if a tool is present
+        bool hasTool(const String& name) const;
+        
+        // All tools, sorted by name
+        const std::vector<std::shared_ptr<Tool>>& getAllTools() const { return sorted_; }
+        
+        // Tool schemas as JSON, computed once per snapshot
+        const JsonObject& getToolSchemas() const { return schemas_; }
+        
+    private:
+        friend class ToolRegistry;
+        
+        uint64_t version_ = 0;
+        std::unordered_map<String, std::shared_ptr<Tool>> by_name_;
+        std::vector<std::shared_ptr<Tool>> sorted_;
+        JsonObject schemas_;
+    };
+    
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+    
+    ToolRegistry();
     ~ToolRegistry() = default;
     
-    // Register a tool
+    // Copies share the current snapshot; later changes to either do not affect the other
+    ToolRegistry(const ToolRegistry& other);
+    ToolRegistry& operator=(const ToolRegistry& other);
+    
+    // Register a tool, replacing any tool with the same name
     void registerTool(std::shared_ptr<Tool> tool);
     
+    // Register several tools as a single version
+    void registerTools(const std::vector<std::shared_ptr<Tool>>& tools);
+    
     // Get a tool by name
     std::shared_ptr<Tool> getTool(const String& name) const;
     
@@ -40,11 +93,24 @@ public:
     // Get tool schemas as JSON
     JsonObject getToolSchemas() const;
     
+    // Current snapshot; never null and safe to hold across changes
+    SnapshotPtr snapshot() const;
+    
+    // Version of the current snapshot, incremented by every change
+    uint64_t version() const;
+    
     // Get the global tool registry
     static ToolRegistry& global();
 
 private:
-    std::map<String, std::shared_ptr<Tool>> tools_;
+    folly::atomic_shared_ptr<Snapshot> snapshot_;
+    std::mutex write_mutex_;
+    
+    // Build and publish a new snapshot from the current one; callers hold write_mutex_
+    void publish(std::map<String, std::shared_ptr<Tool>> tools);
+    
+    // Tools of the current snapshot, ordered by name
+    std::map<String, std::shared_ptr<Tool>> currentTools() const;
 };
 
 /**
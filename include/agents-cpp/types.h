@@ -25,6 +25,7 @@ struct Parameter {
     String type;
     bool required;
     std::optional<json> default_value;
+    json constraints;   // Extra JSON Schema keywords: enum, minimum, maximum, items, properties, ...
 };
 
 using ParameterMap = std::map<String, Parameter>;
@@ -21,6 +21,11 @@ public:
     // Run the workflow with a user input and return the result
     virtual JsonObject run(const String& input) = 0;
     
+    // Run the workflow on behalf of an awaiting coroutine, e.g. as a step of another
+    // workflow, observing its cancellation. The default runs run() on the blocking
+    // executor; workflows with a coroutine entry point await it instead.
+    virtual Task<JsonObject> runTask(const String& input);
+    
     // Run the workflow with a user input asynchronously
     virtual void runAsync(
         const String& input,
@@ -2,9 +2,12 @@
 
 #include <agents-cpp/workflow.h>
 #include <agents-cpp/llm_interface.h>
+#include <agents-cpp/actor_runtime.h>
 
 // Comment out CAF includes to allow building without the actor framework
 #include <caf/all.hpp>
+#include <utility>
+#include <vector>
 
 namespace agents {
 namespace workflows {
@@ -19,6 +22,10 @@ namespace workflows {
  * - Parallelization
  * - Orchestrator-workers
  * - Evaluator-optimizer
+ * 
+ * Workflow actors are spawned into the process-wide ActorRuntime rather
+ * than a system of their own, so workflows share one scheduler pool.
+ * Every actor spawned with spawnActor() is shut down with the workflow.
  */
 class ActorWorkflow : public Workflow {
 public:
@@ -44,16 +51,27 @@ protected:
     // LLM interface for the workflow
     std::shared_ptr<LLMInterface> llm_;
     
-    // Create and configure the actor system - commented out until CAF is available
-    
-    // CAF actor system
-    std::unique_ptr<caf::actor_system> actor_system_;
+    // Shared actor system the workflow's actors run in, owned by ActorRuntime
+    caf::actor_system* actor_system_ = nullptr;
     
     // Core actor that manages the workflow
     caf::actor workflow_actor_;
     
+    // Spawn the workflow's actors into the shared actor system
     virtual void setupActorSystem();
     
+    // Spawn an actor owned by this workflow; it is sent an exit when the workflow is destroyed
+    template <class... Ts>
+    auto spawnActor(Ts&&... args) {
+        auto actor = actor_system_->spawn(std::forward<Ts>(args)...);
+        actors_.push_back(caf::actor_cast<caf::actor>(actor));
+        return actor;
+    }
+    
+private:
+    // Actors spawned by this workflow, which outlive it in the shared system unless told to exit
+    std::vector<caf::actor> actors_;
+    
 };
 
 } // namespace workflows
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <agents-cpp/workflow.h>
+#include <agents-cpp/coroutine_utils.h>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace agents {
+namespace workflows {
+
+/**
+ * @brief A workflow whose steps form a directed acyclic graph
+ *
+ * Each node is an LLM call, a tool call or a nested workflow, and declares
+ * the nodes whose outputs it reads. A node starts as soon as all of its
+ * inputs are available, so independent branches run concurrently up to a
+ * global concurrency budget. When more nodes are ready than the budget
+ * allows, those with the longest remaining path to the end of the graph
+ * (by estimated cost) start first, which keeps the critical path moving.
+ *
+ * A failing node does not stop unrelated branches; the nodes depending on
+ * it are skipped and the failure is reported in the result.
+ */
+class DagWorkflow : public Workflow {
+public:
+    /**
+     * @brief A step in the graph
+     */
+    struct Node {
+        enum class Type {
+            LLM,        // Chat completion on a fresh context
+            TOOL,       // Call of a tool registered in the workflow's context
+            WORKFLOW    // Run of a nested workflow
+        };
+
+        String name;
+        Type type = Type::LLM;
+
+        // Nodes whose outputs this node reads
+        std::vector<String> inputs;
+
+        // LLM: system prompt of the call
+        String system_prompt;
+
+        // LLM and WORKFLOW: builds the prompt or workflow input from the node inputs, which hold
+        // the run input under "input" and each declared input's output under its name
+        std::function<String(const JsonObject&)> prompt_fn;
+
+        // TOOL: tool to call and the parameters to call it with
+        String tool_name;
+        std::function<JsonObject(const JsonObject&)> params_fn;
+
+        // WORKFLOW: workflow to run
+        std::shared_ptr<Workflow> workflow;
+
+        // Estimated duration relative to other nodes, used to prioritize the critical path
+        double cost = 1.0;
+
+        // Reuse the output of an earlier run given the same inputs, while it is among the
+        // most recently used outputs (see setCacheSize)
+        bool memoize = false;
+    };
+
+    /**
+     * @brief Outcome of one node in a run
+     */
+    struct NodeResult {
+        enum class Status {
+            SUCCEEDED,
+            FAILED,
+            SKIPPED,    // An input failed or was skipped
+            CANCELLED
+        };
+
+        String name;
+        Status status = Status::CANCELLED;
+        JsonObject output;
+        String error;
+        std::chrono::milliseconds latency{0};
+        bool cached = false;
+    };
+
+    DagWorkflow(std::shared_ptr<AgentContext> context);
+    ~DagWorkflow() override = default;
+
+    // Add a node; throws std::invalid_argument if the name is taken or reserved
+    void addNode(const Node& node);
+
+    // Add an LLM node; without a prompt function the prompt is the run input followed by the inputs
+    void addLLMNode(
+        const String& name,
+        const std::vector<String>& inputs,
+        const String& system_prompt,
+        std::function<String(const JsonObject&)> prompt_fn = nullptr
+    );
+
+    // Add a tool node
+    void addToolNode(
+        const String& name,
+        const std::vector<String>& inputs,
+        const String& tool_name,
+        std::function<JsonObject(const JsonObject&)> params_fn
+    );
+
+    // Add a nested workflow node; without an input function it gets the same text as an LLM node
+    void addWorkflowNode(
+        const String& name,
+        const std::vector<String>& inputs,
+        std::shared_ptr<Workflow> workflow,
+        std::function<String(const JsonObject&)> input_fn = nullptr
+    );
+
+    // Set the maximum number of nodes running at once (0 = no limit)
+    void setMaxConcurrency(size_t max_concurrency);
+
+    // Set the maximum number of memoized node outputs (0 disables memoization)
+    void setCacheSize(size_t max_entries);
+
+    // Drop all memoized node outputs
+    void clearCache();
+
+    // Run the graph; throws std::invalid_argument if an input is unknown or the graph has a cycle
+    JsonObject run(const String& input) override;
+
+    // Run the graph using coroutines, one result per node in the order the nodes were added
+    agents::Task<std::vector<NodeResult>> execute(const String& input);
+
+private:
+    std::vector<Node> nodes_;
+    std::map<String, size_t> index_;
+    size_t max_concurrency_ = 0;
+
+    // Memoized outputs by node name and inputs, most recently used first
+    using CacheEntry = std::pair<String, JsonObject>;
+    std::mutex cache_mutex_;
+    std::list<CacheEntry> cache_lru_;
+    std::unordered_map<String, std::list<CacheEntry>::iterator> cache_;
+    size_t max_cached_outputs_ = 1024;
+
+    // Progress of one run, shared by its nodes
+    struct RunState;
+
+    // Memoized output for a key, if any
+    std::optional<JsonObject> cachedOutput(const String& key);
+
+    // Memoize an output, evicting the least recently used one past the cache size
+    void cacheOutput(const String& key, const JsonObject& output);
+
+    // Run one node and hand its result to the scheduler
+    agents::Task<void> runNode(size_t index, RunState& state);
+
+    // Produce a node's output from its inputs
+    agents::Task<JsonObject> executeNode(const Node& node, const JsonObject& inputs);
+};
+
+} // namespace workflows
+} // namespace agents
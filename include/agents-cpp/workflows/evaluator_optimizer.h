@@ -1,7 +1,13 @@
 #pragma once
 
 #include <agents-cpp/workflow.h>
+#include <agents-cpp/coroutine_utils.h>
 #include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace agents {
 namespace workflows {
@@ -11,6 +17,14 @@ namespace workflows {
  * 
  * In the evaluator-optimizer workflow, one LLM call generates a response while
  * another provides evaluation and feedback in a loop.
+ * 
+ * In beam mode each round generates several candidates concurrently, each
+ * evaluated as soon as it is written. The first candidate reaching the
+ * minimum acceptable score is accepted and the others are cancelled;
+ * otherwise the next round refines the best candidate so far. Evaluations
+ * are cached by input and output in a bounded LRU, so a regenerated output
+ * that is identical to an earlier one is not scored again; changing the
+ * evaluator prompt, criteria or function clears the cache.
  */
 class EvaluatorOptimizer : public Workflow {
 public:
@@ -38,8 +52,23 @@ public:
     // Set the minimum score to accept a result
     void setMinimumAcceptableScore(double min_score);
     
+    // Set the number of candidates generated concurrently per iteration (1 = serial refinement)
+    void setBeamWidth(size_t beam_width);
+    
+    // Set the maximum number of cached evaluations (0 disables caching)
+    void setEvaluationCacheSize(size_t max_entries);
+    
+    // Drop all cached evaluations
+    void clearEvaluationCache();
+    
     // Run the evaluator-optimizer workflow
     JsonObject run(const String& input) override;
+    
+    // Run the evaluator-optimizer workflow using coroutines
+    Task<JsonObject> execute(const String& input);
+    
+    // Await execute() on behalf of another coroutine
+    Task<JsonObject> runTask(const String& input) override;
 
 private:
     String optimizer_prompt_;
@@ -49,12 +78,41 @@ private:
     std::function<JsonObject(const String&, const String&)> evaluator_;
     int max_iterations_ = 5;
     double min_acceptable_score_ = 0.8;
+    size_t beam_width_ = 1;
+    
+    // Evaluations keyed by input and output, most recently used first
+    using CacheEntry = std::pair<String, JsonObject>;
+    std::mutex cache_mutex_;
+    std::list<CacheEntry> cache_lru_;
+    std::unordered_map<String, std::list<CacheEntry>::iterator> evaluation_cache_;
+    size_t max_cached_evaluations_ = 1024;
+    
+    // Bumped when the cache is cleared, so evaluations begun before are not stored
+    uint64_t cache_generation_ = 0;
+    
+    // Candidates of one iteration
+    struct RoundState;
+    
+    // Generate and evaluate one candidate, accepting it if it scores high enough
+    Task<void> runCandidate(size_t index, const String& input, const JsonObject& feedback, RoundState& state);
+    
+    // Produce a candidate, falling back to the default optimizer if the custom one returns nothing
+    Task<String> generate(const String& input, const JsonObject& feedback);
+    
+    // Score a candidate, falling back to the default evaluator if the custom one returns nothing
+    Task<JsonObject> evaluate(const String& input, const String& output);
+    
+    // Cached evaluation of a candidate, if any
+    std::optional<JsonObject> cachedEvaluation(const String& key, uint64_t& generation);
+    
+    // Cache an evaluation unless the cache was cleared since the lookup
+    void cacheEvaluation(const String& key, const JsonObject& evaluation, uint64_t generation);
     
     // Default optimizer function
-    String defaultOptimizer(const String& input, const JsonObject& feedback);
+    Task<String> defaultOptimizer(const String& input, const JsonObject& feedback);
     
     // Default evaluator function
-    JsonObject defaultEvaluator(const String& input, const String& output);
+    Task<JsonObject> defaultEvaluator(const String& input, const String& output);
 };
 
 } // namespace workflows
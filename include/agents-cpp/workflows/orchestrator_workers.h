@@ -1,6 +1,7 @@
 #pragma once
 
 #include <agents-cpp/workflow.h>
+#include <agents-cpp/coroutine_utils.h>
 #include <vector>
 #include <functional>
 
@@ -12,6 +13,14 @@ namespace workflows {
  * 
  * In the orchestrator-workers workflow, a central LLM dynamically breaks down tasks,
  * delegates them to worker LLMs, and synthesizes their results.
+ * 
+ * Subtasks run concurrently on the agent executor. Each worker has a number
+ * of replicas, the subtasks it may run at once, and an optional global cap
+ * limits the subtasks in flight across all workers. A subtask waits for a
+ * replica of its worker before taking a global slot, so a backlog for one
+ * worker never holds capacity that subtasks for other workers could use.
+ * With incremental dispatch the orchestrator's plan is streamed and each
+ * subtask starts as soon as it has been parsed.
  */
 class OrchestratorWorkers : public Workflow {
 public:
@@ -23,6 +32,9 @@ public:
         String description;
         String system_prompt;
         std::function<JsonObject(const String&, const JsonObject&)> handler;
+        
+        // Subtasks of this worker that may run at once
+        size_t replicas = 1;
     };
     
     OrchestratorWorkers(std::shared_ptr<AgentContext> context);
@@ -49,12 +61,27 @@ public:
         std::function<JsonObject(const String&, const JsonObject&)> handler
     );
     
+    // Set how many subtasks of a worker may run at once; throws std::invalid_argument
+    void setWorkerReplicas(const String& name, size_t replicas);
+    
+    // Set the maximum number of subtasks running at once across all workers (0 = no limit)
+    void setMaxInFlight(size_t max_in_flight);
+    
+    // Start subtasks while the orchestrator is still writing its plan (default: true)
+    void setIncrementalDispatch(bool incremental);
+    
     // Set the result synthesizer function
     void setSynthesizer(std::function<JsonObject(const std::vector<JsonObject>&)> synthesizer);
     
     // Run the orchestrator-workers workflow
     JsonObject run(const String& input) override;
     
+    // Run the orchestrator-workers workflow using coroutines
+    Task<JsonObject> execute(const String& input);
+    
+    // Await execute() on behalf of another coroutine
+    Task<JsonObject> runTask(const String& input) override;
+    
     // Get the schema for available workers
     JsonObject getWorkersSchema() const;
 
@@ -62,12 +89,26 @@ private:
     String orchestrator_prompt_;
     std::vector<Worker> workers_;
     std::function<JsonObject(const std::vector<JsonObject>&)> synthesizer_;
+    size_t max_in_flight_ = 0;
+    bool incremental_dispatch_ = true;
+    
+    // Worker permits and results of one run
+    struct RunState;
     
     // Default synthesizer function
     JsonObject defaultSynthesizer(const std::vector<JsonObject>& results);
     
+    // System prompt asking the orchestrator for its plan
+    String orchestratorSystemPrompt() const;
+    
+    // Start a subtask parsed from the plan
+    void dispatch(const JsonObject& subtask, RunState& state);
+    
+    // Run one subtask once its worker has a free replica, recording the outcome
+    Task<void> runSubtask(size_t index, JsonObject subtask, RunState& state);
+    
     // Execute a worker by name
-    JsonObject executeWorker(
+    Task<JsonObject> executeWorker(
         const String& worker_name,
         const String& task,
         const JsonObject& context_data
@@ -1,10 +1,10 @@
 #pragma once
 
 #include <agents-cpp/workflow.h>
+#include <agents-cpp/coroutine_utils.h>
+#include <chrono>
 #include <vector>
 #include <functional>
-#include <thread>
-#include <future>
 
 namespace agents {
 namespace workflows {
@@ -15,6 +15,15 @@ namespace workflows {
  * Parallelization can manifest in two key variations:
  * 1. Sectioning: Breaking a task into independent subtasks run in parallel.
  * 2. Voting: Running the same task multiple times to get diverse outputs.
+ *
+ * Tasks run concurrently as coroutines on the agent executor, each on its
+ * own forked context so system prompts and histories never mix. A task
+ * that fails or times out is reported in the result rather than failing
+ * the run, and the others are aggregated without it.
+ *
+ * In voting mode votes are tallied as they land, and once the outcome can
+ * no longer change (an answer has the votes the threshold requires, or no
+ * answer can still get them) the remaining calls are cancelled.
  */
 class Parallelization : public Workflow {
 public:
@@ -28,6 +37,24 @@ public:
         std::function<JsonObject(const String&)> result_parser;
     };
     
+    /**
+     * @brief Outcome of one task in a run
+     */
+    struct TaskResult {
+        enum class Status {
+            SUCCEEDED,
+            FAILED,
+            TIMED_OUT,
+            CANCELLED   // Not needed once enough results or votes had arrived
+        };
+        
+        String name;
+        Status status = Status::CANCELLED;
+        JsonObject result;   // Parsed output of a successful task
+        String error;
+        std::chrono::milliseconds latency{0};
+    };
+    
     enum class Mode {
         SECTIONING,  // Break task into subtasks
         VOTING       // Run multiple identical tasks
@@ -60,9 +87,25 @@ public:
     // Set the aggregation function for combining results
     void setAggregator(std::function<JsonObject(const std::vector<JsonObject>&)> aggregator);
     
-    // Set the voting threshold (for VOTING mode)
+    // Set the voting threshold (for VOTING mode); an answer is the consensus once its votes
+    // exceed this share of all tasks, e.g. 4 of 7 at 0.5
     void setVotingThreshold(double threshold);
     
+    // Stop voting as soon as the outcome is decided, cancelling the outstanding votes (default true)
+    void setStopOnQuorum(bool stop_on_quorum);
+    
+    // Set the maximum number of tasks in flight at once (0 = all tasks at once)
+    void setMaxConcurrency(size_t max_concurrency);
+    
+    // Set the time limit per task (0 = no limit); late tasks are cancelled and reported as timed out
+    void setTaskTimeout(std::chrono::milliseconds timeout);
+    
+    // Aggregate as soon as this many tasks have succeeded, cancelling the rest (0 = wait for all)
+    void setMinResults(size_t min_results);
+    
+    // Set a callback receiving each task's outcome as it finishes; calls never overlap
+    void setResultCallback(std::function<void(const TaskResult&)> callback);
+    
     // Run the parallelization workflow
     JsonObject run(const String& input) override;
 
@@ -71,13 +114,30 @@ private:
     std::vector<Task> tasks_;
     std::function<JsonObject(const std::vector<JsonObject>&)> aggregator_;
     double voting_threshold_ = 0.5;
+    bool stop_on_quorum_ = true;
+    size_t max_concurrency_ = 0;
+    std::chrono::milliseconds task_timeout_{0};
+    size_t min_results_ = 0;
+    std::function<void(const TaskResult&)> result_callback_;
+    
+    // Progress of one run, shared by its tasks
+    struct RunState;
+    
+    // Run the tasks concurrently, one result per task in task order
+    agents::Task<std::vector<TaskResult>> runTasksInParallel(const String& input);
+    
+    // Run one task on its own context and record its outcome
+    agents::Task<void> runTask(size_t index, const String& input, RunState& state);
+    
+    // Record a finished task; returns true if the remaining tasks are no longer needed
+    bool recordResult(size_t index, TaskResult result, RunState& state);
     
-    // Run tasks in parallel (implementation uses std::async)
-    std::vector<JsonObject> runTasksInParallel(const String& input);
+    // Votes a single answer needs out of the given number of voters to pass the voting threshold
+    size_t requiredVotes(size_t voters) const;
     
-    // Default aggregators
+    // Default aggregators; votes are counted against all tasks, failed ones abstaining
     JsonObject defaultSectionAggregator(const std::vector<JsonObject>& results);
-    JsonObject defaultVotingAggregator(const std::vector<JsonObject>& results);
+    JsonObject defaultVotingAggregator(const std::vector<JsonObject>& results, size_t voters);
 };
 
 } // namespace workflows
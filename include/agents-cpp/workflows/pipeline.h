@@ -0,0 +1,79 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <agents-cpp/coroutine_utils.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace agents {
+namespace workflows {
+
+/**
+ * @brief Options for running a sequence of stages over many items
+ */
+struct PipelineOptions {
+    // Items each stage works on at once, unless overridden for the stage by name
+    size_t workers = 1;
+    std::map<String, size_t> stage_workers;
+
+    // Items waiting in front of each stage; a full queue holds back the stage feeding it
+    size_t queue_capacity = 8;
+
+    // Deliver results in input order rather than as they complete
+    bool ordered = true;
+};
+
+/**
+ * @brief Runs a stream of items through a fixed sequence of stages
+ *
+ * Each stage has its own pool of workers pulling from a bounded queue, so
+ * stage k of one item overlaps with stage k+1 of the item before it and a
+ * slow stage applies back-pressure instead of letting work pile up. The
+ * number of items admitted but not yet delivered is capped by the total
+ * capacity of the queues and workers, which also bounds the buffer that
+ * restores input order.
+ *
+ * An item whose stage throws is given "error" and "failed_stage" fields
+ * and passes through the remaining stages untouched; an item that is not
+ * an object by then is first wrapped as {"item": ...}.
+ */
+class Pipeline {
+public:
+    /**
+     * @brief One stage of the pipeline
+     */
+    struct Stage {
+        String name;
+
+        // Transform an item in place
+        std::function<agents::Task<void>(JsonObject&)> process;
+    };
+
+    // Throws std::invalid_argument if there are no stages or an option is zero
+    Pipeline(std::vector<Stage> stages, const PipelineOptions& options = PipelineOptions());
+
+    /**
+     * @brief Run items through the stages
+     *
+     * @param items Items to process, consumed as the pipeline has room for them
+     * @param on_result Called with each item's index and final state; calls never overlap
+     */
+    agents::Task<void> run(
+        AsyncGenerator<JsonObject> items,
+        std::function<void(size_t, JsonObject)> on_result
+    );
+
+    // Run items through the stages, returning them in input order
+    agents::Task<std::vector<JsonObject>> run(std::vector<JsonObject> items);
+
+private:
+    std::vector<Stage> stages_;
+    PipelineOptions options_;
+
+    // Workers of one stage
+    size_t workersFor(size_t stage) const;
+};
+
+} // namespace workflows
+} // namespace agents
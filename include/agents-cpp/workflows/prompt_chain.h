@@ -1,6 +1,7 @@
 #pragma once
 
 #include <agents-cpp/workflow.h>
+#include <agents-cpp/workflows/pipeline.h>
 #include <vector>
 #include <functional>
 
@@ -12,6 +13,13 @@ namespace workflows {
  * 
  * Prompt chaining decomposes a task into a sequence of steps, where 
  * each LLM call processes the output of the previous one.
+ * 
+ * A run keeps all of its state to itself and each step talks to the LLM
+ * on a fresh context holding only that step's prompt, so one chain can
+ * serve concurrent runs and prompts do not grow with the conversation of
+ * earlier steps. Batches and streams of inputs can be pipelined: each
+ * step becomes a stage with its own workers, so step k of one input
+ * overlaps with step k+1 of the input before it.
  */
 class PromptChain : public Workflow {
 public:
@@ -24,12 +32,16 @@ public:
         std::function<String(const String&, const JsonObject&)> prompt_fn;
         std::function<bool(const String&, const JsonObject&)> gate_fn;
         bool use_tools = false;
+        
+        // Earlier steps (or "input") whose outputs prompt_fn and gate_fn see; empty means all
+        std::vector<String> inputs;
     };
 
     PromptChain(std::shared_ptr<AgentContext> context);
     ~PromptChain() override = default;
     
-    // Add a step to the chain
+    // Add a step to the chain; throws std::invalid_argument if its name is empty, "input" or
+    // already taken, or if it reads an unknown step
     void addStep(const Step& step);
     
     // Add a simple step with just a system prompt
@@ -50,12 +62,49 @@ public:
         std::function<bool(const String&, const JsonObject&)> gate_fn
     );
     
-    // Run the chain with the given input
+    // Add a step that sees only the outputs of the given earlier steps
+    void addStep(
+        const String& name,
+        const String& system_prompt,
+        const std::vector<String>& inputs,
+        std::function<String(const String&, const JsonObject&)> prompt_fn
+    );
+    
+    // Run the chain with the given input; safe to call concurrently
     JsonObject run(const String& input) override;
+    
+    // Run the chain with the given input using coroutines
+    Task<JsonObject> execute(const String& input);
+    
+    // Await execute() on behalf of another coroutine
+    Task<JsonObject> runTask(const String& input) override;
+    
+    // Run the chain over many inputs with the steps pipelined; results are in input order
+    std::vector<JsonObject> runBatch(
+        const std::vector<String>& inputs,
+        const PipelineOptions& options = PipelineOptions()
+    );
+    
+    // Run the chain over a stream of inputs with the steps pipelined; on_result receives each
+    // input's index and result, in input order unless options.ordered is false
+    Task<void> runStream(
+        AsyncGenerator<String> inputs,
+        std::function<void(size_t, const JsonObject&)> on_result,
+        const PipelineOptions& options = PipelineOptions()
+    );
 
 private:
     std::vector<Step> steps_;
-    JsonObject step_outputs_;
+    
+    // Run one step on a context of its own; returns the step's prompt, response and tool calls
+    Task<JsonObject> runStep(const Step& step, const String& prompt);
+    
+    // Apply one step to the state of one run or pipelined input; a step skipped by its gate
+    // records no output
+    Task<void> runPipelineStep(size_t index, JsonObject& state);
+    
+    // Stages running the steps, one per step
+    std::vector<Pipeline::Stage> pipelineStages();
 };
 
 } // namespace workflows
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <agents-cpp/workflows/actor_workflow.h>
+#include <agents-cpp/workflows/pipeline.h>
 #include <vector>
 #include <functional>
 
@@ -59,6 +60,14 @@ public:
     // Execute the workflow with input (renamed to match base class)
     JsonObject run(const String& input) override;
     
+    // Run the steps over many inputs, pipelined so consecutive inputs occupy different steps at
+    // once; {{key}} in a prompt template is replaced by that field of the input's current context.
+    // Results are in input order; an input whose step failed has "error" and "failed_step" fields.
+    std::vector<JsonObject> runBatch(
+        const std::vector<String>& inputs,
+        const PipelineOptions& options = PipelineOptions()
+    );
+    
 private:
     // List of steps in the workflow
     std::vector<Step> steps_;
@@ -69,6 +78,9 @@ private:
     
     // Setup actor roles for this workflow
     void setupActorSystem() override;
+    
+    // Apply one step to the context of one pipelined input
+    Task<void> runPipelineStep(size_t index, JsonObject& context);
 };
 
 } // namespace workflows
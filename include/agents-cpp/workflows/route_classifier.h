@@ -0,0 +1,127 @@
+#pragma once
+
+#include <agents-cpp/types.h>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace agents {
+namespace workflows {
+
+/**
+ * @brief Options for a local route classifier
+ */
+struct RouteClassifierOptions {
+    // Size of the hashed feature embedding; ignored when a custom embedder is supplied
+    size_t dimensions = 1024;
+
+    // Softmax temperature over centroid similarities; lower is sharper
+    double temperature = 0.05;
+
+    // A prediction is trusted only if its share of the softmax and its cosine
+    // similarity to the route centroid both reach these values
+    double min_confidence = 0.75;
+    double min_similarity = 0.2;
+
+    // Add inputs classified by the router LLM as exemplars of the chosen route
+    bool learn = true;
+};
+
+/**
+ * @brief Classifies inputs into routes by nearest centroid, without an LLM call
+ *
+ * Exemplars of each route are embedded and summed into a per-route centroid;
+ * an input is embedded the same way and scored against every centroid by
+ * cosine similarity. The default embedding hashes lowercased words, word
+ * bigrams and character trigrams into a fixed number of signed dimensions,
+ * which needs no model and takes microseconds for a typical request. A model
+ * backed embedder can be supplied instead.
+ *
+ * Predictions and learning may run concurrently.
+ */
+class RouteClassifier {
+public:
+    // Maps a text to a vector; all vectors must have the same size
+    using Embedder = std::function<std::vector<float>(const String&)>;
+
+    /**
+     * @brief A route and how well an input matches it
+     */
+    struct Prediction {
+        String route;
+        double similarity = 0.0;    // Cosine similarity to the route centroid
+        double confidence = 0.0;    // Share of the softmax over all routes
+    };
+
+    /**
+     * @brief Counters describing the classifier's use
+     */
+    struct Stats {
+        size_t queries = 0;
+        size_t confident = 0;       // Queries answered locally
+        size_t learned = 0;         // Exemplars added from router decisions
+    };
+
+    // Throws std::invalid_argument if an option is out of range
+    explicit RouteClassifier(
+        const RouteClassifierOptions& options = RouteClassifierOptions(),
+        Embedder embedder = nullptr
+    );
+
+    // Add an example input of a route
+    void addExemplar(const String& route, const String& text);
+
+    // Add several example inputs of a route
+    void addExemplars(const String& route, const std::vector<String>& texts);
+
+    // Record a router decision; adds the input as an exemplar when learning is enabled
+    void learn(const String& route, const String& text);
+
+    // Score every route for an input, best first
+    std::vector<Prediction> predict(const String& text) const;
+
+    // Best route for an input if the prediction meets the thresholds
+    std::optional<Prediction> classify(const String& text) const;
+
+    // Embed a text as the classifier does
+    std::vector<float> embed(const String& text) const;
+
+    // Routes with at least one exemplar
+    std::vector<String> routes() const;
+
+    // Exemplars of a route, including learned ones
+    size_t exemplarCount(const String& route) const;
+
+    // Get usage counters
+    Stats getStats() const;
+
+private:
+    struct Centroid {
+        std::vector<float> sum;         // Sum of normalized exemplar embeddings
+        std::vector<float> normalized;  // sum scaled to unit length
+        size_t count = 0;
+    };
+
+    RouteClassifierOptions options_;
+    Embedder embedder_;
+
+    mutable std::shared_mutex mutex_;
+    std::map<String, Centroid> centroids_;
+    size_t dimensions_ = 0;
+
+    mutable std::atomic<size_t> queries_{0};
+    mutable std::atomic<size_t> confident_{0};
+    std::atomic<size_t> learned_{0};
+
+    // Embedding by feature hashing
+    std::vector<float> hashEmbed(const String& text) const;
+
+    // Embed and scale to unit length
+    std::vector<float> normalizedEmbedding(const String& text) const;
+};
+
+} // namespace workflows
+} // namespace agents
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <agents-cpp/workflow.h>
+#include <agents-cpp/coroutine_utils.h>
+#include <agents-cpp/workflows/route_classifier.h>
 #include <map>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <functional>
 
 namespace agents {
@@ -11,6 +16,18 @@ namespace workflows {
  * @brief A workflow that routes requests to different handlers
  * 
  * Routing classifies an input and directs it to a specialized followup task.
+ * 
+ * With a local classifier, inputs that clearly match a route's exemplars
+ * are routed without calling the router LLM; the rest fall back to the
+ * LLM, whose decisions the classifier learns from.
+ * 
+ * In speculative mode a cheap local predictor guesses the likely routes
+ * and their handlers start while the router LLM is still classifying.
+ * When the router answers, the handler of the chosen route keeps running
+ * and the mispredicted ones are cancelled, so a correct guess hides the
+ * classification latency. Speculative handlers receive routing info with
+ * "speculative": true and the predicted confidence instead of the
+ * router's reasoning.
  */
 class Routing : public Workflow {
 public:
@@ -19,6 +36,27 @@ public:
      */
     using RouteHandler = std::function<JsonObject(const String&, const JsonObject&)>;
     
+    /**
+     * @brief Predicts routes locally, best first, with a confidence in [0, 1]
+     */
+    using RoutePredictor = std::function<std::vector<std::pair<String, double>>(const String&)>;
+    
+    /**
+     * @brief Counters describing speculative routing
+     */
+    struct SpeculationStats {
+        size_t requests = 0;            // Requests classified by the router LLM
+        size_t speculated = 0;          // Requests that started at least one handler early
+        size_t hits = 0;                // The router chose a route already running
+        size_t misses = 0;              // The router chose a route that was not started
+        size_t handlers_started = 0;
+        size_t handlers_wasted = 0;     // Started early, then cancelled or discarded
+        size_t wasted_tokens = 0;       // Estimated tokens spent by wasted handlers
+        
+        // Share of speculated requests whose route was already running
+        double hitRate() const;
+    };
+    
     Routing(std::shared_ptr<AgentContext> context);
     ~Routing() override = default;
     
@@ -31,9 +69,39 @@ public:
     // Set a default route for unknown categories
     void setDefaultRoute(RouteHandler handler);
     
+    // Add words that indicate a route to the default keyword predictor
+    void addRouteKeywords(const String& route_name, const std::vector<String>& keywords);
+    
+    /**
+     * @brief Enable speculative execution of route handlers
+     * 
+     * @param max_routes Handlers started before the router answers (1 or 2 is typical; 0 disables)
+     * @param min_confidence Predictions below this confidence are not started
+     */
+    void setSpeculation(size_t max_routes, double min_confidence = 0.3);
+    
+    // Replace the default keyword predictor used for speculation
+    void setRoutePredictor(RoutePredictor predictor);
+    
+    // Route confidently classified inputs locally and learn from the router LLM's decisions;
+    // without a route predictor, the classifier's predictions also drive speculation
+    void setLocalClassifier(std::shared_ptr<RouteClassifier> classifier);
+    
+    // Predict routes for an input, best first
+    std::vector<std::pair<String, double>> predictRoutes(const String& input) const;
+    
+    // Get speculation counters
+    SpeculationStats getSpeculationStats() const;
+    
     // Run the routing workflow
     JsonObject run(const String& input) override;
     
+    // Run the routing workflow using coroutines
+    Task<JsonObject> execute(const String& input);
+    
+    // Await execute() on behalf of another coroutine
+    Task<JsonObject> runTask(const String& input) override;
+    
     // Define available routes as a JSON schema
     JsonObject getRoutesSchema() const;
 
@@ -41,6 +109,31 @@ private:
     String router_prompt_;
     std::map<String, std::pair<String, RouteHandler>> routes_;
     std::optional<RouteHandler> default_route_;
+    
+    // Words describing each route, for the keyword predictor
+    std::map<String, std::set<String>> route_words_;
+    RoutePredictor predictor_;
+    std::shared_ptr<RouteClassifier> classifier_;
+    size_t speculation_routes_ = 0;
+    double speculation_min_confidence_ = 0.3;
+    
+    mutable std::mutex stats_mutex_;
+    SpeculationStats stats_;
+    
+    // Ask the router LLM for a route; returns {"route", "reasoning"}
+    Task<JsonObject> classify(const String& input);
+    
+    // System prompt listing the routes for the router LLM
+    String routerSystemPrompt() const;
+    
+    // Handler for a route name, falling back to the default route; throws if there is none
+    RouteHandler handlerFor(const String& route_name) const;
+    
+    // Score routes by the input words they share with their names, descriptions and keywords
+    std::vector<std::pair<String, double>> predictByKeywords(const String& input) const;
+    
+    // Estimated tokens of a text, using the context manager's counter when available
+    size_t estimateTokens(const String& text) const;
 };
 
 } // namespace workflows
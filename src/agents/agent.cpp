@@ -33,7 +33,7 @@ void Agent::runAsync(
 }
 
 void Agent::stop() {
-    // Base implementation does nothing, derived classes should override
+    cancelRun();
     setState(State::STOPPED);
 }
 
@@ -65,6 +65,51 @@ void Agent::setState(State state) {
     state_ = state;
 }
 
+Task<JsonObject> Agent::runCancellable(Task<JsonObject> task) {
+    // Each run gets its own source, so overlapping runs are all reached by stop()
+    // and a stop() of an earlier run does not cancel this one
+    auto source = std::make_shared<folly::CancellationSource>();
+    {
+        std::lock_guard<std::mutex> lock(cancellation_mutex_);
+        if (stop_pending_) {
+            stop_pending_ = false;
+            source->requestCancellation();
+        }
+        run_sources_.insert(source);
+    }
+
+    folly::CancellationToken token = folly::CancellationToken::merge(
+        co_await folly::coro::co_current_cancellation_token, source->getToken());
+
+    folly::Try<JsonObject> result;
+    if (options_.deadline_ms > 0) {
+        result = co_await folly::coro::co_awaitTry(folly::coro::co_withCancellation(
+            token,
+            folly::coro::timeout(std::move(task), std::chrono::milliseconds(options_.deadline_ms))));
+    } else {
+        result = co_await folly::coro::co_awaitTry(
+            folly::coro::co_withCancellation(token, std::move(task)));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(cancellation_mutex_);
+        run_sources_.erase(source);
+    }
+    co_return std::move(result).value();
+}
+
+void Agent::cancelRun() {
+    std::lock_guard<std::mutex> lock(cancellation_mutex_);
+    if (run_sources_.empty()) {
+        // Nothing in flight yet: the stop applies to the next run
+        stop_pending_ = true;
+        return;
+    }
+    for (const auto& source : run_sources_) {
+        source->requestCancellation();
+    }
+}
+
 void Agent::logStatus(const String& status) {
     if (status_callback_) {
         status_callback_(status);
@@ -1,5 +1,6 @@
 #include <agents-cpp/agents/autonomous_agent.h>
 #include <agents-cpp/logger.h>
+#include <folly/futures/Future.h>
 #include <stdexcept>
 
 namespace agents {
@@ -25,13 +26,27 @@ Task<JsonObject> AutonomousAgent::run(const String& task) {
         // Clear previous steps
         steps_.clear();
     
-        auto result = co_await executeTask(task);
+        auto result = co_await runCancellable(executeTask(task));
         
         // Mark as completed
         setState(State::COMPLETED);
         logStatus("Task completed successfully");
         
         co_return result;
+    } catch (const folly::OperationCancelled&) {
+        setState(State::STOPPED);
+        logStatus("Task stopped by user");
+        
+        JsonObject error;
+        error["error"] = "cancelled";
+        co_return error;
+    } catch (const folly::FutureTimeout&) {
+        setState(State::FAILED);
+        logStatus("Task exceeded its deadline");
+        
+        JsonObject error;
+        error["error"] = "deadline exceeded";
+        co_return error;
     } catch (const std::exception& e) {
         setState(State::FAILED);
         logStatus("Task failed: " + String(e.what()));
@@ -45,6 +60,7 @@ Task<JsonObject> AutonomousAgent::run(const String& task) {
 
 void AutonomousAgent::stop() {
     should_stop_ = true;
+    cancelRun();
     
     if (getState() == State::RUNNING) {
         setState(State::STOPPED);
@@ -193,18 +209,18 @@ Task<AutonomousAgent::Step> AutonomousAgent::executeStep(const String& step_desc
         
         // Check for tool calls
         if (!response.tool_calls.empty()) {
-            JsonObject tool_results;
+            // Independent calls run concurrently; results come back in call order
+            size_t max_concurrency = options_.parallel_tool_calls ? options_.max_parallel_tool_calls : 1;
+            auto results = co_await context_->executeTools(response.tool_calls, max_concurrency);
             
-            for (const auto& tool_call : response.tool_calls) {
-                // Execute the tool
-                auto tool_result = co_await context_->executeTool(tool_call.name, tool_call.parameters);
-                
-                // Add to results
-                tool_results[tool_call.name] = {
-                    {"success", tool_result.success},
-                    {"result", tool_result.content},
-                    {"data", tool_result.data}
-                };
+            JsonObject tool_results = JsonObject::array();
+            for (size_t i = 0; i < results.size(); ++i) {
+                tool_results.push_back({
+                    {"name", response.tool_calls[i].first},
+                    {"success", results[i].success},
+                    {"result", results[i].content},
+                    {"data", results[i].data}
+                });
             }
             
             step.result["tool_results"] = tool_results;
@@ -213,6 +229,9 @@ Task<AutonomousAgent::Step> AutonomousAgent::executeStep(const String& step_desc
         // Mark as success
         step.success = true;
         step.status = "Completed";
+    } catch (const folly::OperationCancelled&) {
+        // Let cancellation unwind the whole run
+        throw;
     } catch (const std::exception& e) {
         // Mark as failure
         step.success = false;
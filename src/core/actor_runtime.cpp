@@ -0,0 +1,82 @@
+#include <agents-cpp/actor_runtime.h>
+#include <agents-cpp/logger.h>
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace agents {
+
+namespace {
+
+// Options for the runtime, fixed once global() has started it
+std::mutex options_mutex;
+ActorRuntimeOptions pending_options;
+bool started = false;
+
+ActorRuntimeOptions startOptions() {
+    std::lock_guard<std::mutex> lock(options_mutex);
+    started = true;
+    return pending_options;
+}
+
+} // namespace
+
+void ActorRuntime::configure(const ActorRuntimeOptions& options) {
+    std::lock_guard<std::mutex> lock(options_mutex);
+    if (started) {
+        throw std::logic_error("Actor runtime is already running and cannot be reconfigured");
+    }
+    pending_options = options;
+}
+
+ActorRuntime& ActorRuntime::global() {
+    static ActorRuntime runtime(startOptions());
+    return runtime;
+}
+
+ActorRuntime::ActorRuntime(const ActorRuntimeOptions& options)
+    : options_(options) {
+    num_threads_ = options_.num_threads > 0
+        ? options_.num_threads
+        : std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+    config_.set("caf.scheduler.max-threads", num_threads_);
+    if (options_.max_throughput > 0) {
+        config_.set("caf.scheduler.max-throughput", options_.max_throughput);
+    }
+
+    if (options_.policy == ActorRuntimeOptions::Policy::STEALING) {
+        config_.set("caf.scheduler.policy", "stealing");
+        config_.set("caf.work-stealing.aggressive-poll-attempts", options_.aggressive_poll_attempts);
+        config_.set("caf.work-stealing.moderate-poll-attempts", options_.moderate_poll_attempts);
+        config_.set("caf.work-stealing.moderate-sleep-duration",
+                    std::chrono::duration_cast<caf::timespan>(options_.moderate_sleep));
+        config_.set("caf.work-stealing.relaxed-sleep-duration",
+                    std::chrono::duration_cast<caf::timespan>(options_.relaxed_sleep));
+    } else {
+        config_.set("caf.scheduler.policy", "sharing");
+    }
+
+    caf::core::init_global_meta_objects();
+    system_ = std::make_unique<caf::actor_system>(config_);
+
+    Logger::info("Actor runtime started with {} scheduler threads ({})", num_threads_,
+                 options_.policy == ActorRuntimeOptions::Policy::STEALING ? "work stealing" : "work sharing");
+}
+
+ActorRuntime::~ActorRuntime() = default;
+
+caf::actor_system& ActorRuntime::system() {
+    return *system_;
+}
+
+const ActorRuntimeOptions& ActorRuntime::getOptions() const {
+    return options_;
+}
+
+size_t ActorRuntime::numThreads() const {
+    return num_threads_;
+}
+
+} // namespace agents
@@ -1,13 +1,28 @@
 #include <agents-cpp/agent_context.h>
 #include <agents-cpp/logger.h>
+#include <algorithm>
 #include <stdexcept>
 
 namespace agents {
 
-AgentContext::AgentContext() : memory_(createMemory()) {
+AgentContext::AgentContext()
+    : memory_(createMemory()),
+      context_manager_(std::make_shared<ContextManager>()),
+      tool_cache_(std::make_shared<ToolResultCache>()) {
     // Initialize with empty values
 }
 
+std::shared_ptr<AgentContext> AgentContext::fork() const {
+    auto context = std::make_shared<AgentContext>();
+    context->llm_ = llm_;
+    context->context_manager_ = context_manager_;
+    context->tool_cache_ = tool_cache_;
+    context->tools_ = tools_;
+    context->system_prompt_ = system_prompt_;
+    context->tool_timeout_ = tool_timeout_;
+    return context;
+}
+
 void AgentContext::setLLM(std::shared_ptr<LLMInterface> llm) {
     llm_ = llm;
 }
@@ -25,29 +40,37 @@ const String& AgentContext::getSystemPrompt() const {
 }
 
 void AgentContext::registerTool(std::shared_ptr<Tool> tool) {
-    tools_[tool->getName()] = tool;
+    tools_.registerTool(std::move(tool));
 }
 
 std::shared_ptr<Tool> AgentContext::getTool(const String& name) const {
-    auto it = tools_.find(name);
-    if (it != tools_.end()) {
-        return it->second;
-    }
-    return nullptr;
+    return tools_.getTool(name);
 }
 
 std::vector<std::shared_ptr<Tool>> AgentContext::getTools() const {
-    std::vector<std::shared_ptr<Tool>> result;
-    for (const auto& pair : tools_) {
-        result.push_back(pair.second);
-    }
-    return result;
+    return tools_.getAllTools();
+}
+
+tools::ToolRegistry::SnapshotPtr AgentContext::getToolSnapshot() const {
+    return tools_.snapshot();
+}
+
+void AgentContext::setMemory(std::shared_ptr<Memory> memory) {
+    memory_ = memory;
 }
 
 std::shared_ptr<Memory> AgentContext::getMemory() const {
     return memory_;
 }
 
+void AgentContext::setContextManager(std::shared_ptr<ContextManager> context_manager) {
+    context_manager_ = context_manager;
+}
+
+std::shared_ptr<ContextManager> AgentContext::getContextManager() const {
+    return context_manager_;
+}
+
 void AgentContext::addMessage(const Message& message) {
     memory_->addMessage(message);
 }
@@ -56,8 +79,54 @@ std::vector<Message> AgentContext::getMessages() const {
     return memory_->getMessages();
 }
 
+std::vector<Message> AgentContext::prepareMessages(const Message& user_message) {
+    // Add the message to history
+    if (memory_) {
+        memory_->addMessage(user_message);
+    }
+    
+    // Conversation history from memory if available, otherwise just the current message
+    std::vector<Message> history;
+    if (memory_) {
+        history = memory_->getMessages();
+    } else {
+        history.push_back(user_message);
+    }
+    
+    // Fit the prompt into the model's context window
+    if (context_manager_) {
+        auto options = llm_->getOptions();
+        return context_manager_->buildPrompt(system_prompt_, history, llm_->getModel(), options.max_tokens);
+    }
+    
+    std::vector<Message> messages;
+    
+    // Add system message if set
+    if (!system_prompt_.empty()) {
+        Message system_msg;
+        system_msg.role = Message::Role::SYSTEM;
+        system_msg.content = system_prompt_;
+        messages.push_back(system_msg);
+    }
+    
+    messages.insert(messages.end(), history.begin(), history.end());
+    return messages;
+}
+
 // Coroutine-based implementations
 
+void AgentContext::setToolResultCache(std::shared_ptr<ToolResultCache> cache) {
+    tool_cache_ = cache;
+}
+
+std::shared_ptr<ToolResultCache> AgentContext::getToolResultCache() const {
+    return tool_cache_;
+}
+
+void AgentContext::setToolTimeout(std::chrono::milliseconds timeout) {
+    tool_timeout_ = timeout;
+}
+
 Task<ToolResult> AgentContext::executeTool(const String& name, const JsonObject& params) {
     Logger::debug("Executing tool: {}", name);
     if (!llm_) {
@@ -69,13 +138,117 @@ Task<ToolResult> AgentContext::executeTool(const String& name, const JsonObject&
         throw std::runtime_error("Tool not found: " + name);
     }
     
-    // In a real implementation, we would add asynchronous execution of tools
-    // For now, just run the tool synchronously
-    ToolResult result = tool->execute(params);
+    co_return co_await executeResolvedTool(std::move(tool), params);
+}
+
+Task<ToolResult> AgentContext::executeResolvedTool(std::shared_ptr<Tool> tool, const JsonObject& params) {
+    const String& name = tool->getName();
+    auto cache = tool_cache_;
+    if (cache && tool->isCacheable()) {
+        if (auto cached = cache->get(name, params)) {
+            Logger::debug("Tool result served from cache: {}", name);
+            co_return *cached;
+        }
+    }
+    
+    // Blocking tools run on the tool pool, so this executor stays free for LLM I/O
+    ToolResult result = co_await tool->executeAsync(params, tool_timeout_);
+    
+    if (cache) {
+        if (result.success && tool->isCacheable()) {
+            cache->put(name, params, result, tool->getCacheTtl());
+        }
+        // A failed call may still have changed what other tools would return
+        for (const auto& stale : tool->getInvalidates()) {
+            cache->invalidate(stale);
+        }
+    }
     
     co_return result;
 }
 
+Task<std::vector<ToolResult>> AgentContext::executeTools(
+    const std::vector<std::pair<String, JsonObject>>& calls,
+    size_t max_concurrency
+) {
+    std::vector<ToolResult> results(calls.size());
+    if (calls.empty()) {
+        co_return results;
+    }
+
+    // Resolve every call against the same snapshot, even if tools change meanwhile
+    auto snapshot = tools_.snapshot();
+    
+    // Calls of a serial-only tool share one group; every other call is a group of its own
+    std::vector<std::vector<size_t>> groups;
+    std::map<String, size_t> serial_groups;
+    for (size_t i = 0; i < calls.size(); ++i) {
+        auto tool = snapshot->getTool(calls[i].first);
+        if (tool && tool->isSerialOnly()) {
+            auto [group, inserted] = serial_groups.emplace(calls[i].first, groups.size());
+            if (inserted) {
+                groups.emplace_back();
+            }
+            groups[group->second].push_back(i);
+        } else {
+            groups.push_back({i});
+        }
+    }
+
+    std::vector<Task<void>> tasks;
+    tasks.reserve(groups.size());
+    for (auto& group : groups) {
+        tasks.push_back(executeToolGroup(calls, snapshot, std::move(group), results));
+    }
+
+    size_t window = max_concurrency > 0 ? max_concurrency : tasks.size();
+    co_await folly::coro::collectAllWindowed(std::move(tasks), window);
+
+    // The turn is over, so tools that deferred work (e.g. fsyncs) complete it now, once each
+    std::vector<std::shared_ptr<Tool>> flushed;
+    for (const auto& call : calls) {
+        auto tool = snapshot->getTool(call.first);
+        if (tool && tool->hasFlushCallback() &&
+            std::find(flushed.begin(), flushed.end(), tool) == flushed.end()) {
+            flushed.push_back(tool);
+        }
+    }
+    for (const auto& tool : flushed) {
+        try {
+            co_await tool->flushAsync();
+        } catch (const folly::OperationCancelled&) {
+            throw;
+        } catch (const std::exception& e) {
+            Logger::error("Failed to flush tool {}: {}", tool->getName(), e.what());
+        }
+    }
+
+    co_return results;
+}
+
+Task<void> AgentContext::executeToolGroup(
+    const std::vector<std::pair<String, JsonObject>>& calls,
+    const tools::ToolRegistry::SnapshotPtr& snapshot,
+    std::vector<size_t> indices,
+    std::vector<ToolResult>& results
+) {
+    for (size_t index : indices) {
+        const auto& [name, params] = calls[index];
+        try {
+            auto tool = snapshot->getTool(name);
+            if (!tool) {
+                throw std::runtime_error("Tool not found: " + name);
+            }
+            results[index] = co_await executeResolvedTool(std::move(tool), params);
+        } catch (const folly::OperationCancelled&) {
+            throw;
+        } catch (const std::exception& e) {
+            results[index].success = false;
+            results[index].content = "Error executing tool " + name + ": " + e.what();
+        }
+    }
+}
+
 Task<LLMResponse> AgentContext::chat(const String& user_message) {
     Logger::debug("Chat: {}", user_message);
     if (!llm_) {
@@ -87,30 +260,8 @@ Task<LLMResponse> AgentContext::chat(const String& user_message) {
     msg.role = Message::Role::USER;
     msg.content = user_message;
     
-    // Add the message to history
-    if (memory_) {
-        memory_->addMessage(msg);
-    }
-    
-    // Prepare messages for the LLM
-    std::vector<Message> messages;
-    
-    // Add system message if set
-    if (!system_prompt_.empty()) {
-        Message system_msg;
-        system_msg.role = Message::Role::SYSTEM;
-        system_msg.content = system_prompt_;
-        messages.push_back(system_msg);
-    }
-    
-    // Add conversation history from memory if available
-    if (memory_) {
-        auto history = memory_->getMessages();
-        messages.insert(messages.end(), history.begin(), history.end());
-    } else {
-        // Otherwise just add the current message
-        messages.push_back(msg);
-    }
+    // Record it and prepare messages for the LLM
+    auto messages = prepareMessages(msg);
     
     // Use the LLM's async method
     auto response = co_await llm_->chatAsync(messages);
@@ -137,36 +288,14 @@ Task<LLMResponse> AgentContext::chatWithTools(const String& user_message) {
     msg.role = Message::Role::USER;
     msg.content = user_message;
     
-    // Add the message to history
-    if (memory_) {
-        memory_->addMessage(msg);
-    }
-    
-    // Prepare messages for the LLM
-    std::vector<Message> messages;
-    
-    // Add system message if set
-    if (!system_prompt_.empty()) {
-        Message system_msg;
-        system_msg.role = Message::Role::SYSTEM;
-        system_msg.content = system_prompt_;
-        messages.push_back(system_msg);
-    }
+    // Record it and prepare messages for the LLM
+    auto messages = prepareMessages(msg);
     
-    // Add conversation history from memory if available
-    if (memory_) {
-        auto history = memory_->getMessages();
-        messages.insert(messages.end(), history.begin(), history.end());
-    } else {
-        // Otherwise just add the current message
-        messages.push_back(msg);
-    }
-    
-    // Get all tools
-    auto tools = getTools();
+    // Offer the tools of a single snapshot for the whole request
+    auto snapshot = tools_.snapshot();
     
     // Use the LLM's async method
-    auto response = co_await llm_->chatWithToolsAsync(messages, tools);
+    auto response = co_await llm_->chatWithToolsAsync(messages, snapshot->getAllTools());
     
     // Add the response to memory
     if (memory_) {
@@ -190,30 +319,8 @@ AsyncGenerator<String> AgentContext::streamChat(const String& user_message) {
     msg.role = Message::Role::USER;
     msg.content = user_message;
     
-    // Add the message to history
-    if (memory_) {
-        memory_->addMessage(msg);
-    }
-    
-    // Prepare messages for the LLM
-    std::vector<Message> messages;
-    
-    // Add system message if set
-    if (!system_prompt_.empty()) {
-        Message system_msg;
-        system_msg.role = Message::Role::SYSTEM;
-        system_msg.content = system_prompt_;
-        messages.push_back(system_msg);
-    }
-    
-    // Add conversation history from memory if available
-    if (memory_) {
-        auto history = memory_->getMessages();
-        messages.insert(messages.end(), history.begin(), history.end());
-    } else {
-        // Otherwise just add the current message
-        messages.push_back(msg);
-    }
+    // Record it and prepare messages for the LLM
+    auto messages = prepareMessages(msg);
     
     // Use the LLM's stream method and forward chunks
     auto generator = llm_->streamChatAsync(messages);
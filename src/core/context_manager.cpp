@@ -0,0 +1,309 @@
+#include <agents-cpp/context_manager.h>
+#include <algorithm>
+
+namespace agents {
+
+namespace {
+
+bool isNameSeparator(char c) {
+    return c == '-' || c == ':' || c == '@' || c == '/' || c == '_';
+}
+
+// Cut text to at most size bytes without splitting a UTF-8 code point
+void truncateUtf8(String& text, size_t size) {
+    if (size >= text.size()) {
+        return;
+    }
+    while (size > 0 && (static_cast<unsigned char>(text[size]) & 0xC0) == 0x80) {
+        --size;
+    }
+    text.resize(size);
+}
+
+} // namespace
+
+ContextManager::ContextManager(const ContextPolicy& policy)
+    : policy_(policy),
+      token_counter_([](const String& text) {
+          // Roughly 4 bytes per token for English text with BPE vocabularies
+          return (text.size() + 3) / 4;
+      }),
+      context_windows_({
+          {"gpt-4.1", 1047576},
+          {"gpt-4o", 128000},
+          {"gpt-4-turbo", 128000},
+          {"gpt-4", 8192},
+          {"gpt-3.5-turbo", 16385},
+          {"o1", 200000},
+          {"o3", 200000},
+          {"o4-mini", 200000},
+          {"claude-3", 200000},
+          {"claude-sonnet-4", 200000},
+          {"claude-opus-4", 200000},
+          {"gemini-1.5-pro", 2000000},
+          {"gemini-1.5-flash", 1000000},
+          {"gemini-2.0-flash", 1048576},
+          {"gemini-2.5", 1048576},
+          {"llama3", 8192}
+      }) {
+}
+
+void ContextManager::setPolicy(const ContextPolicy& policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+}
+
+ContextPolicy ContextManager::getPolicy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+void ContextManager::setTokenCounter(TokenCounter counter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    token_counter_ = counter;
+
+    // Counts from the previous counter are no longer valid
+    token_cache_.clear();
+}
+
+void ContextManager::setSummarizer(Summarizer summarizer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    summarizer_ = summarizer;
+}
+
+void ContextManager::setModelContextWindow(const String& model_prefix, int tokens) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    context_windows_[model_prefix] = tokens;
+}
+
+int ContextManager::getContextWindow(const String& model) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (policy_.max_context_tokens > 0) {
+        return policy_.max_context_tokens;
+    }
+
+    // Longest registered prefix wins, so "gpt-4o-mini" maps to "gpt-4o" rather than "gpt-4".
+    // A prefix only matches whole name components, so "gpt-4.1" or "llama3.1" never
+    // fall back to the smaller window of "gpt-4" or "llama3".
+    int window = 0;
+    size_t best_length = 0;
+    for (const auto& [prefix, tokens] : context_windows_) {
+        if (prefix.size() <= best_length || model.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        if (model.size() > prefix.size() && !isNameSeparator(model[prefix.size()])) {
+            continue;
+        }
+        window = tokens;
+        best_length = prefix.size();
+    }
+
+    // 0 means the model is unknown
+    return window;
+}
+
+size_t ContextManager::hashMessage(const Message& message) {
+    size_t hash = std::hash<String>{}(message.content);
+    hash ^= static_cast<size_t>(message.role) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    if (message.name) {
+        hash ^= std::hash<String>{}(*message.name) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    for (const auto& tool_call : message.tool_calls) {
+        hash ^= std::hash<String>{}(tool_call.first + tool_call.second.dump()) +
+            0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+}
+
+bool ContextManager::sameMessage(const Message& a, const Message& b) {
+    return a.role == b.role && a.content == b.content && a.name == b.name &&
+        a.tool_calls == b.tool_calls;
+}
+
+size_t ContextManager::countTokens(const Message& message) {
+    size_t hash = hashMessage(message);
+
+    TokenCounter counter;
+    size_t overhead;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto cached = token_cache_.find(hash);
+        if (cached != token_cache_.end() && sameMessage(cached->second.message, message)) {
+            ++stats_.cache_hits;
+            return cached->second.tokens;
+        }
+        ++stats_.cache_misses;
+        counter = token_counter_;
+        overhead = static_cast<size_t>(std::max(policy_.tokens_per_message, 0));
+    }
+
+    // Count outside the lock; concurrent misses on the same message are harmless
+    size_t tokens = overhead + counter(message.content);
+    if (message.name) {
+        tokens += counter(*message.name);
+    }
+    for (const auto& tool_call : message.tool_calls) {
+        tokens += counter(tool_call.first) + counter(tool_call.second.dump());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (token_cache_.size() >= kMaxCachedMessages) {
+        token_cache_.clear();
+    }
+    token_cache_[hash] = CachedCount{message, tokens};
+
+    return tokens;
+}
+
+String ContextManager::defaultSummary(const std::vector<Message>& messages) {
+    String summary;
+    for (const auto& message : messages) {
+        summary += renderMessage(message);
+    }
+    return summary;
+}
+
+std::vector<Message> ContextManager::buildPrompt(
+    const String& system_prompt,
+    const std::vector<Message>& history,
+    const String& model,
+    int max_output_tokens
+) {
+    ContextPolicy policy = getPolicy();
+
+    int window = getContextWindow(model);
+    int reserved = policy.reserved_output_tokens >= 0 ? policy.reserved_output_tokens : max_output_tokens;
+    long budget = static_cast<long>(window) - std::max(reserved, 0);
+
+    std::vector<Message> prompt;
+    long system_tokens = 0;
+
+    // Pinned system prompt
+    if (!system_prompt.empty()) {
+        Message system_msg;
+        system_msg.role = Message::Role::SYSTEM;
+        system_msg.content = system_prompt;
+
+        if (policy.pin_system_prompt) {
+            system_tokens = static_cast<long>(countTokens(system_msg));
+            budget -= system_tokens;
+        }
+        prompt.push_back(system_msg);
+    }
+
+    if (history.empty()) {
+        return prompt;
+    }
+
+    // Without a known window there is nothing to fit, so send the whole history
+    if (window <= 0) {
+        prompt.insert(prompt.end(), history.begin(), history.end());
+        return prompt;
+    }
+
+    // Find where the last K turns start
+    size_t tail_start = history.size() - 1;
+    size_t turns = 0;
+    for (size_t i = history.size(); i-- > 0;) {
+        if (history[i].role == Message::Role::USER) {
+            ++turns;
+            tail_start = i;
+            if (turns >= std::max<size_t>(policy.keep_last_turns, 1)) {
+                break;
+            }
+        }
+    }
+
+    // Walk backwards from the newest message, keeping as much as fits.
+    // A message and the tool results that follow it are kept or dropped together, so the
+    // prompt never opens on a tool result whose call was cut.
+    // The last K turns are always kept, even if they alone exceed the budget.
+    std::vector<size_t> message_tokens(history.size());
+    size_t first_kept = history.size();
+    long used = 0;
+    while (first_kept > 0) {
+        size_t start = first_kept - 1;
+        while (start > 0 && history[start].role == Message::Role::TOOL) {
+            --start;
+        }
+
+        long group_tokens = 0;
+        for (size_t i = start; i < first_kept; ++i) {
+            message_tokens[i] = countTokens(history[i]);
+            group_tokens += static_cast<long>(message_tokens[i]);
+        }
+        if (start < tail_start && used + group_tokens > budget) {
+            break;
+        }
+        used += group_tokens;
+        first_kept = start;
+    }
+
+    size_t dropped = first_kept;
+    size_t summarized = 0;
+
+    // Summarize whatever did not fit, when the tail leaves room for it
+    if (dropped > 0 && policy.middle_strategy == ContextPolicy::MiddleStrategy::SUMMARIZE) {
+        Summarizer summarizer;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            summarizer = summarizer_;
+        }
+
+        auto summarize = [&](size_t count) {
+            std::vector<Message> middle(history.begin(), history.begin() + count);
+            Message summary_msg;
+            summary_msg.role = Message::Role::SYSTEM;
+            summary_msg.content = "Summary of the earlier conversation:\n" +
+                (summarizer ? summarizer(middle) : defaultSummary(middle));
+            return summary_msg;
+        };
+
+        Message summary_msg = summarize(dropped);
+
+        // Make room for the summary by giving up older tail messages, but never the recent turns
+        long summary_tokens = static_cast<long>(countTokens(summary_msg));
+        while (used + summary_tokens > budget && first_kept < tail_start) {
+            do {
+                used -= static_cast<long>(message_tokens[first_kept]);
+                ++first_kept;
+            } while (first_kept < tail_start && history[first_kept].role == Message::Role::TOOL);
+        }
+        if (first_kept != dropped) {
+            summary_msg = summarize(first_kept);
+            summary_tokens = static_cast<long>(countTokens(summary_msg));
+        }
+
+        long room = budget - used;
+        if (summary_tokens > room && room > policy.tokens_per_message) {
+            // Trim the summary proportionally to the space that is left
+            double ratio = static_cast<double>(room - policy.tokens_per_message) /
+                static_cast<double>(summary_tokens);
+            truncateUtf8(summary_msg.content, static_cast<size_t>(summary_msg.content.size() * ratio));
+            summary_tokens = room;
+        }
+
+        if (summary_tokens <= room) {
+            prompt.push_back(summary_msg);
+            used += summary_tokens;
+            summarized = first_kept;
+        }
+        dropped = first_kept;
+    }
+
+    prompt.insert(prompt.end(), history.begin() + first_kept, history.end());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.dropped_messages += dropped - summarized;
+    stats_.summarized_messages += summarized;
+    stats_.last_prompt_tokens = static_cast<size_t>(used + system_tokens);
+
+    return prompt;
+}
+
+ContextManager::Stats ContextManager::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace agents
@@ -1,9 +1,76 @@
 #include <agents-cpp/memory.h>
+#include <agents-cpp/memory/conversation_summarizer.h>
+#include <deque>
 #include <map>
+#include <list>
+#include <unordered_map>
 #include <algorithm>
 
 namespace agents {
 
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Fixed-capacity ring of messages that grows on demand when unbounded
+class MessageRing {
+public:
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    const Message& at(size_t index) const {
+        return slots_[(head_ + index) % slots_.size()];
+    }
+
+    void push_back(const Message& message) {
+        if (size_ == slots_.size()) {
+            grow();
+        }
+        slots_[(head_ + size_) % slots_.size()] = message;
+        ++size_;
+    }
+
+    Message pop_front() {
+        Message message = std::move(slots_[head_]);
+        slots_[head_] = Message{};
+        head_ = (head_ + 1) % slots_.size();
+        --size_;
+        return message;
+    }
+
+    // Preallocate for a bounded log so steady state never reallocates
+    void reserve(size_t capacity) {
+        if (capacity > slots_.size()) {
+            resize(capacity);
+        }
+    }
+
+private:
+    std::vector<Message> slots_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+
+    void grow() {
+        resize(slots_.empty() ? 16 : slots_.size() * 2);
+    }
+
+    void resize(size_t capacity) {
+        std::vector<Message> slots(capacity);
+        for (size_t i = 0; i < size_; ++i) {
+            slots[i] = std::move(slots_[(head_ + i) % slots_.size()]);
+        }
+        slots_ = std::move(slots);
+        head_ = 0;
+    }
+};
+
+} // namespace
+
 // Simple memory implementation
 class SimpleMemory : public Memory {
 public:
@@ -11,80 +78,103 @@ public:
     ~SimpleMemory() override = default;
 
     void add(const String& key, const JsonObject& value, MemoryType type = MemoryType::SHORT_TERM) override {
-        memory_[static_cast<int>(type)][key] = value;
+        Store& store = stores_[static_cast<int>(type)];
+
+        auto existing = store.index.find(key);
+        if (existing != store.index.end()) {
+            store.bytes -= existing->second->bytes;
+            store.lru.erase(existing->second);
+            store.index.erase(existing);
+        }
+
+        Entry entry;
+        entry.key = key;
+        entry.value = value;
+        entry.bytes = key.size() + estimateJsonBytes(value);
+        if (store.policy.ttl.count() > 0) {
+            entry.expires_at = Clock::now() + store.policy.ttl;
+        }
+
+        store.bytes += entry.bytes;
+        store.lru.push_front(std::move(entry));
+        store.index[key] = store.lru.begin();
+
+        enforce(store);
     }
     
     std::optional<JsonObject> get(const String& key, MemoryType type = MemoryType::SHORT_TERM) const override {
-        const auto& memory_map = memory_.find(static_cast<int>(type));
-        if (memory_map == memory_.end()) {
+        auto entry = lookup(key, type);
+        if (!entry) {
             return std::nullopt;
         }
         
-        const auto& entry = memory_map->second.find(key);
-        if (entry == memory_map->second.end()) {
-            return std::nullopt;
-        }
-        
-        return entry->second;
+        return (*entry)->value;
     }
     
     bool has(const String& key, MemoryType type = MemoryType::SHORT_TERM) const override {
-        const auto& memory_map = memory_.find(static_cast<int>(type));
-        if (memory_map == memory_.end()) {
-            return false;
-        }
-        
-        return memory_map->second.find(key) != memory_map->second.end();
+        return lookup(key, type).has_value();
     }
     
     void remove(const String& key, MemoryType type = MemoryType::SHORT_TERM) override {
-        auto memory_map = memory_.find(static_cast<int>(type));
-        if (memory_map != memory_.end()) {
-            memory_map->second.erase(key);
+        auto store = stores_.find(static_cast<int>(type));
+        if (store == stores_.end()) {
+            return;
+        }
+
+        auto entry = store->second.index.find(key);
+        if (entry != store->second.index.end()) {
+            erase(store->second, entry->second);
         }
     }
     
     void clear(MemoryType type = MemoryType::SHORT_TERM) override {
-        memory_[static_cast<int>(type)].clear();
+        Store& store = stores_[static_cast<int>(type)];
+        store.lru.clear();
+        store.index.clear();
+        store.bytes = 0;
     }
     
     void addMessage(const Message& message) override {
         messages_.push_back(message);
+        message_bytes_ += estimateMessageBytes(message);
+
+        // Render once, on arrival
+        size_t rendered_before = rendered_.size();
+        rendered_ += renderMessage(message);
+        rendered_lengths_.push_back(rendered_.size() - rendered_before);
+
+        if (summarizer_) {
+            summarizer_->observe(message);
+        }
+
+        trimMessages();
     }
     
     std::vector<Message> getMessages() const override {
-        return messages_;
+        std::vector<Message> result;
+        result.reserve(messages_.size());
+        for (size_t i = 0; i < messages_.size(); ++i) {
+            result.push_back(messages_.at(i));
+        }
+        return result;
     }
     
     String getConversationSummary(int max_length = 0) const override {
-        String summary;
-        
-        for (const auto& message : messages_) {
-            String role_str;
-            switch (message.role) {
-                case Message::Role::SYSTEM:
-                    role_str = "System: ";
-                    break;
-                case Message::Role::USER:
-                    role_str = "User: ";
-                    break;
-                case Message::Role::ASSISTANT:
-                    role_str = "Assistant: ";
-                    break;
-                case Message::Role::TOOL:
-                    role_str = "Tool (" + message.name.value_or("unknown") + "): ";
-                    break;
+        if (summarizer_) {
+            String summary = summarizer_->getSummary();
+            if (max_length > 0 && summary.length() > static_cast<size_t>(max_length)) {
+                summary = summary.substr(0, max_length) + "...";
             }
-            
-            summary += role_str + message.content + "\n\n";
+            return summary;
         }
         
-        // Truncate if needed
-        if (max_length > 0 && summary.length() > static_cast<size_t>(max_length)) {
-            summary = summary.substr(0, max_length) + "...";
+        // Copy only what is asked for out of the rolling buffer
+        size_t available = rendered_.size() - rendered_start_;
+        if (max_length > 0 && available > static_cast<size_t>(max_length)) {
+            return rendered_.substr(rendered_start_, max_length) + "...";
         }
         
-        return summary;
+        return rendered_.substr(rendered_start_);
     }
     
     std::vector<std::pair<JsonObject, float>> search(
@@ -96,14 +186,19 @@ public:
         // In a real implementation, this would use semantic search
         std::vector<std::pair<JsonObject, float>> results;
         
-        const auto& memory_map = memory_.find(static_cast<int>(type));
-        if (memory_map == memory_.end()) {
+        const auto& store = stores_.find(static_cast<int>(type));
+        if (store == stores_.end()) {
             return results;
         }
         
-        for (const auto& entry : memory_map->second) {
+        auto now = Clock::now();
+        for (const auto& entry : store->second.lru) {
+            if (isExpired(entry, now)) {
+                continue;
+            }
+
             // For now, just use a placeholder similarity score
-            results.emplace_back(entry.second, 0.5f);
+            results.emplace_back(entry.value, 0.5f);
             
             if (results.size() >= static_cast<size_t>(max_results)) {
                 break;
@@ -113,16 +208,266 @@ public:
         return results;
     }
 
+    void setCapacityPolicy(MemoryType type, const MemoryCapacityPolicy& policy) override {
+        Store& store = stores_[static_cast<int>(type)];
+        store.policy = policy;
+        enforce(store);
+    }
+
+    void setMessageLogPolicy(const MessageLogPolicy& policy) override {
+        message_policy_ = policy;
+        if (policy.max_messages > 0) {
+            messages_.reserve(policy.max_messages + 1);
+        }
+
+        // Apply the new limits to the existing log
+        trimMessages();
+    }
+
+    void setSpillHandler(std::function<void(const Message&)> handler) override {
+        spill_handler_ = handler;
+    }
+
+    void setSummarizer(std::shared_ptr<ConversationSummarizer> summarizer) override {
+        summarizer_ = summarizer;
+        if (!summarizer_) {
+            return;
+        }
+
+        // Catch the summarizer up on the history it has not seen
+        for (size_t i = 0; i < messages_.size(); ++i) {
+            summarizer_->observe(messages_.at(i));
+        }
+    }
+
+    MemoryStats getStats(MemoryType type) const override {
+        auto store = stores_.find(static_cast<int>(type));
+        if (store == stores_.end()) {
+            return {};
+        }
+
+        MemoryStats stats = store->second.stats;
+        stats.entries = store->second.lru.size();
+        stats.bytes = store->second.bytes;
+        return stats;
+    }
+
+    MemoryStats getMessageStats() const override {
+        MemoryStats stats = message_stats_;
+        stats.entries = messages_.size();
+        stats.bytes = message_bytes_;
+        return stats;
+    }
+
 private:
-    // Memory storage organized by type and key
-    std::map<int, std::map<String, JsonObject>> memory_;
+    struct Entry {
+        String key;
+        JsonObject value;
+        size_t bytes = 0;
+        std::optional<Clock::time_point> expires_at;
+    };
+
+    // Entries of one memory type, most recently used first
+    struct Store {
+        std::list<Entry> lru;
+        std::unordered_map<String, std::list<Entry>::iterator> index;
+        size_t bytes = 0;
+        MemoryCapacityPolicy policy;
+        MemoryStats stats;
+    };
+
+    // Memory storage organized by type and key; lookups refresh recency
+    mutable std::map<int, Store> stores_;
     
     // Conversation history
-    std::vector<Message> messages_;
+    MessageRing messages_;
+    size_t message_bytes_ = 0;
+    size_t spilled_messages_ = 0;
+    MessageLogPolicy message_policy_;
+    MemoryStats message_stats_;
+    std::function<void(const Message&)> spill_handler_;
+
+    // Rolling rendering of the log: messages_[i] occupies the i-th length after rendered_start_
+    String rendered_;
+    size_t rendered_start_ = 0;
+    std::deque<size_t> rendered_lengths_;
+
+    std::shared_ptr<ConversationSummarizer> summarizer_;
+
+    static bool isExpired(const Entry& entry, Clock::time_point now) {
+        return entry.expires_at.has_value() && *entry.expires_at <= now;
+    }
+
+    std::optional<std::list<Entry>::iterator> lookup(const String& key, MemoryType type) const {
+        auto store = stores_.find(static_cast<int>(type));
+        if (store == stores_.end()) {
+            return std::nullopt;
+        }
+
+        auto entry = store->second.index.find(key);
+        if (entry == store->second.index.end()) {
+            return std::nullopt;
+        }
+
+        auto it = entry->second;
+        if (isExpired(*it, Clock::now())) {
+            ++store->second.stats.expired;
+            erase(store->second, it);
+            return std::nullopt;
+        }
+
+        // Move to the front of the LRU list
+        store->second.lru.splice(store->second.lru.begin(), store->second.lru, it);
+        return it;
+    }
+
+    static void erase(Store& store, std::list<Entry>::iterator it) {
+        store.bytes -= it->bytes;
+        store.index.erase(it->key);
+        store.lru.erase(it);
+    }
+
+    static void enforce(Store& store) {
+        // Expired entries gathered at the cold end are dropped first
+        auto now = Clock::now();
+        while (!store.lru.empty() && isExpired(store.lru.back(), now)) {
+            ++store.stats.expired;
+            erase(store, std::prev(store.lru.end()));
+        }
+
+        while (!store.lru.empty()) {
+            if (store.policy.max_entries > 0 && store.lru.size() > store.policy.max_entries) {
+                ++store.stats.evicted_by_count;
+            } else if (store.policy.max_bytes > 0 && store.bytes > store.policy.max_bytes) {
+                ++store.stats.evicted_by_bytes;
+            } else {
+                break;
+            }
+
+            erase(store, std::prev(store.lru.end()));
+        }
+    }
+
+    // Drop the oldest messages while the log is over budget, always keeping the newest
+    void trimMessages() {
+        while (messages_.size() > 1) {
+            bool over_count = message_policy_.max_messages > 0 &&
+                messages_.size() > message_policy_.max_messages;
+            bool over_bytes = message_policy_.max_bytes > 0 &&
+                message_bytes_ > message_policy_.max_bytes;
+            if (!over_count && !over_bytes) {
+                break;
+            }
+
+            Message evicted = messages_.pop_front();
+            message_bytes_ -= estimateMessageBytes(evicted);
+            dropRendered();
+            if (over_count) {
+                ++message_stats_.evicted_by_count;
+            } else {
+                ++message_stats_.evicted_by_bytes;
+            }
+
+            spill(evicted);
+        }
+    }
+
+    // Forget the rendering of the oldest message, compacting once half the buffer is dead
+    void dropRendered() {
+        rendered_start_ += rendered_lengths_.front();
+        rendered_lengths_.pop_front();
+
+        if (rendered_start_ > rendered_.size() / 2) {
+            rendered_.erase(0, rendered_start_);
+            rendered_start_ = 0;
+        }
+    }
+
+    void spill(const Message& message) {
+        if (message_policy_.spill_to_long_term) {
+            JsonObject entry;
+            entry["role"] = static_cast<int>(message.role);
+            entry["content"] = message.content;
+            if (message.name) {
+                entry["name"] = *message.name;
+            }
+            add("message:" + std::to_string(spilled_messages_), entry, MemoryType::LONG_TERM);
+        }
+        ++spilled_messages_;
+
+        if (spill_handler_) {
+            spill_handler_(message);
+        }
+    }
 };
 
 std::shared_ptr<Memory> createMemory() {
     return std::make_shared<SimpleMemory>();
 }
 
-} // namespace agents 
\ No newline at end of file
+String renderMessage(const Message& message) {
+    String role_str;
+    switch (message.role) {
+        case Message::Role::SYSTEM:
+            role_str = "System: ";
+            break;
+        case Message::Role::USER:
+            role_str = "User: ";
+            break;
+        case Message::Role::ASSISTANT:
+            role_str = "Assistant: ";
+            break;
+        case Message::Role::TOOL:
+            role_str = "Tool (" + message.name.value_or("unknown") + "): ";
+            break;
+    }
+
+    return role_str + message.content + "\n\n";
+}
+
+size_t estimateJsonBytes(const JsonObject& value) {
+    size_t bytes = sizeof(JsonObject);
+
+    switch (value.type()) {
+        case json::value_t::string:
+            bytes += sizeof(String) + value.get_ref<const String&>().size();
+            break;
+        case json::value_t::array:
+            bytes += sizeof(json::array_t);
+            for (const auto& item : value) {
+                bytes += estimateJsonBytes(item);
+            }
+            break;
+        case json::value_t::object:
+            bytes += sizeof(json::object_t);
+            for (auto it = value.begin(); it != value.end(); ++it) {
+                // Per-node overhead of the underlying std::map
+                bytes += 4 * sizeof(void*) + sizeof(String) + it.key().size();
+                bytes += estimateJsonBytes(it.value());
+            }
+            break;
+        case json::value_t::binary:
+            bytes += sizeof(json::binary_t) + value.get_binary().size();
+            break;
+        default:
+            break;
+    }
+
+    return bytes;
+}
+
+size_t estimateMessageBytes(const Message& message) {
+    size_t bytes = sizeof(Message) + message.content.size();
+    if (message.name) {
+        bytes += message.name->size();
+    }
+    if (message.tool_call_id) {
+        bytes += message.tool_call_id->size();
+    }
+    for (const auto& tool_call : message.tool_calls) {
+        bytes += tool_call.first.size() + estimateJsonBytes(tool_call.second);
+    }
+    return bytes;
+}
+
+} // namespace agents 
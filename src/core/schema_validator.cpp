@@ -0,0 +1,491 @@
+#include <agents-cpp/schema_validator.h>
+#include <agents-cpp/logger.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace agents {
+
+namespace {
+
+uint8_t typeBit(const String& name) {
+    if (name == "null") return 1 << 0;
+    if (name == "boolean") return 1 << 1;
+    if (name == "integer") return 1 << 2;
+    if (name == "number") return 1 << 3;
+    if (name == "string") return 1 << 4;
+    if (name == "array") return 1 << 5;
+    if (name == "object") return 1 << 6;
+
+    // Schemas written for other validators use names like "float" or "any"
+    Logger::warn("Unsupported schema type \"{}\" accepts any value", name);
+    return 0x7f;
+}
+
+String typeNames(uint8_t types) {
+    static const char* names[] = {"null", "boolean", "integer", "number", "string", "array", "object"};
+    String result;
+    for (int bit = 0; bit < 7; ++bit) {
+        if (types & (1 << bit)) {
+            if (!result.empty()) {
+                result += " or ";
+            }
+            result += names[bit];
+        }
+    }
+    return result;
+}
+
+// Length in code points, as JSON Schema counts it
+size_t utf8Length(const String& text) {
+    size_t length = 0;
+    for (unsigned char c : text) {
+        if ((c & 0xC0) != 0x80) {
+            ++length;
+        }
+    }
+    return length;
+}
+
+void prefixError(String* error, const String& segment) {
+    if (error) {
+        error->insert(0, segment);
+    }
+}
+
+void setError(String* error, const String& message) {
+    if (error) {
+        *error = ": " + message;
+    }
+}
+
+// Turn ".a.b[2]: message" into "a.b[2]: message"
+void trimErrorPath(String* error) {
+    if (!error || error->empty()) {
+        return;
+    }
+    if ((*error)[0] == '.') {
+        error->erase(0, 1);
+    } else if ((*error)[0] == ':') {
+        error->insert(0, "value");
+    }
+}
+
+} // namespace
+
+SchemaValidator::SchemaValidator(const JsonObject& schema) {
+    compile(schema);
+}
+
+bool SchemaValidator::empty() const {
+    return nodes_.empty();
+}
+
+uint32_t SchemaValidator::compile(const JsonObject& schema) {
+    uint32_t index = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+
+    if (schema.is_boolean() || schema.is_null()) {
+        return index;
+    }
+    if (!schema.is_object()) {
+        throw std::invalid_argument("Schema must be an object");
+    }
+
+    Node node;
+
+    if (schema.contains("type")) {
+        const auto& type = schema["type"];
+        node.types = 0;
+        if (type.is_string()) {
+            node.types = typeBit(type.get<String>());
+        } else if (type.is_array()) {
+            for (const auto& name : type) {
+                node.types |= typeBit(name.get<String>());
+            }
+        } else {
+            throw std::invalid_argument("Schema \"type\" must be a string or an array");
+        }
+
+        // Every integer is a number
+        if (node.types & TYPE_NUMBER) {
+            node.types |= TYPE_INTEGER;
+        }
+    }
+
+    if (schema.contains("enum") && schema["enum"].is_array()) {
+        node.enum_begin = static_cast<uint32_t>(enums_.size());
+        node.enum_count = static_cast<uint32_t>(schema["enum"].size());
+        for (const auto& value : schema["enum"]) {
+            enums_.push_back(value);
+        }
+    }
+
+    if (schema.contains("minimum") && schema["minimum"].is_number()) {
+        node.minimum = schema["minimum"].get<double>();
+    }
+    if (schema.contains("maximum") && schema["maximum"].is_number()) {
+        node.maximum = schema["maximum"].get<double>();
+    }
+
+    for (const char* key : {"minLength", "minItems"}) {
+        if (schema.contains(key) && schema[key].is_number_unsigned()) {
+            node.min_length = schema[key].get<size_t>();
+        }
+    }
+    for (const char* key : {"maxLength", "maxItems"}) {
+        if (schema.contains(key) && schema[key].is_number_unsigned()) {
+            node.max_length = schema[key].get<size_t>();
+        }
+    }
+
+    if (schema.contains("items")) {
+        node.items = compile(schema["items"]);
+    }
+
+    if (schema.contains("properties") && schema["properties"].is_object()) {
+        // Children append to the pools themselves, so gather ours before appending
+        std::vector<Property> properties;
+        for (auto it = schema["properties"].begin(); it != schema["properties"].end(); ++it) {
+            Property property;
+            property.name = it.key();
+            property.node = compile(it.value());
+            if (it.value().is_object() && it.value().contains("default")) {
+                property.default_value = it.value()["default"];
+            }
+            properties.push_back(std::move(property));
+        }
+
+        if (schema.contains("required") && schema["required"].is_array()) {
+            for (const auto& name : schema["required"]) {
+                for (auto& property : properties) {
+                    if (property.name == name.get<String>()) {
+                        property.required = true;
+                    }
+                }
+            }
+        }
+
+        std::sort(properties.begin(), properties.end(), [](const Property& a, const Property& b) {
+            return a.name < b.name;
+        });
+
+        node.properties_begin = static_cast<uint32_t>(properties_.size());
+        node.properties_count = static_cast<uint32_t>(properties.size());
+        for (auto& property : properties) {
+            properties_.push_back(std::move(property));
+        }
+    }
+
+    if (schema.contains("additionalProperties") && schema["additionalProperties"].is_boolean()) {
+        node.closed = !schema["additionalProperties"].get<bool>();
+    }
+
+    nodes_[index] = node;
+    return index;
+}
+
+uint8_t SchemaValidator::typeOf(const JsonObject& value) {
+    switch (value.type()) {
+        case json::value_t::null:
+            return TYPE_NULL;
+        case json::value_t::boolean:
+            return TYPE_BOOLEAN;
+        case json::value_t::number_integer:
+        case json::value_t::number_unsigned:
+            return TYPE_INTEGER;
+        case json::value_t::number_float: {
+            double number = value.get<double>();
+            return std::isfinite(number) && std::floor(number) == number ? TYPE_NUMBER | TYPE_INTEGER : TYPE_NUMBER;
+        }
+        case json::value_t::string:
+            return TYPE_STRING;
+        case json::value_t::array:
+            return TYPE_ARRAY;
+        case json::value_t::object:
+            return TYPE_OBJECT;
+        default:
+            return 0;
+    }
+}
+
+bool SchemaValidator::coerceScalar(uint8_t types, JsonObject& value) {
+    if (value.is_string()) {
+        const String& text = value.get_ref<const String&>();
+        if (text.empty()) {
+            return false;
+        }
+        const char* begin = text.c_str();
+        char* end = nullptr;
+
+        if (types & TYPE_INTEGER) {
+            errno = 0;
+            long long number = std::strtoll(begin, &end, 10);
+            if (errno == 0 && *end == '\0') {
+                value = number;
+                return true;
+            }
+        }
+        if (types & TYPE_NUMBER) {
+            errno = 0;
+            double number = std::strtod(begin, &end);
+            if (errno == 0 && *end == '\0' && std::isfinite(number)) {
+                value = number;
+                return true;
+            }
+        }
+        if (types & TYPE_BOOLEAN) {
+            if (text == "true" || text == "false") {
+                value = (text == "true");
+                return true;
+            }
+        }
+        return false;
+    }
+
+    if ((types & TYPE_INTEGER) && value.is_number_float()) {
+        double number = value.get<double>();
+        if (std::isfinite(number) && std::floor(number) == number && std::fabs(number) < 9.2e18) {
+            value = static_cast<long long>(number);
+            return true;
+        }
+        return false;
+    }
+
+    if ((types & TYPE_STRING) && (value.is_number() || value.is_boolean())) {
+        value = value.dump();
+        return true;
+    }
+
+    return false;
+}
+
+bool SchemaValidator::checkScalar(
+    const Node& node,
+    const JsonObject& value,
+    bool coerce,
+    bool& coercible,
+    String* error
+) const {
+    coercible = false;
+
+    if ((typeOf(value) & node.types) == 0) {
+        if (coerce) {
+            JsonObject copy = value;
+            if (coerceScalar(node.types, copy)) {
+                // Ranges and enums apply to the coerced value
+                bool ignored;
+                if (!checkScalar(node, copy, false, ignored, error)) {
+                    return false;
+                }
+                coercible = true;
+                return true;
+            }
+        }
+        setError(error, "expected " + typeNames(node.types));
+        return false;
+    }
+
+    // An integral float such as 3.0 is a valid integer, but coercion rewrites it as one
+    bool integral_float = false;
+    if (coerce && value.is_number_float() && (node.types & (TYPE_INTEGER | TYPE_NUMBER)) == TYPE_INTEGER) {
+        JsonObject copy = value;
+        integral_float = coerceScalar(node.types, copy);
+    }
+
+    if (node.enum_count > 0) {
+        auto begin = enums_.begin() + node.enum_begin;
+        auto end = begin + node.enum_count;
+        if (std::find(begin, end, value) == end) {
+            setError(error, "value " + value.dump() + " is not one of the allowed values");
+            return false;
+        }
+    }
+
+    if (value.is_number()) {
+        double number = value.get<double>();
+        if (node.minimum && number < *node.minimum) {
+            setError(error, "must be at least " + JsonObject(*node.minimum).dump());
+            return false;
+        }
+        if (node.maximum && number > *node.maximum) {
+            setError(error, "must be at most " + JsonObject(*node.maximum).dump());
+            return false;
+        }
+    }
+
+    size_t length = SIZE_MAX;
+    if (value.is_string()) {
+        length = utf8Length(value.get_ref<const String&>());
+    } else if (value.is_array()) {
+        length = value.size();
+    }
+    if (length != SIZE_MAX && (length < node.min_length || length > node.max_length)) {
+        setError(error, "length " + std::to_string(length) + " is out of range");
+        return false;
+    }
+
+    coercible = integral_float;
+    return true;
+}
+
+bool SchemaValidator::lookupProperty(const Property* begin, const Property* end, const String& name) {
+    auto it = std::lower_bound(begin, end, name, [](const Property& property, const String& key) {
+        return property.name < key;
+    });
+    return it != end && it->name == name;
+}
+
+SchemaValidator::Status SchemaValidator::checkNode(
+    uint32_t index,
+    const JsonObject& value,
+    bool coerce,
+    String* error
+) const {
+    const Node& node = nodes_[index];
+
+    bool coercible;
+    if (!checkScalar(node, value, coerce, coercible, error)) {
+        return Status::INVALID;
+    }
+    if (coercible) {
+        return Status::NEEDS_NORMALIZE;
+    }
+
+    Status status = Status::VALID;
+
+    if (value.is_object()) {
+        const Property* begin = properties_.data() + node.properties_begin;
+        const Property* end = begin + node.properties_count;
+
+        for (const Property* property = begin; property != end; ++property) {
+            auto it = value.find(property->name);
+            if (it == value.end()) {
+                if (property->default_value) {
+                    status = Status::NEEDS_NORMALIZE;
+                } else if (property->required) {
+                    setError(error, "missing required property");
+                    prefixError(error, "." + property->name);
+                    return Status::INVALID;
+                }
+                continue;
+            }
+
+            Status child = checkNode(property->node, *it, coerce, error);
+            if (child == Status::INVALID) {
+                prefixError(error, "." + property->name);
+                return Status::INVALID;
+            }
+            if (child == Status::NEEDS_NORMALIZE) {
+                status = Status::NEEDS_NORMALIZE;
+            }
+        }
+
+        if (node.closed) {
+            for (auto it = value.begin(); it != value.end(); ++it) {
+                if (!lookupProperty(begin, end, it.key())) {
+                    setError(error, "unexpected property");
+                    prefixError(error, "." + it.key());
+                    return Status::INVALID;
+                }
+            }
+        }
+    } else if (value.is_array() && node.items != kNone) {
+        for (size_t i = 0; i < value.size(); ++i) {
+            Status child = checkNode(node.items, value[i], coerce, error);
+            if (child == Status::INVALID) {
+                prefixError(error, "[" + std::to_string(i) + "]");
+                return Status::INVALID;
+            }
+            if (child == Status::NEEDS_NORMALIZE) {
+                status = Status::NEEDS_NORMALIZE;
+            }
+        }
+    }
+
+    return status;
+}
+
+bool SchemaValidator::normalizeNode(uint32_t index, JsonObject& value, bool coerce, String* error) const {
+    const Node& node = nodes_[index];
+
+    bool coercible;
+    if (!checkScalar(node, value, coerce, coercible, error)) {
+        return false;
+    }
+    if (coercible) {
+        // checkScalar already checked the coerced value
+        coerceScalar(node.types, value);
+    }
+
+    if (value.is_object()) {
+        const Property* begin = properties_.data() + node.properties_begin;
+        const Property* end = begin + node.properties_count;
+
+        for (const Property* property = begin; property != end; ++property) {
+            auto it = value.find(property->name);
+            if (it == value.end()) {
+                if (property->default_value) {
+                    value[property->name] = *property->default_value;
+                } else if (property->required) {
+                    setError(error, "missing required property");
+                    prefixError(error, "." + property->name);
+                    return false;
+                }
+                continue;
+            }
+
+            if (!normalizeNode(property->node, *it, coerce, error)) {
+                prefixError(error, "." + property->name);
+                return false;
+            }
+        }
+
+        if (node.closed) {
+            for (auto it = value.begin(); it != value.end(); ++it) {
+                if (!lookupProperty(begin, end, it.key())) {
+                    setError(error, "unexpected property");
+                    prefixError(error, "." + it.key());
+                    return false;
+                }
+            }
+        }
+    } else if (value.is_array() && node.items != kNone) {
+        for (size_t i = 0; i < value.size(); ++i) {
+            if (!normalizeNode(node.items, value[i], coerce, error)) {
+                prefixError(error, "[" + std::to_string(i) + "]");
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+SchemaValidator::Status SchemaValidator::check(const JsonObject& value, bool coerce, String* error) const {
+    if (nodes_.empty()) {
+        return Status::VALID;
+    }
+
+    Status status = checkNode(0, value, coerce, error);
+    if (status == Status::INVALID) {
+        trimErrorPath(error);
+    }
+    return status;
+}
+
+bool SchemaValidator::normalize(JsonObject& value, bool coerce, String* error) const {
+    if (nodes_.empty()) {
+        return true;
+    }
+
+    bool valid = normalizeNode(0, value, coerce, error);
+    if (!valid) {
+        trimErrorPath(error);
+    }
+    return valid;
+}
+
+} // namespace agents
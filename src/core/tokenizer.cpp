@@ -0,0 +1,668 @@
+#include <agents-cpp/tokenizer.h>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace agents {
+
+namespace {
+
+// SentencePiece's stand-in for a space, U+2581
+const char kSpaceMarker[] = "\xE2\x96\x81";
+constexpr size_t kSpaceMarkerLength = 3;
+
+uint64_t hashBytes(const char* data, size_t len) {
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ (len * 0xFF51AFD7ED558CCDULL);
+    while (len >= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        hash = (hash ^ word) * 0x9FB21C651E98DF25ULL;
+        hash ^= hash >> 29;
+        data += 8;
+        len -= 8;
+    }
+    if (len > 0) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, len);
+        hash = (hash ^ word) * 0x9FB21C651E98DF25ULL;
+        hash ^= hash >> 29;
+    }
+    hash ^= hash >> 32;
+    hash *= 0xD6E8FEB86659FD93ULL;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// Character classes used by the pre-tokenizer
+enum CharClass : uint8_t {
+    OTHER,
+    LETTER,
+    DIGIT,
+    SPACE,
+    NEWLINE
+};
+
+struct CharClassTable {
+    CharClass classes[256];
+
+    CharClassTable() {
+        for (int c = 0; c < 256; ++c) {
+            if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80) {
+                classes[c] = LETTER;
+            } else if (c >= '0' && c <= '9') {
+                classes[c] = DIGIT;
+            } else if (c == '\r' || c == '\n') {
+                classes[c] = NEWLINE;
+            } else if (c == ' ' || c == '\t' || c == '\v' || c == '\f') {
+                classes[c] = SPACE;
+            } else {
+                classes[c] = OTHER;
+            }
+        }
+    }
+};
+
+const CharClassTable kCharClasses;
+
+inline CharClass classOf(char c) {
+    return kCharClasses.classes[static_cast<unsigned char>(c)];
+}
+
+// Length of the contraction ('s, 't, 're, 've, 'm, 'll, 'd) starting at i, or 0
+size_t contractionLength(const char* text, size_t i, size_t n) {
+    if (text[i] != '\'' || i + 1 >= n) {
+        return 0;
+    }
+
+    char a = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i + 1])));
+    if (a == 's' || a == 't' || a == 'm' || a == 'd') {
+        return 2;
+    }
+
+    if (i + 2 < n) {
+        char b = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i + 2])));
+        if ((a == 'r' && b == 'e') || (a == 'v' && b == 'e') || (a == 'l' && b == 'l')) {
+            return 3;
+        }
+    }
+
+    return 0;
+}
+
+// Length of the cl100k pre-tokenizer match starting at i
+size_t nextPieceLength(const char* text, size_t i, size_t n) {
+    if (size_t contraction = contractionLength(text, i, n)) {
+        return contraction;
+    }
+
+    CharClass c = classOf(text[i]);
+    size_t j = i;
+
+    // [^\r\n\p{L}\p{N}]?\p{L}+
+    if (c == LETTER || ((c == OTHER || c == SPACE) && i + 1 < n && classOf(text[i + 1]) == LETTER)) {
+        j = (c == LETTER) ? i : i + 1;
+        while (j < n && classOf(text[j]) == LETTER) {
+            ++j;
+        }
+        return j - i;
+    }
+
+    // \p{N}{1,3}
+    if (c == DIGIT) {
+        while (j < n && j - i < 3 && classOf(text[j]) == DIGIT) {
+            ++j;
+        }
+        return j - i;
+    }
+
+    // ` ?[^\s\p{L}\p{N}]+[\r\n]*`
+    if (c == OTHER || (text[i] == ' ' && i + 1 < n && classOf(text[i + 1]) == OTHER)) {
+        if (text[j] == ' ') {
+            ++j;
+        }
+        while (j < n && classOf(text[j]) == OTHER) {
+            ++j;
+        }
+        while (j < n && classOf(text[j]) == NEWLINE) {
+            ++j;
+        }
+        return j - i;
+    }
+
+    // Whitespace run
+    size_t last_newline = n;
+    while (j < n && (classOf(text[j]) == SPACE || classOf(text[j]) == NEWLINE)) {
+        if (classOf(text[j]) == NEWLINE) {
+            last_newline = j;
+        }
+        ++j;
+    }
+
+    // \s*[\r\n]+
+    if (last_newline != n) {
+        return last_newline + 1 - i;
+    }
+
+    // \s+(?!\S) leaves the last space to prefix the next word
+    if (j == n || j - i < 2) {
+        return j - i;
+    }
+    return j - i - 1;
+}
+
+size_t utf8Length(unsigned char lead) {
+    if (lead < 0x80) return 1;
+    if ((lead >> 5) == 0x6) return 2;
+    if ((lead >> 4) == 0xE) return 3;
+    if ((lead >> 3) == 0x1E) return 4;
+    return 1;
+}
+
+String decodeBase64(const String& input) {
+    static const auto table = [] {
+        std::array<int8_t, 256> t{};
+        t.fill(-1);
+        const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        for (int i = 0; i < 64; ++i) {
+            t[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+        }
+        return t;
+    }();
+
+    String output;
+    output.reserve(input.size() * 3 / 4);
+
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (char ch : input) {
+        int8_t value = table[static_cast<unsigned char>(ch)];
+        if (value < 0) {
+            if (ch == '=') {
+                break;
+            }
+            throw std::runtime_error("Invalid base64 in vocabulary: " + input);
+        }
+        buffer = (buffer << 6) | static_cast<uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            output.push_back(static_cast<char>((buffer >> bits) & 0xFF));
+        }
+    }
+
+    return output;
+}
+
+// Parse "<0xHH>" byte-fallback pieces, returning -1 for anything else
+int byteFallbackValue(const String& piece) {
+    if (piece.size() != 6 || piece.compare(0, 3, "<0x") != 0 || piece[5] != '>') {
+        return -1;
+    }
+    return static_cast<int>(std::strtol(piece.substr(3, 2).c_str(), nullptr, 16));
+}
+
+inline size_t prefixOf(const char* data) {
+    return (static_cast<size_t>(static_cast<unsigned char>(data[0])) << 8) |
+        static_cast<unsigned char>(data[1]);
+}
+
+struct Part {
+    uint32_t start;
+    uint32_t rank;
+};
+
+} // namespace
+
+BpeTokenizer::BpeTokenizer(Format format)
+    : format_(format), byte_tokens_(256, 0) {
+}
+
+std::shared_ptr<BpeTokenizer> BpeTokenizer::fromFile(const String& path, Format format) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open vocabulary file: " + path);
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    return format == Format::TIKTOKEN ? fromTiktoken(buffer.str()) : fromSentencePiece(buffer.str());
+}
+
+std::shared_ptr<BpeTokenizer> BpeTokenizer::fromTiktoken(const String& contents) {
+    std::shared_ptr<BpeTokenizer> tokenizer(new BpeTokenizer(Format::TIKTOKEN));
+    std::vector<std::pair<TokenId, uint32_t>> mergeable;
+
+    std::istringstream lines(contents);
+    String line;
+    size_t byte_count = 0;
+    while (std::getline(lines, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        size_t space = line.find(' ');
+        if (space == String::npos) {
+            throw std::runtime_error("Malformed tiktoken line: " + line);
+        }
+
+        String bytes = decodeBase64(line.substr(0, space));
+        uint32_t rank = static_cast<uint32_t>(std::stoul(line.substr(space + 1)));
+
+        // In tiktoken files the rank doubles as the token id
+        tokenizer->addToken(rank, bytes);
+        mergeable.emplace_back(rank, rank);
+
+        if (bytes.size() == 1) {
+            tokenizer->byte_tokens_[static_cast<unsigned char>(bytes[0])] = rank;
+            ++byte_count;
+        }
+    }
+
+    tokenizer->has_byte_tokens_ = byte_count == 256;
+    tokenizer->buildTable(mergeable);
+    return tokenizer;
+}
+
+std::shared_ptr<BpeTokenizer> BpeTokenizer::fromSentencePiece(const String& contents) {
+    std::shared_ptr<BpeTokenizer> tokenizer(new BpeTokenizer(Format::SENTENCEPIECE));
+
+    struct Piece {
+        TokenId id;
+        float score;
+    };
+    std::vector<Piece> pieces;
+
+    std::istringstream lines(contents);
+    String line;
+    TokenId id = 0;
+    size_t byte_count = 0;
+    while (std::getline(lines, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        size_t tab = line.find('\t');
+        String piece = line.substr(0, tab);
+        float score = tab == String::npos ? 0.0f : std::stof(line.substr(tab + 1));
+
+        int byte_value = byteFallbackValue(piece);
+        if (byte_value >= 0) {
+            // Byte-fallback pieces decode to the raw byte and never take part in merges
+            tokenizer->addToken(id, String(1, static_cast<char>(byte_value)));
+            tokenizer->byte_tokens_[static_cast<size_t>(byte_value)] = id;
+            ++byte_count;
+        } else if (piece == "<unk>") {
+            tokenizer->addToken(id, "");
+            tokenizer->unknown_id_ = id;
+        } else if (piece == "<s>" || piece == "</s>" || piece == "<pad>") {
+            tokenizer->addToken(id, "");
+        } else {
+            tokenizer->addToken(id, piece);
+            pieces.push_back({id, score});
+        }
+        ++id;
+    }
+
+    // Higher scores merge first
+    std::stable_sort(pieces.begin(), pieces.end(), [](const Piece& a, const Piece& b) {
+        return a.score > b.score;
+    });
+
+    std::vector<std::pair<TokenId, uint32_t>> mergeable;
+    mergeable.reserve(pieces.size());
+    for (size_t rank = 0; rank < pieces.size(); ++rank) {
+        mergeable.emplace_back(pieces[rank].id, static_cast<uint32_t>(rank));
+    }
+
+    tokenizer->has_byte_tokens_ = byte_count == 256;
+    tokenizer->buildTable(mergeable);
+    return tokenizer;
+}
+
+std::shared_ptr<BpeTokenizer> BpeTokenizer::byteLevel() {
+    std::shared_ptr<BpeTokenizer> tokenizer(new BpeTokenizer(Format::TIKTOKEN));
+    std::vector<std::pair<TokenId, uint32_t>> mergeable;
+
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        tokenizer->addToken(byte, String(1, static_cast<char>(byte)));
+        tokenizer->byte_tokens_[byte] = byte;
+        mergeable.emplace_back(byte, byte);
+    }
+
+    tokenizer->has_byte_tokens_ = true;
+    tokenizer->buildTable(mergeable);
+    return tokenizer;
+}
+
+void BpeTokenizer::addToken(TokenId id, const String& bytes) {
+    if (id >= token_offsets_.size()) {
+        token_offsets_.resize(id + 1, 0);
+        token_lengths_.resize(id + 1, 0);
+    }
+
+    token_offsets_[id] = static_cast<uint32_t>(arena_.size());
+    token_lengths_[id] = static_cast<uint32_t>(bytes.size());
+    arena_ += bytes;
+}
+
+void BpeTokenizer::buildTable(const std::vector<std::pair<TokenId, uint32_t>>& mergeable) {
+    size_t capacity = 16;
+    while (capacity < mergeable.size() * 2) {
+        capacity <<= 1;
+    }
+
+    table_.assign(capacity, Entry{});
+    table_mask_ = capacity - 1;
+    prefix_bits_.assign(65536 / 64, 0);
+
+    for (const auto& [id, rank] : mergeable) {
+        uint32_t offset = token_offsets_[id];
+        uint32_t len = token_lengths_[id];
+        if (len == 0) {
+            continue;
+        }
+
+        max_token_length_ = std::max<size_t>(max_token_length_, len);
+        if (len >= 2) {
+            size_t prefix = prefixOf(arena_.data() + offset);
+            prefix_bits_[prefix >> 6] |= uint64_t{1} << (prefix & 63);
+        }
+
+        uint64_t hash = hashBytes(arena_.data() + offset, len);
+        uint64_t slot = hash & table_mask_;
+        while (table_[slot].len != 0) {
+            const Entry& existing = table_[slot];
+            if (existing.hash == hash && existing.len == len &&
+                std::memcmp(arena_.data() + existing.offset, arena_.data() + offset, len) == 0) {
+                break;
+            }
+            slot = (slot + 1) & table_mask_;
+        }
+
+        // Duplicate pieces keep their best (lowest) rank
+        if (table_[slot].len == 0 || rank < table_[slot].rank) {
+            table_[slot] = Entry{hash, offset, len, rank, id};
+        }
+    }
+}
+
+const BpeTokenizer::Entry* BpeTokenizer::lookup(const char* data, size_t len) const {
+    if (len > max_token_length_) {
+        return nullptr;
+    }
+    if (len >= 2) {
+        size_t prefix = prefixOf(data);
+        if (!(prefix_bits_[prefix >> 6] & (uint64_t{1} << (prefix & 63)))) {
+            return nullptr;
+        }
+    }
+
+    uint64_t hash = hashBytes(data, len);
+    uint64_t slot = hash & table_mask_;
+
+    while (true) {
+        const Entry& entry = table_[slot];
+        if (entry.len == 0) {
+            return nullptr;
+        }
+        if (entry.hash == hash && entry.len == len &&
+            std::memcmp(arena_.data() + entry.offset, data, len) == 0) {
+            return &entry;
+        }
+        slot = (slot + 1) & table_mask_;
+    }
+}
+
+String BpeTokenizer::normalize(const String& text) const {
+    if (text.empty()) {
+        return text;
+    }
+
+    // Dummy prefix plus spaces replaced by the marker
+    String result(kSpaceMarker);
+    result.reserve(text.size() + text.size() / 4 + kSpaceMarkerLength);
+    for (char ch : text) {
+        if (ch == ' ') {
+            result.append(kSpaceMarker, kSpaceMarkerLength);
+        } else {
+            result.push_back(ch);
+        }
+    }
+    return result;
+}
+
+template <typename Fn>
+void BpeTokenizer::forEachPiece(const String& text, Fn&& fn) const {
+    const char* data = text.data();
+    size_t n = text.size();
+
+    if (format_ == Format::SENTENCEPIECE) {
+        // Every piece starts at a space marker
+        size_t start = 0;
+        for (size_t i = kSpaceMarkerLength; i + kSpaceMarkerLength <= n; ++i) {
+            if (std::memcmp(data + i, kSpaceMarker, kSpaceMarkerLength) == 0) {
+                fn(data + start, i - start);
+                start = i;
+                i += kSpaceMarkerLength - 1;
+            }
+        }
+        if (start < n) {
+            fn(data + start, n - start);
+        }
+        return;
+    }
+
+    size_t i = 0;
+    while (i < n) {
+        size_t len = nextPieceLength(data, i, n);
+        fn(data + i, len);
+        i += len;
+    }
+}
+
+template <typename Emit>
+void BpeTokenizer::encodePiece(const char* data, size_t len, Emit&& emit) const {
+    // Whole-piece hit: most words in a large vocabulary
+    if (const Entry* entry = lookup(data, len)) {
+        emit(entry->id);
+        return;
+    }
+
+    // Scratch space reused across calls so encoding allocates nothing in steady state
+    thread_local std::vector<Part> parts;
+    parts.clear();
+
+    if (format_ == Format::SENTENCEPIECE) {
+        for (size_t i = 0; i < len; i += utf8Length(static_cast<unsigned char>(data[i]))) {
+            parts.push_back({static_cast<uint32_t>(i), kNoRank});
+        }
+    } else {
+        for (size_t i = 0; i < len; ++i) {
+            parts.push_back({static_cast<uint32_t>(i), kNoRank});
+        }
+    }
+    parts.push_back({static_cast<uint32_t>(len), kNoRank});
+
+    // Rank of merging parts[i] with parts[i + skip + 1]
+    auto rankOf = [&](size_t i, size_t skip) -> uint32_t {
+        if (i + skip + 2 >= parts.size()) {
+            return kNoRank;
+        }
+        uint32_t start = parts[i].start;
+        const Entry* entry = lookup(data + start, parts[i + skip + 2].start - start);
+        return entry ? entry->rank : kNoRank;
+    };
+
+    for (size_t i = 0; i + 1 < parts.size(); ++i) {
+        parts[i].rank = rankOf(i, 0);
+    }
+
+    while (parts.size() > 2) {
+        uint32_t min_rank = kNoRank;
+        size_t min_index = 0;
+        for (size_t i = 0; i + 1 < parts.size(); ++i) {
+            if (parts[i].rank < min_rank) {
+                min_rank = parts[i].rank;
+                min_index = i;
+            }
+        }
+
+        if (min_rank == kNoRank) {
+            break;
+        }
+
+        // Re-rank the neighbours as if parts[min_index + 1] were already gone
+        if (min_index > 0) {
+            parts[min_index - 1].rank = rankOf(min_index - 1, 1);
+        }
+        parts[min_index].rank = rankOf(min_index, 1);
+        parts.erase(parts.begin() + static_cast<std::ptrdiff_t>(min_index) + 1);
+    }
+
+    for (size_t i = 0; i + 1 < parts.size(); ++i) {
+        uint32_t start = parts[i].start;
+        uint32_t end = parts[i + 1].start;
+
+        if (const Entry* entry = lookup(data + start, end - start)) {
+            emit(entry->id);
+        } else if (has_byte_tokens_) {
+            for (uint32_t b = start; b < end; ++b) {
+                emit(byte_tokens_[static_cast<unsigned char>(data[b])]);
+            }
+        } else {
+            emit(unknown_id_);
+        }
+    }
+}
+
+std::vector<BpeTokenizer::TokenId> BpeTokenizer::encode(const String& text) const {
+    std::vector<TokenId> tokens;
+    tokens.reserve(text.size() / 3 + 1);
+
+    auto encode_piece = [&](const char* data, size_t len) {
+        encodePiece(data, len, [&](TokenId id) {
+            tokens.push_back(id);
+        });
+    };
+
+    if (format_ == Format::SENTENCEPIECE) {
+        forEachPiece(normalize(text), encode_piece);
+    } else {
+        forEachPiece(text, encode_piece);
+    }
+
+    return tokens;
+}
+
+size_t BpeTokenizer::countTokens(const String& text) const {
+    size_t count = 0;
+
+    auto count_piece = [&](const char* data, size_t len) {
+        encodePiece(data, len, [&](TokenId) {
+            ++count;
+        });
+    };
+
+    if (format_ == Format::SENTENCEPIECE) {
+        forEachPiece(normalize(text), count_piece);
+    } else {
+        forEachPiece(text, count_piece);
+    }
+
+    return count;
+}
+
+String BpeTokenizer::decode(const std::vector<TokenId>& tokens) const {
+    String text;
+    for (TokenId id : tokens) {
+        if (id < token_offsets_.size()) {
+            text.append(arena_, token_offsets_[id], token_lengths_[id]);
+        }
+    }
+
+    if (format_ == Format::SENTENCEPIECE) {
+        String result;
+        result.reserve(text.size());
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text.compare(i, kSpaceMarkerLength, kSpaceMarker) == 0) {
+                result.push_back(' ');
+                i += kSpaceMarkerLength - 1;
+            } else {
+                result.push_back(text[i]);
+            }
+        }
+
+        // Drop the dummy prefix
+        if (!result.empty() && result[0] == ' ') {
+            result.erase(0, 1);
+        }
+        return result;
+    }
+
+    return text;
+}
+
+size_t BpeTokenizer::vocabSize() const {
+    return token_offsets_.size();
+}
+
+BpeTokenizer::Format BpeTokenizer::getFormat() const {
+    return format_;
+}
+
+// TokenCountCache
+
+TokenCountCache::TokenCountCache(std::shared_ptr<const BpeTokenizer> tokenizer, size_t max_entries)
+    : tokenizer_(tokenizer),
+      max_entries_per_shard_(std::max<size_t>(max_entries / kShardCount, 1)) {
+    if (!tokenizer_) {
+        throw std::invalid_argument("TokenCountCache requires a tokenizer");
+    }
+}
+
+size_t TokenCountCache::count(const String& text) {
+    uint64_t hash = hashBytes(text.data(), text.size());
+    Shard& shard = shards_[hash % kShardCount];
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto cached = shard.counts.find(hash);
+        if (cached != shard.counts.end()) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return cached->second;
+        }
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    size_t tokens = tokenizer_->countTokens(text);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.counts.size() >= max_entries_per_shard_) {
+        shard.counts.clear();
+    }
+    shard.counts[hash] = static_cast<uint32_t>(tokens);
+
+    return tokens;
+}
+
+void TokenCountCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.counts.clear();
+    }
+}
+
+size_t TokenCountCache::hits() const {
+    return hits_.load(std::memory_order_relaxed);
+}
+
+size_t TokenCountCache::misses() const {
+    return misses_.load(std::memory_order_relaxed);
+}
+
+} // namespace agents
@@ -1,4 +1,7 @@
 #include <agents-cpp/tool.h>
+#include <agents-cpp/tool_executor.h>
+#include <folly/fibers/Semaphore.h>
+#include <folly/futures/Future.h>
 #include <stdexcept>
 
 namespace agents {
@@ -34,12 +37,95 @@ void Tool::setCallback(ToolCallback callback) {
     callback_ = callback;
 }
 
+void Tool::setAsyncCallback(AsyncToolCallback callback) {
+    async_callback_ = callback;
+}
+
+void Tool::setMaxConcurrency(size_t max_concurrency) {
+    max_concurrency_ = max_concurrency;
+
+    // Calls already holding a slot of the old limit release it into the old semaphore
+    if (max_concurrency > 0) {
+        concurrency_limit_ = std::make_shared<folly::fibers::Semaphore>(max_concurrency);
+    } else {
+        concurrency_limit_.reset();
+    }
+}
+
+size_t Tool::getMaxConcurrency() const {
+    return max_concurrency_;
+}
+
+void Tool::setTimeout(std::chrono::milliseconds timeout) {
+    timeout_ = timeout;
+}
+
+std::chrono::milliseconds Tool::getTimeout() const {
+    return timeout_;
+}
+
+void Tool::setCacheable(bool cacheable, std::chrono::milliseconds ttl) {
+    cacheable_ = cacheable;
+    cache_ttl_ = ttl;
+}
+
+bool Tool::isCacheable() const {
+    return cacheable_;
+}
+
+std::chrono::milliseconds Tool::getCacheTtl() const {
+    return cache_ttl_;
+}
+
+void Tool::setInvalidates(const std::vector<String>& tool_names) {
+    invalidates_ = tool_names;
+}
+
+const std::vector<String>& Tool::getInvalidates() const {
+    return invalidates_;
+}
+
+void Tool::setSerialOnly(bool serial_only) {
+    serial_only_ = serial_only;
+}
+
+bool Tool::isSerialOnly() const {
+    return serial_only_;
+}
+
+void Tool::setExecutor(std::shared_ptr<ToolExecutor> executor) {
+    executor_ = executor;
+}
+
+void Tool::setFlushCallback(std::function<void()> callback) {
+    flush_callback_ = std::move(callback);
+}
+
+bool Tool::hasFlushCallback() const {
+    return static_cast<bool>(flush_callback_);
+}
+
+Task<void> Tool::flushAsync() const {
+    if (!flush_callback_) {
+        co_return;
+    }
+
+    // Flushing usually blocks on the disk, so it belongs on the tool pool too
+    auto callback = flush_callback_;
+    ToolExecutor& pool = executor_ ? *executor_ : ToolExecutor::global();
+    co_await pool.run([callback]() {
+        callback();
+        return ToolResult{true, "", JsonObject()};
+    });
+}
+
 ToolResult Tool::execute(const JsonObject& params) const {
     // Validate parameters
-    if (!validateParameters(params)) {
+    std::optional<JsonObject> normalized;
+    if (auto error = checkParameters(params, normalized)) {
         ToolResult result;
         result.success = false;
-        result.content = "Invalid parameters";
+        result.content = "Invalid parameters: " + *error;
         return result;
     }
     
@@ -51,22 +137,77 @@ ToolResult Tool::execute(const JsonObject& params) const {
         return result;
     }
     
-    return callback_(params);
+    return callback_(normalized ? *normalized : params);
+}
+
+Task<ToolResult> Tool::executeAsync(const JsonObject& params, std::chrono::milliseconds timeout) const {
+    if (timeout_.count() > 0) {
+        timeout = timeout_;
+    }
+
+    if (async_callback_) {
+        std::optional<JsonObject> normalized;
+        if (auto error = checkParameters(params, normalized)) {
+            ToolResult result;
+            result.success = false;
+            result.content = "Invalid parameters: " + *error;
+            co_return result;
+        }
+        const JsonObject& args = normalized ? *normalized : params;
+        if (timeout.count() <= 0) {
+            co_return co_await async_callback_(args);
+        }
+
+        // Async callbacks are cooperative, so they are cancelled rather than abandoned
+        bool timed_out = false;
+        ToolResult result;
+        try {
+            result = co_await folly::coro::timeout(async_callback_(args), timeout);
+        } catch (const folly::FutureTimeout&) {
+            timed_out = true;
+        }
+        co_return timed_out ? ToolExecutor::timeoutResult(timeout) : result;
+    }
+
+    // Keep the tool alive while the call waits for the pool
+    std::shared_ptr<const Tool> self = weak_from_this().lock();
+    const Tool* tool = self ? self.get() : this;
+    auto executor = executor_;
+    JsonObject args = params;
+
+    ToolExecutor& pool = executor ? *executor : ToolExecutor::global();
+    co_return co_await pool.run(
+        [self, tool, args = std::move(args)]() {
+            return tool->execute(args);
+        },
+        concurrency_limit_,
+        timeout);
 }
 
 bool Tool::validateParameters(const JsonObject& params) const {
-    // Check if all required parameters are present
-    for (const auto& param_pair : parameters_) {
-        const Parameter& param = param_pair.second;
-        
-        if (param.required) {
-            if (params.find(param.name) == params.end()) {
-                return false;
-            }
+    return validator_.check(params, coerce_parameters_) != SchemaValidator::Status::INVALID;
+}
+
+void Tool::setCoerceParameters(bool coerce) {
+    coerce_parameters_ = coerce;
+}
+
+std::optional<String> Tool::checkParameters(const JsonObject& params, std::optional<JsonObject>& normalized) const {
+    // The common case, valid parameters used as is, runs the compiled program without copying
+    String error;
+    auto status = validator_.check(params, coerce_parameters_, &error);
+    if (status == SchemaValidator::Status::INVALID) {
+        return error;
+    }
+
+    if (status == SchemaValidator::Status::NEEDS_NORMALIZE) {
+        normalized = params;
+        if (!validator_.normalize(*normalized, coerce_parameters_, &error)) {
+            return error;
         }
     }
-    
-    return true;
+
+    return std::nullopt;
 }
 
 void Tool::updateSchema() {
@@ -92,6 +233,13 @@ void Tool::updateSchema() {
             param_schema["default"] = param.default_value.value();
         }
         
+        // Add extra constraints (enum, ranges, items, nested properties)
+        if (param.constraints.is_object()) {
+            for (auto it = param.constraints.begin(); it != param.constraints.end(); ++it) {
+                param_schema[it.key()] = it.value();
+            }
+        }
+        
         // Add to properties
         properties[param.name] = param_schema;
         
@@ -107,6 +255,9 @@ void Tool::updateSchema() {
     parameter_schema["required"] = required_params;
     
     schema_["parameters"] = parameter_schema;
+    
+    // Compile once here instead of interpreting the schema on every call
+    validator_ = SchemaValidator(parameter_schema);
 }
 
 std::shared_ptr<Tool> createTool(
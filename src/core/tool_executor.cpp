@@ -0,0 +1,147 @@
+#include <agents-cpp/tool_executor.h>
+#include <folly/futures/Future.h>
+#include <folly/Try.h>
+#include <algorithm>
+
+namespace agents {
+
+namespace {
+
+// Pool slots held by one call, released when the callback is done
+struct Permits {
+    folly::fibers::Semaphore* global = nullptr;
+    std::shared_ptr<folly::fibers::Semaphore> tool;
+
+    ~Permits() {
+        if (global) {
+            global->signal();
+        }
+        if (tool) {
+            tool->signal();
+        }
+    }
+};
+
+// Filled by whichever comes first: the callback, the timeout or cancellation
+struct Completion {
+    std::atomic<bool> done{false};
+    folly::Try<ToolResult> result;
+    folly::coro::Baton baton;
+
+    void complete(folly::Try<ToolResult>&& value) {
+        if (!done.exchange(true)) {
+            result = std::move(value);
+            baton.post();
+        }
+    }
+};
+
+} // namespace
+
+ToolExecutor::ToolExecutor(const ToolExecutorOptions& options)
+    : options_(options),
+      pool_(std::make_unique<folly::CPUThreadPoolExecutor>(
+          std::max<size_t>(options.num_threads, 1),
+          std::make_shared<folly::NamedThreadFactory>("ToolExecutor"))) {
+    if (options_.max_in_flight > 0) {
+        in_flight_limit_ = std::make_unique<folly::fibers::Semaphore>(options_.max_in_flight);
+    }
+}
+
+ToolExecutor::~ToolExecutor() {
+    pool_->join();
+}
+
+ToolExecutor& ToolExecutor::global() {
+    static ToolExecutor executor;
+    return executor;
+}
+
+Task<ToolResult> ToolExecutor::run(
+    std::function<ToolResult()> work,
+    std::shared_ptr<folly::fibers::Semaphore> tool_limit,
+    std::chrono::milliseconds timeout
+) {
+    const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+    if (timeout.count() <= 0) {
+        timeout = options_.default_timeout;
+    }
+
+    // Take the tool's own slot first so a saturated tool does not hold global slots.
+    // Slots are released when the callback returns, even if the caller stopped waiting.
+    auto permits = std::make_shared<Permits>();
+    if (tool_limit) {
+        co_await tool_limit->co_wait();
+        permits->tool = tool_limit;
+    }
+    if (in_flight_limit_) {
+        co_await in_flight_limit_->co_wait();
+        permits->global = in_flight_limit_.get();
+    }
+
+    if (token.isCancellationRequested()) {
+        co_return cancelledResult();
+    }
+
+    auto completion = std::make_shared<Completion>();
+    ++in_flight_;
+    pool_->add([this, completion, permits, token, work = std::move(work)]() mutable {
+        if (token.isCancellationRequested()) {
+            completion->complete(folly::Try<ToolResult>(cancelledResult()));
+        } else {
+            ScopedCancellationToken scope(token);
+            completion->complete(folly::makeTryWith(work));
+        }
+
+        permits.reset();
+        --in_flight_;
+        ++completed_;
+    });
+
+    folly::CancellationCallback on_cancel(token, [completion]() {
+        completion->complete(folly::Try<ToolResult>(cancelledResult()));
+    });
+
+    folly::Future<folly::Unit> timer = folly::makeFuture();
+    if (timeout.count() > 0) {
+        timer = folly::futures::sleep(timeout).toUnsafeFuture().thenValue([completion, timeout](folly::Unit) {
+            completion->complete(folly::Try<ToolResult>(timeoutResult(timeout)));
+        });
+    }
+
+    // Resumes on this coroutine's executor, whichever of the three completed first
+    co_await completion->baton;
+    timer.cancel();
+
+    co_return std::move(completion->result).value();
+}
+
+ToolResult ToolExecutor::timeoutResult(std::chrono::milliseconds timeout) {
+    ToolResult result;
+    result.success = false;
+    result.content = "Tool call timed out after " + std::to_string(timeout.count()) + " ms";
+    result.data = {{"error", "timeout"}, {"timeout_ms", timeout.count()}};
+    return result;
+}
+
+ToolResult ToolExecutor::cancelledResult() {
+    ToolResult result;
+    result.success = false;
+    result.content = "Tool call cancelled";
+    result.data = {{"error", "cancelled"}};
+    return result;
+}
+
+folly::Executor* ToolExecutor::getExecutor() {
+    return pool_.get();
+}
+
+size_t ToolExecutor::inFlight() const {
+    return in_flight_.load();
+}
+
+size_t ToolExecutor::completed() const {
+    return completed_.load();
+}
+
+} // namespace agents
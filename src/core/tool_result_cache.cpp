@@ -0,0 +1,234 @@
+#include <agents-cpp/tool_result_cache.h>
+#include <agents-cpp/memory.h>
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace agents {
+
+ToolResultCache::ToolResultCache(const ToolResultCacheOptions& options)
+    : options_(options) {
+    size_t shard_count = 1;
+    while (shard_count < std::max<size_t>(options_.shard_count, 1)) {
+        shard_count <<= 1;
+    }
+    shard_mask_ = shard_count - 1;
+
+    shards_.reserve(shard_count);
+    for (size_t i = 0; i < shard_count; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+ToolResultCache& ToolResultCache::global() {
+    static ToolResultCache cache;
+    return cache;
+}
+
+String ToolResultCache::makeKey(const String& tool_name, const JsonObject& params) {
+    // Object keys are sorted by nlohmann::json, so the dump is canonical
+    String key = tool_name;
+    key += '\0';
+    key += params.dump();
+    return key;
+}
+
+ToolResultCache::Shard& ToolResultCache::shardFor(const String& key) {
+    return *shards_[std::hash<String>{}(key) & shard_mask_];
+}
+
+std::optional<ToolResult> ToolResultCache::get(const String& tool_name, const JsonObject& params) {
+    String key = makeKey(tool_name, params);
+    Shard& shard = shardFor(key);
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    auto it = found->second;
+    if (it->expires_at && *it->expires_at <= Clock::now()) {
+        ++expirations_;
+        ++misses_;
+        erase(shard, it);
+        return std::nullopt;
+    }
+
+    shard.lru.splice(shard.lru.begin(), shard.lru, it);
+    ++hits_;
+    return it->result;
+}
+
+void ToolResultCache::put(
+    const String& tool_name,
+    const JsonObject& params,
+    const ToolResult& result,
+    std::chrono::milliseconds ttl
+) {
+    Entry entry;
+    entry.key = makeKey(tool_name, params);
+    entry.tool_name = tool_name;
+    entry.result = result;
+    if (ttl.count() > 0) {
+        entry.expires_at = Clock::now() + ttl;
+    }
+    insert(std::move(entry));
+}
+
+void ToolResultCache::insert(Entry entry) {
+    entry.bytes = sizeof(Entry) + entry.key.size() + entry.result.content.size() +
+        estimateJsonBytes(entry.result.data);
+
+    size_t shard_count = shard_mask_ + 1;
+    size_t max_bytes = options_.max_bytes / shard_count;
+    size_t max_entries = options_.max_entries > 0 ?
+        std::max<size_t>(options_.max_entries / shard_count, 1) : 0;
+
+    Shard& shard = shardFor(entry.key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // Results larger than a whole shard are not worth evicting everything for
+    if (max_bytes > 0 && entry.bytes > max_bytes) {
+        return;
+    }
+
+    auto existing = shard.index.find(entry.key);
+    if (existing != shard.index.end()) {
+        erase(shard, existing->second);
+    }
+
+    shard.bytes += entry.bytes;
+    shard.lru.push_front(std::move(entry));
+    shard.index[shard.lru.front().key] = shard.lru.begin();
+    ++insertions_;
+
+    while (shard.lru.size() > 1 &&
+           ((max_bytes > 0 && shard.bytes > max_bytes) ||
+            (max_entries > 0 && shard.lru.size() > max_entries))) {
+        ++evictions_;
+        erase(shard, std::prev(shard.lru.end()));
+    }
+}
+
+void ToolResultCache::erase(Shard& shard, std::list<Entry>::iterator it) {
+    shard.bytes -= it->bytes;
+    shard.index.erase(it->key);
+    shard.lru.erase(it);
+}
+
+void ToolResultCache::invalidate(const String& tool_name) {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (auto it = shard->lru.begin(); it != shard->lru.end();) {
+            auto next = std::next(it);
+            if (it->tool_name == tool_name) {
+                erase(*shard, it);
+            }
+            it = next;
+        }
+    }
+}
+
+void ToolResultCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+        shard->bytes = 0;
+    }
+}
+
+ToolResultCache::Stats ToolResultCache::getStats() const {
+    Stats stats;
+    stats.hits = hits_.load();
+    stats.misses = misses_.load();
+    stats.insertions = insertions_.load();
+    stats.evictions = evictions_.load();
+    stats.expirations = expirations_.load();
+
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.entries += shard->lru.size();
+        stats.bytes += shard->bytes;
+    }
+
+    return stats;
+}
+
+size_t ToolResultCache::save(const String& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to open tool result cache file: " + path);
+    }
+
+    auto now = Clock::now();
+    size_t written = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+
+        // Oldest first, so loading restores the recency order
+        for (auto it = shard->lru.rbegin(); it != shard->lru.rend(); ++it) {
+            if (it->expires_at && *it->expires_at <= now) {
+                continue;
+            }
+
+            JsonObject line;
+            line["key"] = it->key;
+            line["tool"] = it->tool_name;
+            line["success"] = it->result.success;
+            line["content"] = it->result.content;
+            line["data"] = it->result.data;
+            if (it->expires_at) {
+                line["expires_at_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    it->expires_at->time_since_epoch()).count();
+            }
+            file << line.dump() << '\n';
+            ++written;
+        }
+    }
+
+    return written;
+}
+
+size_t ToolResultCache::load(const String& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return 0;
+    }
+
+    auto now = Clock::now();
+    size_t loaded = 0;
+    String text;
+    while (std::getline(file, text)) {
+        if (text.empty()) {
+            continue;
+        }
+
+        JsonObject line = JsonObject::parse(text, nullptr, false);
+        if (line.is_discarded() || !line.contains("key") || !line.contains("tool")) {
+            continue;
+        }
+
+        Entry entry;
+        entry.key = line["key"].get<String>();
+        entry.tool_name = line["tool"].get<String>();
+        entry.result.success = line.value("success", true);
+        entry.result.content = line.value("content", "");
+        entry.result.data = line.value("data", JsonObject());
+        if (line.contains("expires_at_ms")) {
+            entry.expires_at = Clock::time_point(std::chrono::milliseconds(line["expires_at_ms"].get<int64_t>()));
+            if (*entry.expires_at <= now) {
+                continue;
+            }
+        }
+
+        insert(std::move(entry));
+        ++loaded;
+    }
+
+    return loaded;
+}
+
+} // namespace agents
@@ -1,4 +1,5 @@
 #include <agents-cpp/llm_interface.h>
+#include <agents-cpp/llms/cancellation.h>
 #include <cpr/cpr.h>
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
@@ -122,7 +123,8 @@ public:
                     {"x-api-key", api_key_}
                 },
                 cpr::Body{request_body.dump()},
-                cpr::Timeout{options_.timeout_ms}
+                cpr::Timeout{options_.timeout_ms},
+                cancellationProgressCallback()
             );
             
             if (response.status_code != 200) {
@@ -227,7 +229,8 @@ public:
                     {"x-api-key", api_key_}
                 },
                 cpr::Body{request_body.dump()},
-                cpr::Timeout{options_.timeout_ms}
+                cpr::Timeout{options_.timeout_ms},
+                cancellationProgressCallback()
             );
             
             if (response.status_code != 200) {
@@ -338,7 +341,8 @@ public:
                     {"x-api-key", api_key_}
                 },
                 cpr::Body{request_body.dump()},
-                cpr::Timeout{options_.timeout_ms}
+                cpr::Timeout{options_.timeout_ms},
+                cancellationProgressCallback()
             );
             
             if (response.status_code != 200) {
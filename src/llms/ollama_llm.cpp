@@ -1,4 +1,5 @@
 #include <agents-cpp/llm_interface.h>
+#include <agents-cpp/llms/cancellation.h>
 #include <cpr/cpr.h>
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
@@ -138,7 +139,8 @@ public:
                 cpr::Url{api_base_ + "/chat"},
                 cpr::Header{{"Content-Type", "application/json"}},
                 cpr::Body{request_body.dump()},
-                cpr::Timeout{options_.timeout_ms}
+                cpr::Timeout{options_.timeout_ms},
+                cancellationProgressCallback()
             );
             
             if (response.status_code != 200) {
@@ -365,7 +367,8 @@ public:
                 cpr::Url{api_base_ + "/chat"},
                 cpr::Header{{"Content-Type", "application/json"}},
                 cpr::Body{request_body.dump()},
-                cpr::Timeout{options_.timeout_ms}
+                cpr::Timeout{options_.timeout_ms},
+                cancellationProgressCallback()
             );
             
             if (response.status_code != 200) {
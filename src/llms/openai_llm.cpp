@@ -1,4 +1,5 @@
 #include <agents-cpp/llm_interface.h>
+#include <agents-cpp/llms/cancellation.h>
 #include <cpr/cpr.h>
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
@@ -118,7 +119,8 @@ public:
                     {"Authorization", "Bearer " + api_key_}
                 },
                 cpr::Body{request_body.dump()},
-                cpr::Timeout{options_.timeout_ms}
+                cpr::Timeout{options_.timeout_ms},
+                cancellationProgressCallback()
             );
             
             if (response.status_code != 200) {
@@ -244,7 +246,8 @@ public:
                     {"Authorization", "Bearer " + api_key_}
                 },
                 cpr::Body{request_body.dump()},
-                cpr::Timeout{options_.timeout_ms}
+                cpr::Timeout{options_.timeout_ms},
+                cancellationProgressCallback()
             );
             
             if (response.status_code != 200) {
@@ -357,7 +360,8 @@ public:
                     {"Authorization", "Bearer " + api_key_}
                 },
                 cpr::Body{request_body.dump()},
-                cpr::Timeout{options_.timeout_ms}
+                cpr::Timeout{options_.timeout_ms},
+                cancellationProgressCallback()
             );
             
             if (response.status_code != 200) {
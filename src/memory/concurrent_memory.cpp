@@ -0,0 +1,266 @@
+#include <agents-cpp/memory/concurrent_memory.h>
+#include <agents-cpp/memory/conversation_summarizer.h>
+#include <functional>
+#include <mutex>
+#include <new>
+
+namespace agents {
+
+namespace {
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+struct SlotLocation {
+    size_t segment;
+    size_t offset;
+    size_t segment_size;
+};
+
+// Segment k holds (1 << first_segment_bits) << k slots
+SlotLocation locateSlot(size_t index, size_t first_segment_bits) {
+    size_t biased = index + (size_t{1} << first_segment_bits);
+    size_t top_bit = 63 - static_cast<size_t>(__builtin_clzll(biased));
+    return {top_bit - first_segment_bits, biased - (size_t{1} << top_bit), size_t{1} << top_bit};
+}
+
+} // namespace
+
+// MessageLog
+
+ConcurrentMemory::MessageLog::~MessageLog() {
+    // No writers may be active during destruction, so every reserved slot is constructed
+    size_t count = reserved_.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; ++i) {
+        Slot& s = slot(i);
+        if (s.ready.load(std::memory_order_acquire)) {
+            s.message().~Message();
+        }
+    }
+
+    for (auto& segment : segments_) {
+        delete[] segment.load(std::memory_order_acquire);
+    }
+}
+
+ConcurrentMemory::MessageLog::Slot& ConcurrentMemory::MessageLog::slot(size_t index) const {
+    SlotLocation location = locateSlot(index, kFirstSegmentBits);
+    return segments_[location.segment].load(std::memory_order_acquire)[location.offset];
+}
+
+ConcurrentMemory::MessageLog::Slot& ConcurrentMemory::MessageLog::slotForWrite(size_t index) {
+    SlotLocation location = locateSlot(index, kFirstSegmentBits);
+
+    Slot* slots = segments_[location.segment].load(std::memory_order_acquire);
+    if (!slots) {
+        // Race to install the segment; losers discard their allocation
+        Slot* fresh = new Slot[location.segment_size];
+        if (segments_[location.segment].compare_exchange_strong(
+                slots, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            slots = fresh;
+        } else {
+            delete[] fresh;
+        }
+    }
+
+    return slots[location.offset];
+}
+
+void ConcurrentMemory::MessageLog::append(const Message& message) {
+    size_t index = reserved_.fetch_add(1, std::memory_order_relaxed);
+    Slot& s = slotForWrite(index);
+
+    new (s.storage) Message(message);
+    s.ready.store(true, std::memory_order_release);
+
+    advanceCommitted();
+}
+
+size_t ConcurrentMemory::MessageLog::advanceCommitted() const {
+    // Extend the published prefix over any contiguous run of ready slots.
+    // Both readers and writers help, so no thread ever waits on another.
+    size_t committed = committed_.load(std::memory_order_acquire);
+    size_t reserved = reserved_.load(std::memory_order_acquire);
+
+    while (committed < reserved) {
+        // The writer of this slot may not have installed its segment yet
+        SlotLocation location = locateSlot(committed, kFirstSegmentBits);
+        if (!segments_[location.segment].load(std::memory_order_acquire)) {
+            break;
+        }
+
+        if (!slot(committed).ready.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        // On failure committed is reloaded with the value another thread published
+        if (committed_.compare_exchange_weak(
+                committed, committed + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            ++committed;
+        }
+    }
+
+    return committed;
+}
+
+std::vector<Message> ConcurrentMemory::MessageLog::snapshot() const {
+    size_t count = advanceCommitted();
+
+    std::vector<Message> result;
+    result.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(slot(i).message());
+    }
+
+    return result;
+}
+
+size_t ConcurrentMemory::MessageLog::size() const {
+    return advanceCommitted();
+}
+
+// ConcurrentMemory
+
+ConcurrentMemory::ConcurrentMemory(size_t shard_count)
+    : shard_mask_(roundUpToPowerOfTwo(shard_count == 0 ? 1 : shard_count) - 1) {
+    for (auto& shards : shards_) {
+        shards = std::make_unique<Shard[]>(shard_mask_ + 1);
+    }
+}
+
+ConcurrentMemory::~ConcurrentMemory() = default;
+
+ConcurrentMemory::Shard& ConcurrentMemory::shardFor(const String& key, MemoryType type) const {
+    size_t hash = std::hash<String>{}(key);
+    return shards_[static_cast<size_t>(type)][hash & shard_mask_];
+}
+
+void ConcurrentMemory::add(const String& key, const JsonObject& value, MemoryType type) {
+    Shard& shard = shardFor(key, type);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.entries[key] = value;
+}
+
+std::optional<JsonObject> ConcurrentMemory::get(const String& key, MemoryType type) const {
+    Shard& shard = shardFor(key, type);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+    auto entry = shard.entries.find(key);
+    if (entry == shard.entries.end()) {
+        return std::nullopt;
+    }
+
+    return entry->second;
+}
+
+bool ConcurrentMemory::has(const String& key, MemoryType type) const {
+    Shard& shard = shardFor(key, type);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.entries.find(key) != shard.entries.end();
+}
+
+void ConcurrentMemory::remove(const String& key, MemoryType type) {
+    Shard& shard = shardFor(key, type);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.entries.erase(key);
+}
+
+void ConcurrentMemory::clear(MemoryType type) {
+    auto& shards = shards_[static_cast<size_t>(type)];
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+        std::unique_lock<std::shared_mutex> lock(shards[i].mutex);
+        shards[i].entries.clear();
+    }
+}
+
+void ConcurrentMemory::addMessage(const Message& message) {
+    messages_.append(message);
+
+    if (auto summarizer = std::atomic_load(&summarizer_)) {
+        summarizer->observe(message);
+    }
+}
+
+std::vector<Message> ConcurrentMemory::getMessages() const {
+    return messages_.snapshot();
+}
+
+size_t ConcurrentMemory::messageCount() const {
+    return messages_.size();
+}
+
+String ConcurrentMemory::getConversationSummary(int max_length) const {
+    if (auto summarizer = std::atomic_load(&summarizer_)) {
+        String summary = summarizer->getSummary();
+        if (max_length > 0 && summary.length() > static_cast<size_t>(max_length)) {
+            summary = summary.substr(0, max_length) + "...";
+        }
+        return summary;
+    }
+
+    String summary;
+
+    for (const auto& message : messages_.snapshot()) {
+        summary += renderMessage(message);
+
+        // Stop rendering once we are past the requested length
+        if (max_length > 0 && summary.length() > static_cast<size_t>(max_length)) {
+            break;
+        }
+    }
+
+    // Truncate if needed
+    if (max_length > 0 && summary.length() > static_cast<size_t>(max_length)) {
+        summary = summary.substr(0, max_length) + "...";
+    }
+
+    return summary;
+}
+
+void ConcurrentMemory::setSummarizer(std::shared_ptr<ConversationSummarizer> summarizer) {
+    // Catch up on existing history; set the summarizer before sharing the memory across threads
+    if (summarizer) {
+        for (const auto& message : messages_.snapshot()) {
+            summarizer->observe(message);
+        }
+    }
+    std::atomic_store(&summarizer_, summarizer);
+}
+
+std::vector<std::pair<JsonObject, float>> ConcurrentMemory::search(
+    const String& query,
+    MemoryType type,
+    int max_results
+) const {
+    // Same placeholder ranking as SimpleMemory, gathered shard by shard
+    std::vector<std::pair<JsonObject, float>> results;
+    if (max_results <= 0) {
+        return results;
+    }
+
+    const auto& shards = shards_[static_cast<size_t>(type)];
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+        std::shared_lock<std::shared_mutex> lock(shards[i].mutex);
+
+        for (const auto& entry : shards[i].entries) {
+            results.emplace_back(entry.second, 0.5f);
+
+            if (results.size() >= static_cast<size_t>(max_results)) {
+                return results;
+            }
+        }
+    }
+
+    return results;
+}
+
+std::shared_ptr<Memory> createConcurrentMemory(size_t shard_count) {
+    return std::make_shared<ConcurrentMemory>(shard_count);
+}
+
+} // namespace agents
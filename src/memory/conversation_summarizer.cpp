@@ -0,0 +1,269 @@
+#include <agents-cpp/memory/conversation_summarizer.h>
+#include <agents-cpp/memory.h>
+#include <agents-cpp/logger.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace agents {
+
+namespace {
+
+String truncate(const String& text, size_t max_length) {
+    if (max_length == 0 || text.size() <= max_length) {
+        return text;
+    }
+    return text.substr(0, max_length) + "...";
+}
+
+} // namespace
+
+struct ConversationSummarizer::State {
+    std::mutex mutex;
+    std::condition_variable idle;
+
+    ConversationSummarizerOptions options;
+    SummarizeFunction summarize;
+
+    // Bumped by clear() so in-flight summaries of forgotten chunks are discarded
+    uint64_t generation = 0;
+
+    // Chunk being filled, rendered verbatim
+    String open_chunk;
+    size_t open_turns = 0;
+
+    // Closed chunks waiting for their summary, oldest first
+    std::deque<String> pending;
+    bool draining = false;
+
+    // levels[0] summarizes chunks, levels[k + 1] merges summaries of levels[k]; oldest first
+    std::vector<std::vector<String>> levels;
+
+    // Cached rendering of everything before the open chunk
+    String prefix;
+
+    Stats stats;
+
+    void rebuildPrefix() {
+        prefix.clear();
+
+        // Higher levels cover older parts of the conversation
+        for (size_t level = levels.size(); level-- > 0;) {
+            for (const auto& summary : levels[level]) {
+                prefix += "Summary of earlier conversation: ";
+                prefix += summary;
+                prefix += "\n\n";
+            }
+        }
+        for (const auto& chunk : pending) {
+            prefix += chunk;
+        }
+    }
+
+    String runSummarize(const String& text) {
+        try {
+            return truncate(summarize(text, options.max_summary_length), options.max_summary_length);
+        } catch (const std::exception& e) {
+            Logger::error("Conversation summarization failed: {}", e.what());
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.failures;
+            return truncate(text, options.max_summary_length);
+        }
+    }
+
+    // Summarize pending chunks one at a time so summaries land in conversation order
+    static void drain(const std::shared_ptr<State>& state) {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        while (!state->pending.empty()) {
+            String chunk = state->pending.front();
+            uint64_t generation = state->generation;
+
+            lock.unlock();
+            String summary = state->runSummarize(chunk);
+            lock.lock();
+
+            if (generation != state->generation) {
+                continue;
+            }
+            state->pending.pop_front();
+            if (state->levels.empty()) {
+                state->levels.emplace_back();
+            }
+            state->levels[0].push_back(std::move(summary));
+            ++state->stats.summaries;
+
+            // Merge full levels upwards; this thread is the only one touching levels
+            for (size_t level = 0; level < state->levels.size(); ++level) {
+                if (state->levels[level].size() < std::max<size_t>(state->options.summaries_per_level, 2)) {
+                    break;
+                }
+
+                String joined;
+                for (const auto& part : state->levels[level]) {
+                    joined += part;
+                    joined += "\n\n";
+                }
+
+                lock.unlock();
+                String merged = state->runSummarize(joined);
+                lock.lock();
+
+                if (generation != state->generation) {
+                    break;
+                }
+                state->levels[level].clear();
+                if (level + 1 == state->levels.size()) {
+                    state->levels.emplace_back();
+                }
+                state->levels[level + 1].push_back(std::move(merged));
+                ++state->stats.merges;
+            }
+
+            state->rebuildPrefix();
+        }
+
+        state->draining = false;
+        state->idle.notify_all();
+    }
+
+    // Hand the open chunk over to summarization; called with the mutex held
+    bool closeChunk() {
+        if (open_chunk.empty()) {
+            return false;
+        }
+
+        pending.push_back(std::move(open_chunk));
+        open_chunk.clear();
+        open_turns = 0;
+        ++stats.chunks_closed;
+        rebuildPrefix();
+
+        if (draining) {
+            return false;
+        }
+        draining = true;
+        return true;
+    }
+
+    // Start a drain after closeChunk() asked for one; called without the mutex.
+    // Drains block on summarize calls, so they run on the blocking executor
+    // rather than the threads that run coroutines.
+    static void schedule(const std::shared_ptr<State>& state) {
+        if (state->options.background) {
+            getBlockingExecutor()->add([state]() { drain(state); });
+        } else {
+            drain(state);
+        }
+    }
+};
+
+ConversationSummarizer::ConversationSummarizer(
+    std::shared_ptr<LLMInterface> llm,
+    const ConversationSummarizerOptions& options
+) : ConversationSummarizer(
+        [llm](const String& text, size_t max_length) {
+            return summarizeWithLLM(llm, text, max_length);
+        },
+        options) {
+    if (!llm) {
+        throw std::invalid_argument("ConversationSummarizer requires an LLM");
+    }
+}
+
+ConversationSummarizer::ConversationSummarizer(
+    SummarizeFunction summarize,
+    const ConversationSummarizerOptions& options
+) : state_(std::make_shared<State>()) {
+    if (!summarize) {
+        throw std::invalid_argument("ConversationSummarizer requires a summarize function");
+    }
+    state_->options = options;
+    state_->summarize = std::move(summarize);
+}
+
+void ConversationSummarizer::observe(const Message& message) {
+    // Render outside the lock
+    String rendered = renderMessage(message);
+    bool start_drain = false;
+
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        ++state_->stats.messages;
+
+        if (message.role == Message::Role::USER) {
+            if (state_->open_turns >= std::max<size_t>(state_->options.turns_per_chunk, 1)) {
+                start_drain = state_->closeChunk();
+            }
+            ++state_->open_turns;
+        }
+        state_->open_chunk += rendered;
+    }
+
+    if (start_drain) {
+        State::schedule(state_);
+    }
+}
+
+String ConversationSummarizer::getSummary() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->prefix + state_->open_chunk;
+}
+
+void ConversationSummarizer::flush() {
+    bool start_drain;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        start_drain = state_->closeChunk();
+    }
+    if (start_drain) {
+        State::schedule(state_);
+    }
+
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->idle.wait(lock, [this]() { return !state_->draining; });
+}
+
+void ConversationSummarizer::clear() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    ++state_->generation;
+    state_->open_chunk.clear();
+    state_->open_turns = 0;
+    state_->pending.clear();
+    state_->levels.clear();
+    state_->prefix.clear();
+}
+
+ConversationSummarizer::Stats ConversationSummarizer::getStats() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->stats;
+}
+
+String ConversationSummarizer::summarizeWithLLM(
+    const std::shared_ptr<LLMInterface>& llm,
+    const String& text,
+    size_t max_length
+) {
+    Message system_msg;
+    system_msg.role = Message::Role::SYSTEM;
+    system_msg.content = "Summarize the following conversation excerpt in at most " +
+        std::to_string(max_length) + " characters. Keep facts, decisions, tool results "
+        "and open questions; drop pleasantries. Reply with the summary only.";
+
+    Message user_msg;
+    user_msg.role = Message::Role::USER;
+    user_msg.content = text;
+
+    LLMResponse response = llm->chat({system_msg, user_msg});
+    return response.content;
+}
+
+std::shared_ptr<ConversationSummarizer> createConversationSummarizer(
+    std::shared_ptr<LLMInterface> llm,
+    const ConversationSummarizerOptions& options
+) {
+    return std::make_shared<ConversationSummarizer>(llm, options);
+}
+
+} // namespace agents
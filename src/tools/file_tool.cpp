@@ -0,0 +1,921 @@
+#include <agents-cpp/tools/file_tool.h>
+#include <agents-cpp/tools/tool_registry.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <stdexcept>
+
+namespace agents {
+namespace tools {
+
+namespace {
+
+// Bytes inspected to decide whether a selection is binary
+constexpr size_t kBinaryProbeBytes = 8192;
+
+// Read size for files read with pread
+constexpr size_t kReadBlock = 64 * 1024;
+
+bool isContinuationByte(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+// Move a cut point back so it does not split a UTF-8 sequence
+size_t alignBackward(std::string_view bytes, size_t pos) {
+    size_t steps = 0;
+    while (pos > 0 && pos < bytes.size() && isContinuationByte(bytes[pos]) && steps++ < 3) {
+        --pos;
+    }
+    return pos;
+}
+
+// Move a cut point forward so it does not split a UTF-8 sequence
+size_t alignForward(std::string_view bytes, size_t pos) {
+    size_t steps = 0;
+    while (pos < bytes.size() && isContinuationByte(bytes[pos]) && steps++ < 3) {
+        ++pos;
+    }
+    return pos;
+}
+
+std::optional<size_t> optionalSize(const JsonObject& params, const char* name) {
+    if (!params.contains(name) || params[name].is_null()) {
+        return std::nullopt;
+    }
+    return params[name].get<size_t>();
+}
+
+String errorText(const String& what, const String& path) {
+    return what + " " + path + ": " + std::strerror(errno);
+}
+
+/**
+ * @brief The file behind one file_read call
+ *
+ * Only the windows a call returns are read, with pread. Files that report
+ * no size (/proc) cannot be addressed from their end, so they are read
+ * whole, up to max_read_bytes.
+ */
+class FileSource {
+public:
+    FileSource(const String& path, size_t max_read_bytes) : path_(path) {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::runtime_error(errorText("Cannot open", path));
+        }
+
+        struct stat info;
+        if (::fstat(fd_, &info) != 0) {
+            int error = errno;
+            ::close(fd_);
+            throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(error));
+        }
+        if (S_ISDIR(info.st_mode)) {
+            ::close(fd_);
+            throw std::runtime_error(path + " is a directory");
+        }
+        if (!S_ISREG(info.st_mode)) {
+            ::close(fd_);
+            throw std::runtime_error(path + " is not a regular file");
+        }
+
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ == 0) {
+            view_ = std::make_unique<FileView>(path, SIZE_MAX, max_read_bytes);
+            size_ = view_->bytes().size();
+        }
+    }
+
+    ~FileSource() {
+        ::close(fd_);
+    }
+
+    FileSource(const FileSource&) = delete;
+    FileSource& operator=(const FileSource&) = delete;
+
+    size_t size() const {
+        return size_;
+    }
+
+    // Whether the file was only partly read because it reports no size
+    bool isTruncated() const {
+        return view_ && view_->isTruncated();
+    }
+
+    // Bytes in [offset, offset + length), fewer if the file ends first
+    String read(size_t offset, size_t length) const {
+        offset = std::min(offset, size_);
+        length = std::min(length, size_ - offset);
+        if (view_) {
+            return String(view_->bytes().substr(offset, length));
+        }
+
+        String bytes(length, '\0');
+        size_t done = 0;
+        while (done < length) {
+            ssize_t count = ::pread(fd_, &bytes[done], length - done, static_cast<off_t>(offset + done));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                throw std::runtime_error(errorText("Cannot read", path_));
+            }
+            if (count == 0) {
+                break;
+            }
+            done += static_cast<size_t>(count);
+        }
+        bytes.resize(done);
+        return bytes;
+    }
+
+private:
+    String path_;
+    int fd_ = -1;
+    size_t size_ = 0;
+    std::unique_ptr<FileView> view_;
+};
+
+/**
+ * @brief Byte range chosen by the line and byte parameters of a call
+ */
+struct Selection {
+    size_t begin = 0;
+    size_t end = 0;
+    std::optional<size_t> first_line;
+    std::optional<size_t> last_line;
+    bool scan_truncated = false;
+};
+
+// Start of the last count lines, found by reading backwards from the end one block at a time
+size_t findTailStart(const FileSource& source, size_t count) {
+    size_t pos = source.size();
+    bool skip_final_newline = true;
+    size_t found = 0;
+    while (pos > 0) {
+        size_t block_begin = pos - std::min(pos, kReadBlock);
+        String block = source.read(block_begin, pos - block_begin);
+        size_t end = block.size();
+
+        // The final newline ends the last line rather than starting one
+        if (skip_final_newline && end > 0 && block_begin + end == source.size() && block[end - 1] == '\n') {
+            --end;
+        }
+        skip_final_newline = false;
+
+        while (end > 0) {
+            const void* newline = memrchr(block.data(), '\n', end);
+            if (!newline) {
+                break;
+            }
+            end = static_cast<size_t>(static_cast<const char*>(newline) - block.data());
+            if (++found == count) {
+                return block_begin + end + 1;
+            }
+        }
+        pos = block_begin;
+    }
+    return 0;
+}
+
+// Lines narrow the selection first, then the byte range intersects it
+Selection select(const FileSource& source, const String& path, const JsonObject& params,
+                 const FileReadOptions& options) {
+    Selection selection;
+    size_t size = source.size();
+    selection.end = size;
+
+    auto start_line = optionalSize(params, "start_line");
+    auto end_line = optionalSize(params, "end_line");
+    auto tail_lines = optionalSize(params, "tail_lines");
+
+    if (tail_lines) {
+        if (start_line || end_line) {
+            throw std::invalid_argument("tail_lines cannot be combined with start_line or end_line");
+        }
+        selection.begin = *tail_lines > 0 ? findTailStart(source, *tail_lines) : size;
+    } else if (start_line || end_line) {
+        size_t first = start_line.value_or(1);
+        if (first == 0 || (end_line && *end_line < first)) {
+            throw std::invalid_argument("Line numbers start at 1 and end_line must not precede start_line");
+        }
+
+        // Scan forward in blocks for the start of the first line and the end of the last,
+        // reading no further than max_read_bytes
+        std::optional<size_t> begin;
+        std::optional<size_t> end;
+        if (first == 1) {
+            begin = 0;
+        }
+        size_t line = 1;
+        size_t limit = std::min(options.max_read_bytes, size);
+        size_t scanned = streamFile(path, 0, limit, kReadBlock, [&](std::string_view chunk, size_t offset) {
+            size_t pos = 0;
+            while (pos < chunk.size()) {
+                const void* newline = std::memchr(chunk.data() + pos, '\n', chunk.size() - pos);
+                if (!newline) {
+                    break;
+                }
+                pos = static_cast<size_t>(static_cast<const char*>(newline) - chunk.data()) + 1;
+                ++line;
+                if (line == first) {
+                    begin = offset + pos;
+                }
+                if (end_line && line == *end_line + 1) {
+                    end = offset + pos;
+                    return false;
+                }
+            }
+            return end_line.has_value() || !begin;
+        }, options);
+        bool finished = end || (!end_line && begin);
+        selection.scan_truncated = !finished && scanned < size;
+
+        selection.begin = begin.value_or(std::min(scanned, size));
+        selection.first_line = first;
+        if (end_line) {
+            selection.end = end.value_or(std::min(scanned, size));
+            selection.last_line = *end_line;
+        }
+    }
+
+    auto offset = optionalSize(params, "offset");
+    auto length = optionalSize(params, "length");
+    if (offset) {
+        selection.begin = std::max(selection.begin, std::min(*offset, size));
+    }
+    if (length) {
+        size_t from = offset ? std::min(*offset, size) : selection.begin;
+        selection.end = std::min(selection.end, from + std::min(*length, size - from));
+    }
+    selection.end = std::max(selection.end, selection.begin);
+
+    return selection;
+}
+
+ToolResult readFile(const FileReadOptions& options, const JsonObject& params) {
+    ToolResult result;
+    String path = params["path"].get<String>();
+
+    FileSource source(path, options.max_read_bytes);
+    Selection selection = select(source, path, params, options);
+    size_t selected = selection.end - selection.begin;
+
+    size_t cap = options.max_output_bytes;
+    if (auto max_bytes = optionalSize(params, "max_bytes")) {
+        cap = std::min(cap, std::max<size_t>(*max_bytes, 1));
+    }
+    bool stream = params.value("stream", false);
+
+    result.success = true;
+    result.data = {
+        {"path", path},
+        {"size", source.size()},
+        {"range_start", selection.begin},
+        {"range_end", selection.end}
+    };
+    if (source.isTruncated() || selection.scan_truncated) {
+        // Reading stopped at max_read_bytes; sizes and line positions past it are unknown
+        result.data["read_truncated"] = true;
+    }
+    if (selection.first_line) {
+        result.data["start_line"] = *selection.first_line;
+    }
+    if (selection.last_line) {
+        result.data["end_line"] = *selection.last_line;
+    }
+
+    String probe = source.read(selection.begin, std::min(selected, kBinaryProbeBytes));
+    if (probe.find('\0') != String::npos) {
+        result.content = "Binary file " + path + " (" + std::to_string(selected) + " bytes selected)";
+        result.data["binary"] = true;
+        return result;
+    }
+
+    if (stream) {
+        // One chunk per call; the caller continues from next_offset.
+        // The byte after the chunk is read too, to tell whether the cut splits a character.
+        size_t chunk = std::min(cap, options.stream_chunk_bytes);
+        size_t end = std::min(selected, chunk);
+        String window = source.read(selection.begin, std::min(selected, end + 1));
+        if (end < selected) {
+            // Prefer ending on a line within the last quarter of the chunk
+            const void* newline = memrchr(window.data() + end - end / 4, '\n', end / 4);
+            if (newline) {
+                end = static_cast<size_t>(static_cast<const char*>(newline) - window.data()) + 1;
+            } else {
+                end = std::max<size_t>(alignBackward(window, end), 1);
+            }
+        }
+        appendValidUtf8(result.content, std::string_view(window).substr(0, end));
+        result.data["bytes_returned"] = end;
+        result.data["next_offset"] = selection.begin + end;
+        result.data["eof"] = selection.begin + end >= selection.end;
+        result.data["truncated"] = false;
+        return result;
+    }
+
+    if (selected <= cap) {
+        String window = source.read(selection.begin, selected);
+        result.content.reserve(window.size());
+        appendValidUtf8(result.content, window);
+        result.data["bytes_returned"] = window.size();
+        result.data["truncated"] = false;
+        return result;
+    }
+
+    // Keep the head and tail of the selection, reading only those windows plus the few
+    // bytes around each cut needed to keep it on a character boundary
+    constexpr size_t kSlack = 3;
+    size_t head_size = cap / 2;
+    size_t tail_size = cap - head_size;
+    String head = source.read(selection.begin, head_size + 1);
+    head.resize(alignBackward(head, std::min(head_size, head.size())));
+
+    size_t tail_from = selection.end - tail_size;
+    size_t slack = std::min(kSlack, tail_from - selection.begin);
+    String tail = source.read(tail_from - slack, tail_size + slack);
+    size_t tail_offset = alignForward(tail, slack);
+    size_t omitted = selected - head.size() - (tail.size() - tail_offset);
+
+    result.content.reserve(cap + 64);
+    appendValidUtf8(result.content, head);
+    result.content += "\n... [" + std::to_string(omitted) + " bytes omitted] ...\n";
+    appendValidUtf8(result.content, std::string_view(tail).substr(tail_offset));
+
+    result.data["bytes_returned"] = head.size() + (tail.size() - tail_offset);
+    result.data["omitted_bytes"] = omitted;
+    result.data["truncated"] = true;
+    return result;
+}
+
+String directoryOf(const String& path) {
+    size_t slash = path.find_last_of('/');
+    if (slash == String::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+void writeAll(int fd, const String& content, const String& path) {
+    size_t offset = 0;
+    while (offset < content.size()) {
+        ssize_t written = ::write(fd, content.data() + offset, content.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(errorText("Cannot write", path));
+        }
+        offset += static_cast<size_t>(written);
+    }
+}
+
+void syncPath(const String& path, bool directory) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | (directory ? O_DIRECTORY : 0));
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+Parameter sizeParameter(const String& name, const String& description, size_t minimum) {
+    Parameter param;
+    param.name = name;
+    param.description = description;
+    param.type = "integer";
+    param.required = false;
+    param.constraints = {{"minimum", minimum}};
+    return param;
+}
+
+ToolResult writeFileTool(const FileWriteOptions& options, const JsonObject& params) {
+    String path = params["path"].get<String>();
+    bool append = params.value("mode", "overwrite") == "append";
+    auto written = writeFile(path, params["content"].get<String>(), append, options);
+
+    ToolResult result;
+    result.success = true;
+    result.content = String(append ? "Appended " : "Wrote ") + std::to_string(written.bytes_written) +
+        " bytes to " + path;
+    result.data = {
+        {"path", path},
+        {"mode", append ? "append" : "overwrite"},
+        {"bytes_written", written.bytes_written},
+        {"latency_ms", static_cast<double>(written.latency.count()) / 1000.0},
+        {"synced", written.synced},
+        {"deferred", written.deferred}
+    };
+    return result;
+}
+
+} // namespace
+
+void appendValidUtf8(String& out, std::string_view in) {
+    static const char kReplacement[] = "\xEF\xBF\xBD";
+    size_t i = 0;
+    while (i < in.size()) {
+        unsigned char c = static_cast<unsigned char>(in[i]);
+        size_t length = c < 0x80 ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+
+        bool valid = length > 0 && i + length <= in.size();
+        for (size_t k = 1; valid && k < length; ++k) {
+            valid = isContinuationByte(in[i + k]);
+        }
+        if (valid && length > 1) {
+            // Reject overlong encodings, surrogates and code points past U+10FFFF
+            uint32_t cp = c & (0xFF >> (length + 1));
+            for (size_t k = 1; k < length; ++k) {
+                cp = (cp << 6) | (static_cast<unsigned char>(in[i + k]) & 0x3F);
+            }
+            static const uint32_t kMinimum[] = {0, 0, 0x80, 0x800, 0x10000};
+            valid = cp >= kMinimum[length] && cp <= 0x10FFFF && (cp < 0xD800 || cp > 0xDFFF);
+        }
+
+        if (valid) {
+            out.append(in.data() + i, length);
+            i += length;
+        } else {
+            out.append(kReplacement);
+            ++i;
+        }
+    }
+}
+
+FileView::FileView(const String& path, size_t mmap_threshold, size_t max_read_bytes) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+    }
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Cannot stat " + path + ": " + std::strerror(error));
+    }
+    if (S_ISDIR(info.st_mode)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is a directory");
+    }
+    if (!S_ISREG(info.st_mode)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a regular file");
+    }
+
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size > 0 && size >= mmap_threshold) {
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            ::madvise(mapping, size, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(mapping);
+            size_ = size;
+            mapped_size_ = size;
+            ::close(fd);
+            return;
+        }
+    }
+
+    // Sizes of /proc files are unknown and other files may grow, so read until end of file
+    size_t offset = 0;
+    while (offset < max_read_bytes) {
+        size_t block = std::min(kReadBlock, max_read_bytes - offset);
+        buffer_.resize(offset + block);
+        ssize_t count = ::pread(fd, &buffer_[offset], block, static_cast<off_t>(offset));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot read " + path + ": " + std::strerror(error));
+        }
+        if (count == 0) {
+            break;
+        }
+        offset += static_cast<size_t>(count);
+    }
+    if (offset >= max_read_bytes) {
+        char probe;
+        truncated_ = ::pread(fd, &probe, 1, static_cast<off_t>(offset)) > 0;
+    }
+    ::close(fd);
+
+    buffer_.resize(offset);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+}
+
+FileView::~FileView() {
+    if (mapped_size_ > 0) {
+        ::munmap(const_cast<char*>(data_), mapped_size_);
+    }
+}
+
+std::string_view FileView::bytes() const {
+    return std::string_view(data_, size_);
+}
+
+bool FileView::isMapped() const {
+    return mapped_size_ > 0;
+}
+
+bool FileView::isTruncated() const {
+    return truncated_;
+}
+
+size_t streamFile(
+    const String& path,
+    size_t offset,
+    size_t length,
+    size_t chunk_bytes,
+    const std::function<bool(std::string_view chunk, size_t offset)>& on_chunk,
+    const FileReadOptions& options
+) {
+    chunk_bytes = std::max<size_t>(chunk_bytes, 1);
+
+    struct stat info;
+    if (::stat(path.c_str(), &info) == 0 && S_ISREG(info.st_mode) &&
+        static_cast<size_t>(info.st_size) < options.mmap_threshold) {
+        // Read one chunk at a time, so neither the whole file nor a mapping is held
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error(errorText("Cannot open", path));
+        }
+        String chunk;
+        size_t pos = offset;
+        size_t end = length > 0 ? offset + length : SIZE_MAX;
+        while (pos < end) {
+            chunk.resize(std::min(chunk_bytes, end - pos));
+            ssize_t count = ::pread(fd, &chunk[0], chunk.size(), static_cast<off_t>(pos));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0) {
+                int error = errno;
+                ::close(fd);
+                throw std::runtime_error("Cannot read " + path + ": " + std::strerror(error));
+            }
+            if (count == 0) {
+                break;
+            }
+            size_t visited = static_cast<size_t>(count);
+            bool more = on_chunk(std::string_view(chunk.data(), visited), pos);
+            pos += visited;
+            if (!more) {
+                break;
+            }
+        }
+        ::close(fd);
+        return pos - offset;
+    }
+
+    FileView view(path, options.mmap_threshold, options.max_read_bytes);
+    std::string_view bytes = view.bytes();
+
+    size_t begin = std::min(offset, bytes.size());
+    size_t end = length > 0 ? std::min(bytes.size(), begin + length) : bytes.size();
+
+    size_t pos = begin;
+    while (pos < end) {
+        size_t size = std::min(chunk_bytes, end - pos);
+        if (!on_chunk(bytes.substr(pos, size), pos)) {
+            pos += size;
+            break;
+        }
+        pos += size;
+    }
+    return pos - begin;
+}
+
+WriteBehindBuffer::WriteBehindBuffer(const WriteBehindOptions& options)
+    : options_(options) {
+    flusher_ = std::thread([this]() { run(); });
+}
+
+WriteBehindBuffer::~WriteBehindBuffer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    flusher_.join();
+    flush();
+}
+
+void WriteBehindBuffer::add(const String& path, const String& directory) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (files_.empty() && directories_.empty()) {
+            oldest_ = std::chrono::steady_clock::now();
+        }
+        files_.insert(path);
+        if (!directory.empty()) {
+            directories_.insert(directory);
+        }
+    }
+    wake_.notify_one();
+}
+
+size_t WriteBehindBuffer::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return files_.size();
+}
+
+WriteBehindBuffer::Stats WriteBehindBuffer::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void WriteBehindBuffer::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (files_.empty() && directories_.empty()) {
+            wake_.wait(lock);
+            continue;
+        }
+
+        auto deadline = oldest_ + options_.max_delay;
+        if (files_.size() < options_.max_pending_files && std::chrono::steady_clock::now() < deadline) {
+            wake_.wait_until(lock, deadline);
+            continue;
+        }
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+size_t WriteBehindBuffer::flush() {
+    std::lock_guard<std::mutex> flush_lock(flush_mutex_);
+
+    std::set<String> files;
+    std::set<String> directories;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        files.swap(files_);
+        directories.swap(directories_);
+    }
+    if (files.empty() && directories.empty()) {
+        return 0;
+    }
+
+    // Group by filesystem; a crowded one is cheaper to sync as a whole
+    std::map<dev_t, std::vector<const String*>> by_device;
+    for (const auto& file : files) {
+        struct stat info;
+        if (::stat(file.c_str(), &info) == 0) {
+            by_device[info.st_dev].push_back(&file);
+        }
+    }
+
+    Stats flushed;
+    std::set<dev_t> synced_devices;
+    for (const auto& [device, paths] : by_device) {
+        if (paths.size() >= options_.syncfs_threshold) {
+            int fd = ::open(paths.front()->c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd >= 0) {
+                ::syncfs(fd);
+                ::close(fd);
+                synced_devices.insert(device);
+                ++flushed.syncfs_calls;
+                flushed.files_synced += paths.size();
+                continue;
+            }
+        }
+        for (const String* path : paths) {
+            syncPath(*path, false);
+            ++flushed.files_synced;
+        }
+    }
+
+    // Directory entries make created and renamed files durable
+    for (const auto& directory : directories) {
+        struct stat info;
+        if (::stat(directory.c_str(), &info) != 0 || synced_devices.count(info.st_dev) > 0) {
+            continue;
+        }
+        syncPath(directory, true);
+        ++flushed.directories_synced;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.flushes;
+    stats_.files_synced += flushed.files_synced;
+    stats_.directories_synced += flushed.directories_synced;
+    stats_.syncfs_calls += flushed.syncfs_calls;
+    return flushed.files_synced;
+}
+
+FileWriteResult writeFile(
+    const String& path,
+    const String& content,
+    bool append,
+    const FileWriteOptions& options
+) {
+    auto start = std::chrono::steady_clock::now();
+    FileWriteResult result;
+    bool defer = options.write_behind != nullptr;
+    bool sync = !defer && options.sync;
+
+    // Write through symlinks rather than replacing them with a regular file
+    String target = path;
+    struct stat info;
+    bool exists = ::stat(path.c_str(), &info) == 0;
+    if (exists && S_ISDIR(info.st_mode)) {
+        throw std::runtime_error(path + " is a directory");
+    }
+    if (exists) {
+        char resolved[PATH_MAX];
+        if (::realpath(path.c_str(), resolved)) {
+            target = resolved;
+        }
+    }
+    String directory = directoryOf(target);
+    bool entry_changed = !exists;
+
+    if (append || !options.atomic) {
+        int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC);
+        int fd = ::open(target.c_str(), flags, 0666);
+        if (fd < 0) {
+            throw std::runtime_error(errorText("Cannot open", target));
+        }
+        try {
+            writeAll(fd, content, target);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        if (sync && ::fdatasync(fd) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot sync " + target + ": " + std::strerror(error));
+        }
+        ::close(fd);
+    } else {
+        static std::atomic<uint64_t> sequence{0};
+        size_t slash = target.find_last_of('/');
+        String name = slash == String::npos ? target : target.substr(slash + 1);
+        String temp = directory + "/." + name + ".tmp." + std::to_string(::getpid()) + "." +
+            std::to_string(sequence++);
+
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+        if (fd < 0) {
+            throw std::runtime_error(errorText("Cannot write", target));
+        }
+        try {
+            if (exists) {
+                ::fchmod(fd, info.st_mode & 07777);
+            }
+            writeAll(fd, content, temp);
+            if (sync && ::fdatasync(fd) != 0) {
+                throw std::runtime_error(errorText("Cannot sync", temp));
+            }
+        } catch (...) {
+            ::close(fd);
+            ::unlink(temp.c_str());
+            throw;
+        }
+        ::close(fd);
+
+        if (::rename(temp.c_str(), target.c_str()) != 0) {
+            String error = errorText("Cannot replace", target);
+            ::unlink(temp.c_str());
+            throw std::runtime_error(error);
+        }
+        entry_changed = true;
+    }
+
+    if (defer) {
+        options.write_behind->add(target, entry_changed ? directory : "");
+        result.deferred = true;
+    } else if (sync) {
+        if (entry_changed) {
+            syncPath(directory, true);
+        }
+        result.synced = true;
+    }
+
+    result.bytes_written = content.size();
+    result.latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+std::shared_ptr<Tool> createFileReadTool() {
+    return createFileReadTool(FileReadOptions());
+}
+
+std::shared_ptr<Tool> createFileReadTool(const FileReadOptions& options) {
+    auto tool = std::make_shared<Tool>("file_read",
+        "Read a file from the filesystem. Select lines with start_line/end_line or tail_lines and bytes "
+        "with offset/length; large selections are cut to their head and tail. With stream set, one "
+        "chunk is returned per call and reading continues from next_offset.");
+
+    Parameter path;
+    path.name = "path";
+    path.description = "The path to the file to read";
+    path.type = "string";
+    path.required = true;
+
+    Parameter stream;
+    stream.name = "stream";
+    stream.description = "Return the selection one chunk at a time";
+    stream.type = "boolean";
+    stream.required = false;
+
+    tool->addParameter(path);
+    tool->addParameter(sizeParameter("start_line", "First line to read, starting at 1", 1));
+    tool->addParameter(sizeParameter("end_line", "Last line to read, inclusive", 1));
+    tool->addParameter(sizeParameter("tail_lines", "Read only this many lines from the end", 1));
+    tool->addParameter(sizeParameter("offset", "First byte to read", 0));
+    tool->addParameter(sizeParameter("length", "Maximum number of bytes to read", 0));
+    tool->addParameter(sizeParameter("max_bytes", "Cap on the returned content in bytes", 1));
+    tool->addParameter(stream);
+
+    tool->setCallback([options](const JsonObject& params) {
+        try {
+            return readFile(options, params);
+        } catch (const std::exception& e) {
+            ToolResult result;
+            result.success = false;
+            result.content = e.what();
+            return result;
+        }
+    });
+
+    if (options.cache_ttl.count() > 0) {
+        tool->setCacheable(true, options.cache_ttl);
+    }
+
+    return tool;
+}
+
+std::shared_ptr<Tool> createFileWriteTool() {
+    return createFileWriteTool(FileWriteOptions());
+}
+
+std::shared_ptr<Tool> createFileWriteTool(const FileWriteOptions& options) {
+    auto tool = std::make_shared<Tool>("file_write",
+        "Write to a file in the filesystem, replacing it or appending to it");
+
+    Parameter path;
+    path.name = "path";
+    path.description = "The path to the file to write";
+    path.type = "string";
+    path.required = true;
+
+    Parameter content;
+    content.name = "content";
+    content.description = "The content to write to the file";
+    content.type = "string";
+    content.required = true;
+
+    Parameter mode;
+    mode.name = "mode";
+    mode.description = "overwrite replaces the file, append adds to its end";
+    mode.type = "string";
+    mode.required = false;
+    mode.default_value = "overwrite";
+    mode.constraints = {{"enum", {"overwrite", "append"}}};
+
+    tool->addParameter(path);
+    tool->addParameter(content);
+    tool->addParameter(mode);
+
+    tool->setCallback([options](const JsonObject& params) {
+        try {
+            return writeFileTool(options, params);
+        } catch (const std::exception& e) {
+            ToolResult result;
+            result.success = false;
+            result.content = e.what();
+            return result;
+        }
+    });
+
+    // Writes make cached reads stale
+    tool->setInvalidates({"file_read"});
+
+    // Keep the order of the writes the LLM asked for, e.g. an overwrite followed by appends
+    tool->setSerialOnly(true);
+
+    if (auto buffer = options.write_behind) {
+        tool->setFlushCallback([buffer]() { buffer->flush(); });
+    }
+
+    return tool;
+}
+
+} // namespace tools
+} // namespace agents
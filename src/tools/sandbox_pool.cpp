@@ -0,0 +1,674 @@
+#include <agents-cpp/tools/sandbox_pool.h>
+#include <agents-cpp/coroutine_utils.h>
+#include <agents-cpp/logger.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace agents {
+namespace tools {
+
+namespace {
+
+// Reads "<length>\n<script>" frames from fd 3 and answers "<exit code>\n" on fd 4. Lengths
+// are in bytes, so frames are read in the C locale; jobs get the caller's locale back.
+const char* kShellDriver = R"(__agents_lc_all=${LC_ALL-__agents_unset__}
+LC_ALL=C
+while IFS= read -r -u 3 __agents_len; do
+    __agents_job=
+    if [ "$__agents_len" -gt 0 ]; then
+        IFS= read -r -N "$__agents_len" -u 3 __agents_job || break
+    fi
+    (
+        if [ "$__agents_lc_all" = __agents_unset__ ]; then unset LC_ALL; else LC_ALL=$__agents_lc_all; fi
+        if [ "$__agents_cpu" -gt 0 ]; then ulimit -S -t "$__agents_cpu" 2>/dev/null; fi
+        eval "$__agents_job"
+    ) </dev/null 3<&- 4<&-
+    printf '%d\n' "$?" >&4
+done
+)";
+
+// Same protocol; code runs with fresh globals, imported modules stay warm across jobs. The
+// CPU limit is moved forward before each job since the interpreter's usage accumulates.
+const char* kPythonDriver = R"(import os, sys, traceback, resource
+def _agents_main(cpu):
+    os.set_inheritable(3, False)
+    os.set_inheritable(4, False)
+    requests = os.fdopen(3, 'rb')
+    status = os.fdopen(4, 'w')
+    while True:
+        line = requests.readline()
+        if not line:
+            return
+        size = int(line)
+        source = requests.read(size) if size > 0 else b''
+        if len(source) < size:
+            return
+        if cpu > 0:
+            usage = resource.getrusage(resource.RUSAGE_SELF)
+            hard = resource.getrlimit(resource.RLIMIT_CPU)[1]
+            soft = int(usage.ru_utime + usage.ru_stime) + cpu
+            if hard != resource.RLIM_INFINITY:
+                soft = min(soft, hard)
+            resource.setrlimit(resource.RLIMIT_CPU, (soft, hard))
+        code = 0
+        try:
+            exec(compile(source, '<tool>', 'exec'), {'__name__': '__main__', '__builtins__': __builtins__})
+        except SystemExit as e:
+            code = e.code if isinstance(e.code, int) else (0 if e.code is None else 1)
+        except BaseException:
+            traceback.print_exc()
+            code = 1
+        sys.stdout.flush()
+        sys.stderr.flush()
+        status.write('%d\n' % code)
+        status.flush()
+_agents_main(int(sys.argv[1]))
+)";
+
+// Variables passed through to workers when the environment is not inherited
+const char* kPassedEnvironment[] = {"PATH", "HOME", "LANG", "LC_ALL", "TMPDIR", "TERM"};
+
+constexpr std::chrono::milliseconds kPollSlice{50};
+constexpr size_t kReadChunk = 64 * 1024;
+
+void closeFd(int& fd) {
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+// Write everything, without letting a dead reader raise SIGPIPE in the process
+bool writeAll(int fd, const String& data) {
+    sigset_t pipe_set;
+    sigset_t previous;
+    sigemptyset(&pipe_set);
+    sigaddset(&pipe_set, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipe_set, &previous);
+
+    bool ok = true;
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t written = ::write(fd, data.data() + offset, data.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ok = false;
+            break;
+        }
+        offset += static_cast<size_t>(written);
+    }
+
+    if (!ok && errno == EPIPE && !sigismember(&previous, SIGPIPE)) {
+        // Consume the SIGPIPE queued for this thread before unblocking it
+        struct timespec zero = {0, 0};
+        while (sigtimedwait(&pipe_set, nullptr, &zero) == SIGPIPE) {
+        }
+    }
+
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+    return ok;
+}
+
+bool writeFile(const String& path, const String& content) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size());
+    ::close(fd);
+    return ok;
+}
+
+void setLimit(int resource, size_t value) {
+    if (value == 0) {
+        return;
+    }
+    struct rlimit limit;
+    limit.rlim_cur = static_cast<rlim_t>(value);
+    limit.rlim_max = static_cast<rlim_t>(value);
+    ::setrlimit(resource, &limit);
+}
+
+int exitCodeOf(int status) {
+    if (WIFEXITED(status)) {
+        return WEXITSTATUS(status);
+    }
+    if (WIFSIGNALED(status)) {
+        return 128 + WTERMSIG(status);
+    }
+    return -1;
+}
+
+} // namespace
+
+SandboxPool::SandboxPool(const SandboxPoolOptions& options)
+    : options_(options) {
+    options_.pool_size = std::max<size_t>(options_.pool_size, 1);
+
+    String cpu = std::to_string(options_.cpu_seconds);
+    if (options_.language == SandboxLanguage::SHELL) {
+        String interpreter = options_.interpreter.empty() ? "bash" : options_.interpreter;
+        String driver = "__agents_cpu=" + cpu + "\n" + kShellDriver;
+        argv_ = {interpreter, "--noprofile", "--norc", "-c", driver, "agents-sandbox"};
+    } else {
+        String interpreter = options_.interpreter.empty() ? "python3" : options_.interpreter;
+        argv_ = {interpreter, "-u", "-c", kPythonDriver, cpu};
+    }
+
+    if (!options_.inherit_environment) {
+        for (const char* name : kPassedEnvironment) {
+            if (const char* value = std::getenv(name)) {
+                environment_.push_back(String(name) + "=" + value);
+            }
+        }
+    }
+
+    // Pre-fork the whole pool so the first calls are as fast as later ones
+    std::vector<std::unique_ptr<Worker>> workers;
+    try {
+        for (size_t i = 0; i < options_.pool_size; ++i) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ++alive_;
+            }
+            workers.push_back(spawn());
+        }
+    } catch (...) {
+        for (auto& worker : workers) {
+            destroy(std::move(worker));
+        }
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& worker : workers) {
+        idle_.push_back(std::move(worker));
+    }
+}
+
+SandboxPool::~SandboxPool() {
+    shutdown();
+}
+
+std::shared_ptr<SandboxPool> SandboxPool::shell() {
+    static std::shared_ptr<SandboxPool> pool = std::make_shared<SandboxPool>();
+    return pool;
+}
+
+std::shared_ptr<SandboxPool> SandboxPool::python() {
+    static std::shared_ptr<SandboxPool> pool = [] {
+        SandboxPoolOptions options;
+        options.language = SandboxLanguage::PYTHON;
+        return std::make_shared<SandboxPool>(options);
+    }();
+    return pool;
+}
+
+const SandboxPoolOptions& SandboxPool::getOptions() const {
+    return options_;
+}
+
+size_t SandboxPool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return alive_;
+}
+
+size_t SandboxPool::spawned() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return spawned_;
+}
+
+void SandboxPool::shutdown() {
+    std::deque<std::unique_ptr<Worker>> idle;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        shutdown_ = true;
+
+        // A replacement being started in the background must land (and be destroyed) first
+        idle_cv_.wait(lock, [this] { return !replenishing_; });
+        idle.swap(idle_);
+    }
+    idle_cv_.notify_all();
+
+    for (auto& worker : idle) {
+        destroy(std::move(worker));
+    }
+}
+
+std::unique_ptr<SandboxPool::Worker> SandboxPool::spawn() {
+    auto worker = std::make_unique<Worker>();
+
+    size_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = spawned_++;
+    }
+
+    int request_pipe[2] = {-1, -1};
+    int status_pipe[2] = {-1, -1};
+    int stdout_pipe[2] = {-1, -1};
+    int stderr_pipe[2] = {-1, -1};
+    int devnull = -1;
+    int cgroup_procs = -1;
+
+    auto fail = [&](const String& what) {
+        int error = errno;
+        for (int* pipe_fds : {request_pipe, status_pipe, stdout_pipe, stderr_pipe}) {
+            closeFd(pipe_fds[0]);
+            closeFd(pipe_fds[1]);
+        }
+        closeFd(devnull);
+        closeFd(cgroup_procs);
+        if (!worker->cgroup.empty()) {
+            ::rmdir(worker->cgroup.c_str());
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --alive_;
+        }
+        idle_cv_.notify_one();
+        throw std::runtime_error("Failed to start sandbox worker: " + what + ": " + std::strerror(error));
+    };
+
+    if (::pipe2(request_pipe, O_CLOEXEC) != 0 || ::pipe2(status_pipe, O_CLOEXEC) != 0 ||
+        ::pipe2(stdout_pipe, O_CLOEXEC) != 0 || ::pipe2(stderr_pipe, O_CLOEXEC) != 0) {
+        fail("pipe");
+    }
+    devnull = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    if (devnull < 0) {
+        fail("/dev/null");
+    }
+
+    // A cgroup per worker also catches processes that escape the process group
+    if (!options_.cgroup_root.empty()) {
+        String cgroup = options_.cgroup_root + "/agents-sandbox-" +
+            std::to_string(::getpid()) + "-" + std::to_string(sequence);
+        if (::mkdir(cgroup.c_str(), 0755) == 0) {
+            worker->cgroup = cgroup;
+            if (options_.memory_bytes > 0) {
+                writeFile(cgroup + "/memory.max", std::to_string(options_.memory_bytes));
+            }
+            if (options_.max_processes > 0) {
+                writeFile(cgroup + "/pids.max", std::to_string(options_.max_processes));
+            }
+            cgroup_procs = ::open((cgroup + "/cgroup.procs").c_str(), O_WRONLY | O_CLOEXEC);
+        } else {
+            Logger::debug("Sandbox cgroup unavailable under {}: {}", options_.cgroup_root, std::strerror(errno));
+        }
+    }
+
+    // Everything the child needs is prepared up front: after fork it may only make async-signal-safe calls
+    std::vector<char*> argv;
+    for (auto& arg : argv_) {
+        argv.push_back(const_cast<char*>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    std::vector<char*> envp;
+    for (auto& entry : environment_) {
+        envp.push_back(const_cast<char*>(entry.c_str()));
+    }
+    envp.push_back(nullptr);
+
+    const char* directory = options_.working_directory.empty() ? nullptr : options_.working_directory.c_str();
+
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        fail("fork");
+    }
+
+    if (pid == 0) {
+        ::setpgid(0, 0);
+        if (cgroup_procs >= 0) {
+            ::write(cgroup_procs, "0", 1);
+        }
+
+        // Move the ends we keep above the target slots first so dup2 cannot clobber them.
+        // The copies are close-on-exec, and dup2 clears the flag on fds 0-4 only, so jobs
+        // started by the worker cannot reach the status or request pipes through them.
+        int sources[5] = {devnull, stdout_pipe[1], stderr_pipe[1], request_pipe[0], status_pipe[1]};
+        for (int& fd : sources) {
+            fd = ::fcntl(fd, F_DUPFD_CLOEXEC, 5);
+            if (fd < 0) {
+                ::_exit(127);
+            }
+        }
+        for (int target = 0; target < 5; ++target) {
+            if (::dup2(sources[target], target) < 0) {
+                ::_exit(127);
+            }
+        }
+
+        setLimit(RLIMIT_AS, options_.memory_bytes);
+        setLimit(RLIMIT_FSIZE, options_.max_file_size);
+        setLimit(RLIMIT_NOFILE, options_.max_open_files);
+        setLimit(RLIMIT_NPROC, options_.max_processes);
+
+        if (directory && ::chdir(directory) != 0) {
+            ::_exit(127);
+        }
+
+        if (options_.inherit_environment) {
+            ::execvp(argv[0], argv.data());
+        } else {
+            ::execvpe(argv[0], argv.data(), envp.data());
+        }
+        ::_exit(127);
+    }
+
+    ::setpgid(pid, pid);
+    closeFd(request_pipe[0]);
+    closeFd(status_pipe[1]);
+    closeFd(stdout_pipe[1]);
+    closeFd(stderr_pipe[1]);
+    closeFd(devnull);
+    closeFd(cgroup_procs);
+
+    worker->pid = pid;
+    worker->request_fd = request_pipe[1];
+    worker->status_fd = status_pipe[0];
+    worker->stdout_fd = stdout_pipe[0];
+    worker->stderr_fd = stderr_pipe[0];
+    for (int fd : {worker->status_fd, worker->stdout_fd, worker->stderr_fd}) {
+        ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+
+    Logger::debug("Started sandbox worker {} ({})", pid, argv_[0]);
+    return worker;
+}
+
+void SandboxPool::destroy(std::unique_ptr<Worker> worker) {
+    if (!worker) {
+        return;
+    }
+
+    closeFd(worker->request_fd);
+    closeFd(worker->status_fd);
+    closeFd(worker->stdout_fd);
+    closeFd(worker->stderr_fd);
+
+    if (worker->pid > 0) {
+        ::kill(-worker->pid, SIGKILL);
+        ::waitpid(worker->pid, nullptr, 0);
+    }
+
+    if (!worker->cgroup.empty()) {
+        writeFile(worker->cgroup + "/cgroup.kill", "1");
+        ::rmdir(worker->cgroup.c_str());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --alive_;
+    }
+    idle_cv_.notify_one();
+}
+
+std::unique_ptr<SandboxPool::Worker> SandboxPool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        if (shutdown_) {
+            throw std::runtime_error("Sandbox pool is shut down");
+        }
+        if (!idle_.empty()) {
+            auto worker = std::move(idle_.front());
+            idle_.pop_front();
+            return worker;
+        }
+        if (alive_ < options_.pool_size) {
+            ++alive_;
+            lock.unlock();
+            return spawn();
+        }
+        if (currentCancellationToken().isCancellationRequested()) {
+            return nullptr;
+        }
+        idle_cv_.wait_for(lock, kPollSlice);
+    }
+}
+
+void SandboxPool::release(std::unique_ptr<Worker> worker) {
+    ++worker->jobs;
+
+    bool recycle = options_.max_jobs_per_worker > 0 && worker->jobs >= options_.max_jobs_per_worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!recycle && !shutdown_) {
+            idle_.push_back(std::move(worker));
+        }
+    }
+
+    if (worker) {
+        destroy(std::move(worker));
+    } else {
+        idle_cv_.notify_one();
+    }
+}
+
+void SandboxPool::scheduleReplenish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shutdown_ || replenishing_ || alive_ >= options_.pool_size) {
+            return;
+        }
+        replenishing_ = true;
+    }
+
+    // Forking is slow, so replacements start in the background rather than on the caller's job
+    getBlockingExecutor()->add([this] {
+        while (replenish()) {
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            replenishing_ = false;
+        }
+        idle_cv_.notify_all();
+    });
+}
+
+bool SandboxPool::replenish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (shutdown_ || alive_ >= options_.pool_size) {
+            return false;
+        }
+        ++alive_;
+    }
+
+    std::unique_ptr<Worker> worker;
+    try {
+        worker = spawn();
+    } catch (const std::exception& e) {
+        Logger::warn("Failed to replace sandbox worker: {}", e.what());
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!shutdown_) {
+            idle_.push_back(std::move(worker));
+        }
+    }
+
+    if (worker) {
+        destroy(std::move(worker));
+        return false;
+    }
+    idle_cv_.notify_one();
+    return true;
+}
+
+SandboxResult SandboxPool::run(
+    const String& source,
+    const SandboxOutputCallback& on_output,
+    std::chrono::milliseconds timeout
+) {
+    SandboxResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    while (true) {
+        auto worker = acquire();
+        if (!worker) {
+            result.cancelled = true;
+            break;
+        }
+
+        // Idle workers can die underneath us (killed externally, or a stray background job)
+        int status = 0;
+        if (::waitpid(worker->pid, &status, WNOHANG) == worker->pid) {
+            worker->pid = -1;
+            destroy(std::move(worker));
+            continue;
+        }
+
+        if (execute(*worker, source, on_output, timeout, result)) {
+            release(std::move(worker));
+        } else {
+            destroy(std::move(worker));
+        }
+        break;
+    }
+
+    result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    // Replacements start now rather than on the next call, which would pay their startup
+    scheduleReplenish();
+    return result;
+}
+
+bool SandboxPool::execute(
+    Worker& worker,
+    const String& source,
+    const SandboxOutputCallback& on_output,
+    std::chrono::milliseconds timeout,
+    SandboxResult& result
+) {
+    if (timeout.count() <= 0) {
+        timeout = options_.job_timeout;
+    }
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    if (!writeAll(worker.request_fd, std::to_string(source.size()) + "\n" + source)) {
+        result.stderr_output = "Sandbox worker is not accepting jobs";
+        return false;
+    }
+
+    // Read whatever a stream has buffered; returns false once it reaches end of file
+    char buffer[kReadChunk];
+    auto drain = [&](int fd, bool is_stderr) {
+        String& output = is_stderr ? result.stderr_output : result.stdout_output;
+        while (true) {
+            ssize_t count = ::read(fd, buffer, sizeof(buffer));
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return count < 0;
+            }
+
+            String chunk(buffer, static_cast<size_t>(count));
+            size_t room = options_.max_output_bytes - std::min(output.size(), options_.max_output_bytes);
+            if (chunk.size() > room) {
+                result.truncated = true;
+            }
+            output.append(chunk, 0, std::min(room, chunk.size()));
+            if (on_output) {
+                on_output(is_stderr, chunk);
+            }
+        }
+    };
+
+    struct pollfd fds[3] = {
+        {worker.stdout_fd, POLLIN, 0},
+        {worker.stderr_fd, POLLIN, 0},
+        {worker.status_fd, POLLIN, 0}
+    };
+    String status_line;
+
+    while (true) {
+        if (currentCancellationToken().isCancellationRequested()) {
+            result.cancelled = true;
+            return false;
+        }
+
+        auto wait = kPollSlice;
+        if (timeout.count() > 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                result.timed_out = true;
+                return false;
+            }
+            wait = std::min(wait, remaining);
+        }
+
+        int ready = ::poll(fds, 3, static_cast<int>(wait.count()));
+        if (ready < 0 && errno != EINTR) {
+            result.stderr_output += "Failed to wait for sandbox worker: " + String(std::strerror(errno));
+            return false;
+        }
+        if (ready <= 0) {
+            continue;
+        }
+
+        for (int i = 0; i < 2; ++i) {
+            if (fds[i].fd >= 0 && fds[i].revents != 0 && !drain(fds[i].fd, i == 1)) {
+                fds[i].fd = -1;
+            }
+        }
+
+        if (fds[2].revents == 0) {
+            continue;
+        }
+
+        ssize_t count;
+        while ((count = ::read(worker.status_fd, buffer, sizeof(buffer))) > 0) {
+            status_line.append(buffer, static_cast<size_t>(count));
+        }
+
+        size_t newline = status_line.find('\n');
+        if (newline != String::npos) {
+            // The worker flushes output before reporting, so it is all buffered by now
+            for (int i = 0; i < 2; ++i) {
+                if (fds[i].fd >= 0) {
+                    drain(fds[i].fd, i == 1);
+                }
+            }
+            result.exit_code = std::atoi(status_line.c_str());
+            return true;
+        }
+
+        if (count == 0) {
+            // The interpreter itself died, e.g. from a resource limit or an explicit exit
+            for (int i = 0; i < 2; ++i) {
+                if (fds[i].fd >= 0) {
+                    drain(fds[i].fd, i == 1);
+                }
+            }
+            int status = 0;
+            ::kill(-worker.pid, SIGKILL);
+            if (::waitpid(worker.pid, &status, 0) == worker.pid) {
+                result.exit_code = exitCodeOf(status);
+                worker.pid = -1;
+            }
+            return false;
+        }
+    }
+}
+
+} // namespace tools
+} // namespace agents
@@ -0,0 +1,949 @@
+#include <agents-cpp/tools/search_index.h>
+#include <agents-cpp/tools/file_tool.h>
+#include <agents-cpp/logger.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace agents {
+namespace tools {
+
+struct SearchIndex::Header {
+    char magic[8];
+    uint64_t document_count;
+    uint64_t term_count;
+    double average_length;
+    uint64_t postings_offset;
+    uint64_t terms_offset;
+    uint64_t term_text_offset;
+    uint64_t documents_offset;
+    uint64_t store_offset;
+    uint64_t file_size;
+};
+
+struct SearchIndex::TermEntry {
+    uint64_t postings_offset;       // Relative to the postings section
+    uint32_t postings_bytes;
+    uint32_t document_frequency;
+    uint32_t text_offset;           // Relative to the term text section
+    uint32_t text_length;
+};
+
+struct SearchIndex::DocumentEntry {
+    uint64_t store_offset;          // Title, url and text, back to back
+    uint64_t text_length;
+    uint32_t title_length;
+    uint32_t url_length;
+    uint32_t token_count;
+    uint32_t reserved;
+};
+
+namespace {
+
+constexpr char kMagic[8] = {'A', 'G', 'S', 'I', 'D', 'X', '0', '1'};
+
+// Longer tokens are usually base64, hashes or markup and are not indexed
+constexpr size_t kMaxTokenLength = 64;
+
+// Title terms count this many times, a cheap field boost
+constexpr uint32_t kTitleWeight = 2;
+
+// Snippet window and the text scanned to place it
+constexpr size_t kSnippetBytes = 240;
+constexpr size_t kSnippetScanBytes = 1024 * 1024;
+
+bool isWordByte(unsigned char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+
+// Calls f(token, begin, end) for each lowercased word; non-ASCII bytes are kept as word characters
+template <typename F>
+void forEachToken(std::string_view text, F&& f) {
+    String token;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isWordByte(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        size_t begin = i;
+        token.clear();
+        while (i < text.size() && isWordByte(static_cast<unsigned char>(text[i]))) {
+            char c = text[i++];
+            token.push_back(c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c);
+        }
+        if (!token.empty() && token.size() <= kMaxTokenLength) {
+            f(token, begin, i);
+        }
+    }
+}
+
+void putVarint(String& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+// Decode a varint without reading at or past end; a truncated one decodes what is there
+uint64_t getVarint(const uint8_t*& p, const uint8_t* end) {
+    uint64_t value = 0;
+    int shift = 0;
+    while (p < end && (*p & 0x80) && shift < 63) {
+        value |= static_cast<uint64_t>(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    if (p < end) {
+        value |= static_cast<uint64_t>(*p++ & 0x7F) << shift;
+    }
+    return value;
+}
+
+bool readVarint(std::istream& in, uint64_t& value) {
+    value = 0;
+    int shift = 0;
+    int c;
+    while ((c = in.get()) != EOF) {
+        value |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) {
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+// Whether [offset, offset + length) lies within [0, limit), without overflowing
+bool within(uint64_t offset, uint64_t length, uint64_t limit) {
+    return offset <= limit && length <= limit - offset;
+}
+
+void writeBytes(std::ofstream& out, const void* data, size_t size) {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+}
+
+void padTo8(std::ofstream& out, uint64_t& offset) {
+    static const char zeros[8] = {};
+    size_t padding = (8 - offset % 8) % 8;
+    writeBytes(out, zeros, padding);
+    offset += padding;
+}
+
+String lowerExtension(const std::filesystem::path& path) {
+    String extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    return extension;
+}
+
+bool hasExtension(const std::filesystem::path& path, const std::vector<String>& extensions) {
+    String extension = lowerExtension(path);
+    return std::find(extensions.begin(), extensions.end(), extension) != extensions.end();
+}
+
+// Whether a document opens with <!DOCTYPE html> or <html>, in any case
+bool looksLikeHtml(std::string_view bytes) {
+    size_t start = 0;
+    while (start < bytes.size() && start < 64 && std::isspace(static_cast<unsigned char>(bytes[start]))) {
+        ++start;
+    }
+    String head(bytes.substr(start, 14));
+    std::transform(head.begin(), head.end(), head.begin(), ::tolower);
+    return head.compare(0, 14, "<!doctype html") == 0 || head.compare(0, 5, "<html") == 0;
+}
+
+// Crude markup removal for HTML files; picks up the <title> if there is one
+String stripHtml(std::string_view html, String& title) {
+    String text;
+    text.reserve(html.size() / 2);
+
+    size_t i = 0;
+    while (i < html.size()) {
+        if (html[i] == '<') {
+            size_t close = html.find('>', i);
+            if (close == std::string_view::npos) {
+                break;
+            }
+            std::string_view tag = html.substr(i + 1, close - i - 1);
+            String name;
+            for (char c : tag.substr(0, 8)) {
+                if (!std::isalpha(static_cast<unsigned char>(c))) {
+                    break;
+                }
+                name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+            }
+
+            // Skip the contents of elements that are not text
+            if (name == "script" || name == "style" || name == "title") {
+                String end_tag = "</" + name;
+                size_t end = i;
+                while ((end = html.find("</", end + 1)) != std::string_view::npos) {
+                    String candidate(html.substr(end, end_tag.size()));
+                    std::transform(candidate.begin(), candidate.end(), candidate.begin(), ::tolower);
+                    if (candidate == end_tag) {
+                        break;
+                    }
+                }
+                if (name == "title" && end != std::string_view::npos && title.empty()) {
+                    title = String(html.substr(close + 1, end - close - 1));
+                }
+                close = end == std::string_view::npos ? html.size() : html.find('>', end);
+                if (close == std::string_view::npos) {
+                    break;
+                }
+            }
+            text.push_back(' ');
+            i = close + 1;
+        } else if (html[i] == '&') {
+            static const std::pair<const char*, char> kEntities[] = {
+                {"&amp;", '&'}, {"&lt;", '<'}, {"&gt;", '>'}, {"&quot;", '"'}, {"&#39;", '\''}, {"&nbsp;", ' '}
+            };
+            bool decoded = false;
+            for (const auto& [entity, c] : kEntities) {
+                size_t length = std::strlen(entity);
+                if (html.compare(i, length, entity) == 0) {
+                    text.push_back(c);
+                    i += length;
+                    decoded = true;
+                    break;
+                }
+            }
+            if (!decoded) {
+                text.push_back(html[i++]);
+            }
+        } else {
+            text.push_back(html[i++]);
+        }
+    }
+    return text;
+}
+
+struct Posting {
+    uint32_t document;
+    uint32_t frequency;
+};
+
+// Rough heap cost of a term in a build thread's postings map, beyond its postings
+constexpr size_t kTermOverheadBytes = 96;
+
+// Build threads never spill runs smaller than this
+constexpr size_t kMinRunBytes = 1024 * 1024;
+
+/**
+ * @brief Write postings to a run file, sorted by term
+ *
+ * Each record is the term, its document count and its postings, with
+ * documents delta encoded from the start of the record.
+ */
+void writeRun(const String& path, std::unordered_map<String, std::vector<Posting>>& postings) {
+    std::vector<std::pair<const String*, std::vector<Posting>*>> terms;
+    terms.reserve(postings.size());
+    for (auto& entry : postings) {
+        terms.emplace_back(&entry.first, &entry.second);
+    }
+    std::sort(terms.begin(), terms.end(), [](const auto& a, const auto& b) {
+        return *a.first < *b.first;
+    });
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to create " + path);
+    }
+    String record;
+    for (const auto& [term, list] : terms) {
+        record.clear();
+        putVarint(record, term->size());
+        record += *term;
+        putVarint(record, list->size());
+        uint32_t previous = 0;
+        for (const auto& posting : *list) {
+            putVarint(record, posting.document - previous);
+            putVarint(record, posting.frequency);
+            previous = posting.document;
+        }
+        writeBytes(out, record.data(), record.size());
+    }
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write " + path);
+    }
+    postings.clear();
+}
+
+/**
+ * @brief Reads a run file written by writeRun() one term at a time
+ */
+class RunReader {
+public:
+    explicit RunReader(const String& path)
+        : path_(path), in_(path, std::ios::binary) {
+        if (!in_) {
+            throw std::runtime_error("Failed to open " + path);
+        }
+    }
+
+    // Read the next term and its postings; false at the end of the run
+    bool next() {
+        uint64_t length;
+        if (!readVarint(in_, length)) {
+            return false;
+        }
+        term_.resize(length);
+        in_.read(&term_[0], static_cast<std::streamsize>(length));
+
+        uint64_t count = 0;
+        readVarint(in_, count);
+        postings_.resize(count);
+        uint32_t document = 0;
+        for (auto& posting : postings_) {
+            uint64_t delta = 0;
+            uint64_t frequency = 0;
+            readVarint(in_, delta);
+            readVarint(in_, frequency);
+            document += static_cast<uint32_t>(delta);
+            posting = {document, static_cast<uint32_t>(frequency)};
+        }
+
+        if (!in_) {
+            throw std::runtime_error("Truncated postings run " + path_);
+        }
+        return true;
+    }
+
+    const String& term() const {
+        return term_;
+    }
+
+    const std::vector<Posting>& postings() const {
+        return postings_;
+    }
+
+private:
+    String path_;
+    std::ifstream in_;
+    String term_;
+    std::vector<Posting> postings_;
+};
+
+// Removes the run files of a build, whether or not it succeeded
+struct RunFiles {
+    std::vector<String> paths;
+
+    ~RunFiles() {
+        for (const auto& path : paths) {
+            std::remove(path.c_str());
+        }
+    }
+};
+
+} // namespace
+
+SearchIndexBuilder::SearchIndexBuilder(const String& index_path, const SearchIndexBuildOptions& options)
+    : index_path_(index_path), spool_path_(index_path + ".spool"), options_(options) {
+    spool_.open(spool_path_, std::ios::binary | std::ios::trunc);
+    if (!spool_) {
+        throw std::runtime_error("Failed to create " + spool_path_);
+    }
+}
+
+SearchIndexBuilder::~SearchIndexBuilder() {
+    if (spool_.is_open()) {
+        spool_.close();
+    }
+    std::remove(spool_path_.c_str());
+}
+
+void SearchIndexBuilder::addDocument(const SearchDocument& document) {
+    // Stored text is valid UTF-8, so snippets and titles always serialize to JSON
+    String title;
+    String url;
+    String text;
+    appendValidUtf8(title, document.title);
+    appendValidUtf8(url, document.url);
+    appendValidUtf8(text, std::string_view(document.text).substr(0, options_.max_document_bytes));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (finished_) {
+        throw std::logic_error("Search index has already been written");
+    }
+
+    StoredDocument stored;
+    stored.offset = spool_size_;
+    stored.title_length = static_cast<uint32_t>(title.size());
+    stored.url_length = static_cast<uint32_t>(url.size());
+    stored.text_length = text.size();
+
+    spool_ << title << url << text;
+    if (!spool_) {
+        throw std::runtime_error("Failed to write " + spool_path_);
+    }
+    spool_size_ += title.size() + url.size() + text.size();
+    documents_.push_back(stored);
+}
+
+size_t SearchIndexBuilder::addDirectory(const String& path) {
+    namespace fs = std::filesystem;
+
+    size_t added = 0;
+    auto iterator = fs::recursive_directory_iterator(path, fs::directory_options::skip_permission_denied);
+    for (const auto& entry : iterator) {
+        std::error_code error;
+        if (!entry.is_regular_file(error) || !hasExtension(entry.path(), options_.extensions)) {
+            continue;
+        }
+
+        try {
+            // Source files may change while they are indexed, so they are read rather than mapped.
+            // Markup is stripped from HTML, so only plain text can be cut off before reading.
+            String extension = lowerExtension(entry.path());
+            bool html = extension == ".html" || extension == ".htm";
+            FileView view(entry.path().string(), SIZE_MAX, html ? SIZE_MAX : options_.max_document_bytes);
+            std::string_view bytes = view.bytes();
+            html = html || looksLikeHtml(bytes);
+
+            SearchDocument document;
+            document.url = "file://" + fs::absolute(entry.path()).string();
+            if (html) {
+                document.text = stripHtml(bytes, document.title);
+            } else {
+                document.text = String(bytes.substr(0, options_.max_document_bytes));
+            }
+            if (document.title.empty()) {
+                document.title = entry.path().stem().string();
+            }
+
+            addDocument(document);
+            ++added;
+        } catch (const std::exception& e) {
+            Logger::warn("Skipping {}: {}", entry.path().string(), e.what());
+        }
+    }
+    return added;
+}
+
+size_t SearchIndexBuilder::addJsonLines(const String& path) {
+    std::ifstream input(path);
+    if (!input) {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    size_t added = 0;
+    String line;
+    while (std::getline(input, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        JsonObject record = JsonObject::parse(line, nullptr, false);
+        if (record.is_discarded() || !record.is_object() || !record.contains("text")) {
+            continue;
+        }
+
+        SearchDocument document;
+        document.title = record.value("title", "");
+        document.url = record.value("url", "");
+        document.text = record["text"].is_string() ? record["text"].get<String>() : record["text"].dump();
+        addDocument(document);
+        ++added;
+    }
+    return added;
+}
+
+size_t SearchIndexBuilder::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return documents_.size();
+}
+
+void SearchIndexBuilder::finish() {
+    using Header = SearchIndex::Header;
+    using TermEntry = SearchIndex::TermEntry;
+    using DocumentEntry = SearchIndex::DocumentEntry;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (finished_) {
+        throw std::logic_error("Search index has already been written");
+    }
+    finished_ = true;
+    spool_.close();
+
+    FileView spool(spool_path_, 0);
+    std::string_view store = spool.bytes();
+    size_t document_count = documents_.size();
+
+    // Tokenize contiguous ranges of documents in parallel. Each thread spills its
+    // postings to a run whenever its share of the memory budget is spent, so runs
+    // in (thread, run) order cover ascending ranges of documents.
+    size_t threads = options_.num_threads > 0 ? options_.num_threads : std::thread::hardware_concurrency();
+    threads = std::max<size_t>(1, std::min(threads, (document_count + 63) / 64));
+    size_t run_budget = std::max(options_.max_postings_memory / threads, kMinRunBytes);
+
+    RunFiles run_files;
+    std::vector<std::vector<String>> thread_runs(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<uint32_t> token_counts(document_count, 0);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            size_t begin = document_count * t / threads;
+            size_t end = document_count * (t + 1) / threads;
+
+            std::unordered_map<String, std::vector<Posting>> postings;
+            std::unordered_map<String, uint32_t> counts;
+            size_t buffered = 0;
+            auto spill = [&]() {
+                String path = index_path_ + ".run" + std::to_string(t) + "." + std::to_string(thread_runs[t].size());
+                thread_runs[t].push_back(path);
+                writeRun(path, postings);
+                buffered = 0;
+            };
+
+            try {
+                for (size_t d = begin; d < end; ++d) {
+                    const StoredDocument& stored = documents_[d];
+                    std::string_view title = store.substr(stored.offset, stored.title_length);
+                    std::string_view text = store.substr(
+                        stored.offset + stored.title_length + stored.url_length, stored.text_length);
+
+                    counts.clear();
+                    uint32_t tokens = 0;
+                    forEachToken(title, [&](const String& token, size_t, size_t) {
+                        counts[token] += kTitleWeight;
+                        tokens += kTitleWeight;
+                    });
+                    forEachToken(text, [&](const String& token, size_t, size_t) {
+                        ++counts[token];
+                        ++tokens;
+                    });
+
+                    token_counts[d] = tokens;
+                    for (const auto& [term, frequency] : counts) {
+                        auto& list = postings[term];
+                        if (list.empty()) {
+                            buffered += term.size() + kTermOverheadBytes;
+                        }
+                        list.push_back({static_cast<uint32_t>(d), frequency});
+                        buffered += sizeof(Posting);
+                    }
+                    if (buffered >= run_budget) {
+                        spill();
+                    }
+                }
+                if (!postings.empty()) {
+                    spill();
+                }
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& runs : thread_runs) {
+        run_files.paths.insert(run_files.paths.end(), runs.begin(), runs.end());
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    String temp_path = index_path_ + ".tmp";
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Failed to create " + temp_path);
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.document_count = document_count;
+    writeBytes(out, &header, sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    // Merge the sorted runs term by term, encoding postings as they are merged.
+    // Only the current term of each run is held in memory.
+    header.postings_offset = offset;
+    std::vector<TermEntry> entries;
+    String term_text;
+    String encoded;
+    std::vector<std::unique_ptr<RunReader>> runs;
+    for (const auto& path : run_files.paths) {
+        runs.push_back(std::make_unique<RunReader>(path));
+    }
+    using Head = std::pair<const String*, size_t>;
+    auto later = [](const Head& a, const Head& b) { return *a.first > *b.first || (*a.first == *b.first && a.second > b.second); };
+    std::priority_queue<Head, std::vector<Head>, decltype(later)> heads(later);
+    for (size_t r = 0; r < runs.size(); ++r) {
+        if (runs[r]->next()) {
+            heads.push({&runs[r]->term(), r});
+        }
+    }
+
+    while (!heads.empty()) {
+        String term = *heads.top().first;
+        TermEntry entry = {};
+        entry.postings_offset = offset - header.postings_offset;
+        entry.text_offset = static_cast<uint32_t>(term_text.size());
+        entry.text_length = static_cast<uint32_t>(term.size());
+        term_text += term;
+
+        encoded.clear();
+        uint32_t previous = 0;
+        bool first = true;
+        // Runs pop in document order for equal terms, so documents stay ascending
+        while (!heads.empty() && *heads.top().first == term) {
+            size_t r = heads.top().second;
+            heads.pop();
+
+            const auto& postings = runs[r]->postings();
+            for (const auto& posting : postings) {
+                putVarint(encoded, first ? posting.document : posting.document - previous);
+                putVarint(encoded, posting.frequency);
+                previous = posting.document;
+                first = false;
+            }
+            entry.document_frequency += static_cast<uint32_t>(postings.size());
+
+            if (runs[r]->next()) {
+                heads.push({&runs[r]->term(), r});
+            }
+        }
+
+        entry.postings_bytes = static_cast<uint32_t>(encoded.size());
+        writeBytes(out, encoded.data(), encoded.size());
+        offset += encoded.size();
+        entries.push_back(entry);
+    }
+    runs.clear();
+
+    padTo8(out, offset);
+    header.terms_offset = offset;
+    header.term_count = entries.size();
+    writeBytes(out, entries.data(), entries.size() * sizeof(TermEntry));
+    offset += entries.size() * sizeof(TermEntry);
+
+    header.term_text_offset = offset;
+    writeBytes(out, term_text.data(), term_text.size());
+    offset += term_text.size();
+
+    padTo8(out, offset);
+    header.documents_offset = offset;
+    uint64_t total_tokens = 0;
+    for (size_t d = 0; d < document_count; ++d) {
+        const StoredDocument& stored = documents_[d];
+        DocumentEntry document = {};
+        document.store_offset = stored.offset;
+        document.text_length = stored.text_length;
+        document.title_length = stored.title_length;
+        document.url_length = stored.url_length;
+        document.token_count = token_counts[d];
+        writeBytes(out, &document, sizeof(document));
+        total_tokens += token_counts[d];
+    }
+    offset += document_count * sizeof(DocumentEntry);
+
+    header.store_offset = offset;
+    writeBytes(out, store.data(), store.size());
+    offset += store.size();
+
+    header.file_size = offset;
+    header.average_length = document_count > 0 ?
+        static_cast<double>(total_tokens) / static_cast<double>(document_count) : 0.0;
+    out.seekp(0);
+    writeBytes(out, &header, sizeof(header));
+    out.close();
+    if (!out) {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("Failed to write " + temp_path);
+    }
+
+    if (std::rename(temp_path.c_str(), index_path_.c_str()) != 0) {
+        std::remove(temp_path.c_str());
+        throw std::runtime_error("Failed to replace " + index_path_);
+    }
+
+    Logger::info("Indexed {} documents, {} terms into {}", document_count, entries.size(), index_path_);
+}
+
+SearchIndex::SearchIndex(const String& index_path)
+    : file_(std::make_unique<FileView>(index_path, 0)) {
+    std::string_view bytes = file_->bytes();
+    if (bytes.size() < sizeof(Header)) {
+        throw std::runtime_error("Not a search index: " + index_path);
+    }
+
+    header_ = reinterpret_cast<const Header*>(bytes.data());
+    const Header& header = *header_;
+    uint64_t size = bytes.size();
+
+    // Sections must follow each other in order, aligned where they hold structs
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.file_size == size &&
+        header.document_count <= UINT32_MAX &&
+        header.postings_offset >= sizeof(Header) && header.postings_offset <= header.terms_offset &&
+        header.terms_offset <= size &&
+        header.terms_offset % 8 == 0 && header.documents_offset % 8 == 0 &&
+        header.term_count <= (size - header.terms_offset) / sizeof(TermEntry) &&
+        header.term_text_offset >= header.terms_offset + header.term_count * sizeof(TermEntry) &&
+        header.term_text_offset <= header.documents_offset &&
+        header.document_count <= (size - std::min(header.documents_offset, size)) / sizeof(DocumentEntry) &&
+        header.store_offset >= header.documents_offset + header.document_count * sizeof(DocumentEntry) &&
+        header.store_offset <= size;
+
+    // Every term and document must point inside its section
+    uint64_t postings_size = valid ? header.terms_offset - header.postings_offset : 0;
+    uint64_t term_text_size = valid ? header.documents_offset - header.term_text_offset : 0;
+    uint64_t store_size = valid ? size - header.store_offset : 0;
+    auto terms = reinterpret_cast<const TermEntry*>(bytes.data() + (valid ? header.terms_offset : 0));
+    for (uint64_t i = 0; valid && i < header.term_count; ++i) {
+        valid = within(terms[i].postings_offset, terms[i].postings_bytes, postings_size) &&
+            within(terms[i].text_offset, terms[i].text_length, term_text_size);
+    }
+    auto documents = reinterpret_cast<const DocumentEntry*>(bytes.data() + (valid ? header.documents_offset : 0));
+    for (uint64_t i = 0; valid && i < header.document_count; ++i) {
+        const DocumentEntry& document = documents[i];
+        uint64_t stored = static_cast<uint64_t>(document.title_length) + document.url_length;
+        valid = within(document.store_offset, stored, store_size) &&
+            within(document.store_offset + stored, document.text_length, store_size);
+    }
+    if (!valid) {
+        throw std::runtime_error("Not a search index or corrupt: " + index_path);
+    }
+
+    terms_ = reinterpret_cast<const TermEntry*>(bytes.data() + header_->terms_offset);
+    term_text_ = bytes.data() + header_->term_text_offset;
+    postings_ = reinterpret_cast<const uint8_t*>(bytes.data() + header_->postings_offset);
+    documents_ = reinterpret_cast<const DocumentEntry*>(bytes.data() + header_->documents_offset);
+    store_ = bytes.data() + header_->store_offset;
+}
+
+SearchIndex::~SearchIndex() = default;
+
+size_t SearchIndex::documentCount() const {
+    return header_->document_count;
+}
+
+size_t SearchIndex::termCount() const {
+    return header_->term_count;
+}
+
+void SearchIndex::setBM25(double k1, double b) {
+    k1_ = k1;
+    b_ = b;
+}
+
+SearchDocument SearchIndex::getDocument(size_t document) const {
+    if (document >= header_->document_count) {
+        throw std::out_of_range("No such document: " + std::to_string(document));
+    }
+
+    const DocumentEntry& entry = documents_[document];
+    const char* base = store_ + entry.store_offset;
+    SearchDocument result;
+    result.title.assign(base, entry.title_length);
+    result.url.assign(base + entry.title_length, entry.url_length);
+    result.text.assign(base + entry.title_length + entry.url_length, entry.text_length);
+    return result;
+}
+
+std::string_view SearchIndex::termText(const TermEntry& entry) const {
+    return std::string_view(term_text_ + entry.text_offset, entry.text_length);
+}
+
+const SearchIndex::TermEntry* SearchIndex::findTerm(std::string_view term) const {
+    const TermEntry* end = terms_ + header_->term_count;
+    const TermEntry* found = std::lower_bound(terms_, end, term, [this](const TermEntry& entry, std::string_view value) {
+        return termText(entry) < value;
+    });
+    return found != end && termText(*found) == term ? found : nullptr;
+}
+
+std::vector<SearchHit> SearchIndex::search(const String& query, size_t top_k) const {
+    std::vector<String> terms;
+    forEachToken(query, [&](const String& token, size_t, size_t) {
+        if (std::find(terms.begin(), terms.end(), token) == terms.end()) {
+            terms.push_back(token);
+        }
+    });
+
+    std::vector<const TermEntry*> entries;
+    for (const auto& term : terms) {
+        if (const TermEntry* entry = findTerm(term)) {
+            entries.push_back(entry);
+        }
+    }
+    if (entries.empty() || top_k == 0) {
+        return {};
+    }
+
+    std::unique_ptr<std::vector<float>> scores;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        if (!buffers_.empty()) {
+            scores = std::move(buffers_.back());
+            buffers_.pop_back();
+        }
+    }
+    if (!scores) {
+        scores = std::make_unique<std::vector<float>>(header_->document_count, 0.0f);
+    }
+
+    // Term at a time BM25 into a dense accumulator, remembering which documents were touched
+    double documents = static_cast<double>(header_->document_count);
+    double average_length = std::max(header_->average_length, 1.0);
+    std::vector<uint32_t> touched;
+    for (const TermEntry* entry : entries) {
+        double frequency = entry->document_frequency;
+        double idf = std::log(1.0 + (documents - frequency + 0.5) / (frequency + 0.5));
+
+        const uint8_t* p = postings_ + entry->postings_offset;
+        const uint8_t* end = p + entry->postings_bytes;
+        uint32_t document = 0;
+        bool first = true;
+        while (p < end) {
+            uint32_t delta = static_cast<uint32_t>(getVarint(p, end));
+            document = first ? delta : document + delta;
+            first = false;
+            double tf = static_cast<double>(getVarint(p, end));
+            if (document >= header_->document_count) {
+                break;
+            }
+
+            double length = documents_[document].token_count;
+            double norm = k1_ * (1.0 - b_ + b_ * length / average_length);
+            float& score = (*scores)[document];
+            if (score == 0.0f) {
+                touched.push_back(document);
+            }
+            score += static_cast<float>(idf * tf * (k1_ + 1.0) / (tf + norm));
+        }
+    }
+
+    // Min-heap of the best k
+    using Scored = std::pair<float, uint32_t>;
+    auto better = [](const Scored& a, const Scored& b) { return a.first > b.first || (a.first == b.first && a.second < b.second); };
+    std::vector<Scored> best;
+    best.reserve(top_k + 1);
+    for (uint32_t document : touched) {
+        Scored scored{(*scores)[document], document};
+        if (best.size() < top_k) {
+            best.push_back(scored);
+            std::push_heap(best.begin(), best.end(), better);
+        } else if (better(scored, best.front())) {
+            std::pop_heap(best.begin(), best.end(), better);
+            best.back() = scored;
+            std::push_heap(best.begin(), best.end(), better);
+        }
+        (*scores)[document] = 0.0f;
+    }
+    std::sort(best.begin(), best.end(), better);
+
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.push_back(std::move(scores));
+    }
+
+    std::vector<SearchHit> hits;
+    hits.reserve(best.size());
+    for (const auto& [score, document] : best) {
+        const DocumentEntry& entry = documents_[document];
+        const char* base = store_ + entry.store_offset;
+
+        SearchHit hit;
+        hit.document = document;
+        hit.score = score;
+        hit.title.assign(base, entry.title_length);
+        hit.url.assign(base + entry.title_length, entry.url_length);
+        hit.snippet = makeSnippet(
+            std::string_view(base + entry.title_length + entry.url_length, entry.text_length), terms);
+        hits.push_back(std::move(hit));
+    }
+    return hits;
+}
+
+String SearchIndex::makeSnippet(std::string_view text, const std::vector<String>& terms) const {
+    // Find the window holding the most distinct query terms, then the most matches
+    struct Match {
+        size_t begin;
+        size_t end;
+        size_t term;
+    };
+    std::vector<Match> matches;
+    forEachToken(text.substr(0, kSnippetScanBytes), [&](const String& token, size_t begin, size_t end) {
+        auto it = std::find(terms.begin(), terms.end(), token);
+        if (it != terms.end()) {
+            matches.push_back({begin, end, static_cast<size_t>(it - terms.begin())});
+        }
+    });
+
+    size_t window_begin = 0;
+    if (!matches.empty()) {
+        std::vector<size_t> counts(terms.size(), 0);
+        size_t distinct = 0;
+        size_t best_distinct = 0;
+        size_t best_matches = 0;
+        size_t left = 0;
+        for (size_t right = 0; right < matches.size(); ++right) {
+            if (counts[matches[right].term]++ == 0) {
+                ++distinct;
+            }
+            while (matches[right].end - matches[left].begin > kSnippetBytes) {
+                if (--counts[matches[left].term] == 0) {
+                    --distinct;
+                }
+                ++left;
+            }
+            size_t in_window = right - left + 1;
+            if (distinct > best_distinct || (distinct == best_distinct && in_window > best_matches)) {
+                best_distinct = distinct;
+                best_matches = in_window;
+                window_begin = matches[left].begin;
+            }
+        }
+        // A little leading context, starting on a word
+        size_t context = std::min<size_t>(window_begin, 40);
+        window_begin -= context;
+        while (window_begin > 0 && isWordByte(static_cast<unsigned char>(text[window_begin - 1])) &&
+               context-- > 0) {
+            ++window_begin;
+        }
+        while (window_begin < text.size() && (static_cast<unsigned char>(text[window_begin]) & 0xC0) == 0x80) {
+            ++window_begin;
+        }
+    }
+
+    size_t window_end = std::min(text.size(), window_begin + kSnippetBytes);
+    while (window_end < text.size() && window_end > window_begin &&
+           (static_cast<unsigned char>(text[window_end]) & 0xC0) == 0x80) {
+        --window_end;
+    }
+
+    String snippet;
+    if (window_begin > 0) {
+        snippet += "...";
+    }
+    bool space = false;
+    for (char c : text.substr(window_begin, window_end - window_begin)) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            space = !snippet.empty();
+            continue;
+        }
+        if (space) {
+            snippet.push_back(' ');
+            space = false;
+        }
+        snippet.push_back(c);
+    }
+    if (window_end < text.size()) {
+        snippet += "...";
+    }
+    return snippet;
+}
+
+} // namespace tools
+} // namespace agents
@@ -0,0 +1,133 @@
+#include <agents-cpp/tools/search_index.h>
+#include <agents-cpp/tools/tool_registry.h>
+#include <agents-cpp/config_loader.h>
+#include <agents-cpp/logger.h>
+#include <map>
+#include <mutex>
+
+namespace agents {
+namespace tools {
+
+namespace {
+
+using IndexProvider = std::function<std::shared_ptr<SearchIndex>()>;
+
+// Index named by a configuration key, opened on first use and kept open
+std::shared_ptr<SearchIndex> configuredIndex(const String& key) {
+    static std::mutex mutex;
+    static std::map<String, std::shared_ptr<SearchIndex>> indexes;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = indexes.find(key);
+    if (it != indexes.end()) {
+        return it->second;
+    }
+
+    String path = ConfigLoader::getInstance().get(key);
+    if (path.empty()) {
+        throw std::runtime_error("No search index configured; set " + key +
+                                 " to an index built with SearchIndexBuilder");
+    }
+
+    auto index = std::make_shared<SearchIndex>(path);
+    Logger::info("Opened search index {} ({} documents)", path, index->documentCount());
+    indexes[key] = index;
+    return index;
+}
+
+std::shared_ptr<Tool> createSearchTool(
+    const String& name,
+    const String& description,
+    const String& query_description,
+    size_t top_k,
+    IndexProvider index
+) {
+    auto tool = std::make_shared<Tool>(name, description);
+
+    Parameter query;
+    query.name = "query";
+    query.description = query_description;
+    query.type = "string";
+    query.required = true;
+
+    Parameter num_results;
+    num_results.name = "num_results";
+    num_results.description = "Number of results to return";
+    num_results.type = "integer";
+    num_results.required = false;
+    num_results.constraints = {{"minimum", 1}, {"maximum", 50}};
+
+    tool->addParameter(query);
+    tool->addParameter(num_results);
+
+    tool->setCallback([index = std::move(index), top_k](const JsonObject& params) {
+        ToolResult result;
+        String text = params["query"].get<String>();
+        try {
+            auto hits = index()->search(text, params.value("num_results", top_k));
+
+            result.success = true;
+            result.data["results"] = JsonObject::array();
+            if (hits.empty()) {
+                result.content = "No results for: " + text;
+            }
+            for (size_t i = 0; i < hits.size(); ++i) {
+                const auto& hit = hits[i];
+                result.content += std::to_string(i + 1) + ". " + hit.title;
+                if (!hit.url.empty()) {
+                    result.content += " (" + hit.url + ")";
+                }
+                result.content += "\n   " + hit.snippet + "\n";
+                result.data["results"].push_back({
+                    {"title", hit.title},
+                    {"url", hit.url},
+                    {"snippet", hit.snippet},
+                    {"score", hit.score}
+                });
+            }
+        } catch (const std::exception& e) {
+            result.success = false;
+            result.content = String("Search failed: ") + e.what();
+        }
+        return result;
+    });
+
+    // Search results are stable enough to reuse within and across sessions
+    tool->setCacheable(true, std::chrono::hours(1));
+
+    return tool;
+}
+
+} // namespace
+
+std::shared_ptr<Tool> createWebSearchTool() {
+    // Answered offline from the index named by WEB_SEARCH_INDEX
+    return createSearchTool("web_search", "Search the web for information", "The search query", 5,
+                            []() { return configuredIndex("WEB_SEARCH_INDEX"); });
+}
+
+std::shared_ptr<Tool> createWebSearchTool(std::shared_ptr<SearchIndex> index, size_t top_k) {
+    if (!index) {
+        throw std::invalid_argument("Search index must not be null");
+    }
+    return createSearchTool("web_search", "Search the web for information", "The search query", top_k,
+                            [index]() { return index; });
+}
+
+std::shared_ptr<Tool> createWikipediaTool() {
+    return createSearchTool("wikipedia", "Search Wikipedia for information",
+                            "The Wikipedia article to search for", 3,
+                            []() { return configuredIndex("WIKIPEDIA_INDEX"); });
+}
+
+std::shared_ptr<Tool> createWikipediaTool(std::shared_ptr<SearchIndex> index, size_t top_k) {
+    if (!index) {
+        throw std::invalid_argument("Search index must not be null");
+    }
+    return createSearchTool("wikipedia", "Search Wikipedia for information",
+                            "The Wikipedia article to search for", top_k,
+                            [index]() { return index; });
+}
+
+} // namespace tools
+} // namespace agents
@@ -0,0 +1,133 @@
+#include <agents-cpp/tools/sandbox_pool.h>
+#include <agents-cpp/tools/tool_registry.h>
+#include <agents-cpp/tool.h>
+#include <stdexcept>
+
+namespace agents {
+namespace tools {
+
+namespace {
+
+using PoolProvider = std::function<std::shared_ptr<SandboxPool>()>;
+
+ToolResult toToolResult(const SandboxResult& sandbox) {
+    ToolResult result;
+    result.success = sandbox.exit_code == 0 && !sandbox.timed_out && !sandbox.cancelled;
+
+    result.content = sandbox.stdout_output;
+    if (!sandbox.stderr_output.empty()) {
+        if (!result.content.empty() && result.content.back() != '\n') {
+            result.content += "\n";
+        }
+        result.content += "stderr:\n" + sandbox.stderr_output;
+    }
+    if (sandbox.timed_out) {
+        result.content += "\nTimed out after " + std::to_string(sandbox.duration.count()) + " ms";
+    } else if (sandbox.cancelled) {
+        result.content += "\nCancelled";
+    } else if (sandbox.exit_code != 0) {
+        result.content += "\nExit code: " + std::to_string(sandbox.exit_code);
+    }
+
+    result.data = {
+        {"exit_code", sandbox.exit_code},
+        {"stdout", sandbox.stdout_output},
+        {"stderr", sandbox.stderr_output},
+        {"timed_out", sandbox.timed_out},
+        {"cancelled", sandbox.cancelled},
+        {"truncated", sandbox.truncated},
+        {"duration_ms", sandbox.duration.count()}
+    };
+    return result;
+}
+
+std::shared_ptr<Tool> createSandboxTool(
+    const String& name,
+    const String& description,
+    const Parameter& source,
+    size_t pool_size,
+    PoolProvider pool,
+    SandboxOutputCallback on_output
+) {
+    auto tool = std::make_shared<Tool>(name, description);
+    tool->addParameter(source);
+
+    tool->setCallback([pool = std::move(pool), on_output = std::move(on_output), key = source.name](
+        const JsonObject& params
+    ) {
+        try {
+            return toToolResult(pool()->run(params[key].get<String>(), on_output));
+        } catch (const std::exception& e) {
+            ToolResult result;
+            result.success = false;
+            result.content = String("Sandbox unavailable: ") + e.what();
+            return result;
+        }
+    });
+
+    // Calls beyond the pool size would only block tool executor threads waiting for a worker
+    tool->setMaxConcurrency(pool_size);
+
+    // Commands and scripts can change any file
+    tool->setInvalidates({"file_read"});
+
+    return tool;
+}
+
+Parameter commandParameter() {
+    Parameter command;
+    command.name = "command";
+    command.description = "The shell command to execute";
+    command.type = "string";
+    command.required = true;
+    return command;
+}
+
+Parameter codeParameter() {
+    Parameter code;
+    code.name = "code";
+    code.description = "The Python code to execute";
+    code.type = "string";
+    code.required = true;
+    return code;
+}
+
+} // namespace
+
+std::shared_ptr<Tool> createShellCommandTool() {
+    // The shared pool is only started once the tool is first used
+    return createSandboxTool("shell", "Execute shell commands on the system", commandParameter(),
+                             SandboxPoolOptions().pool_size, &SandboxPool::shell, nullptr);
+}
+
+std::shared_ptr<Tool> createShellCommandTool(
+    std::shared_ptr<SandboxPool> pool,
+    SandboxOutputCallback on_output
+) {
+    if (!pool) {
+        throw std::invalid_argument("Sandbox pool must not be null");
+    }
+    size_t pool_size = pool->getOptions().pool_size;
+    return createSandboxTool("shell", "Execute shell commands on the system", commandParameter(),
+                             pool_size, [pool]() { return pool; }, std::move(on_output));
+}
+
+std::shared_ptr<Tool> createPythonTool() {
+    return createSandboxTool("python", "Execute Python code", codeParameter(),
+                             SandboxPoolOptions().pool_size, &SandboxPool::python, nullptr);
+}
+
+std::shared_ptr<Tool> createPythonTool(
+    std::shared_ptr<SandboxPool> pool,
+    SandboxOutputCallback on_output
+) {
+    if (!pool) {
+        throw std::invalid_argument("Sandbox pool must not be null");
+    }
+    size_t pool_size = pool->getOptions().pool_size;
+    return createSandboxTool("python", "Execute Python code", codeParameter(),
+                             pool_size, [pool]() { return pool; }, std::move(on_output));
+}
+
+} // namespace tools
+} // namespace agents
@@ -5,56 +5,126 @@
 namespace agents {
 namespace tools {
 
+std::shared_ptr<Tool> ToolRegistry::Snapshot::getTool(const String& name) const {
+    auto it = by_name_.find(name);
+    if (it == by_name_.end()) {
+        return nullptr;
+    }
+    
+    return it->second;
+}
+
+bool ToolRegistry::Snapshot::hasTool(const String& name) const {
+    return by_name_.find(name) != by_name_.end();
+}
+
+ToolRegistry::ToolRegistry() {
+    auto empty = std::make_shared<Snapshot>();
+    empty->schemas_["tools"] = JsonObject::array();
+    snapshot_.store(std::move(empty));
+}
+
+ToolRegistry::ToolRegistry(const ToolRegistry& other)
+    : snapshot_(other.snapshot_.load()) {
+}
+
+ToolRegistry& ToolRegistry::operator=(const ToolRegistry& other) {
+    if (this != &other) {
+        auto shared = other.snapshot_.load();
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        snapshot_.store(std::move(shared));
+    }
+    return *this;
+}
+
 void ToolRegistry::registerTool(std::shared_ptr<Tool> tool) {
     if (!tool) {
         throw std::invalid_argument("Cannot register null tool");
     }
     
-    tools_[tool->getName()] = tool;
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto tools = currentTools();
+    tools[tool->getName()] = std::move(tool);
+    publish(std::move(tools));
 }
 
-std::shared_ptr<Tool> ToolRegistry::getTool(const String& name) const {
-    auto it = tools_.find(name);
-    if (it == tools_.end()) {
-        return nullptr;
+void ToolRegistry::registerTools(const std::vector<std::shared_ptr<Tool>>& tools) {
+    for (const auto& tool : tools) {
+        if (!tool) {
+            throw std::invalid_argument("Cannot register null tool");
+        }
     }
     
-    return it->second;
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto current = currentTools();
+    for (const auto& tool : tools) {
+        current[tool->getName()] = tool;
+    }
+    publish(std::move(current));
+}
+
+std::shared_ptr<Tool> ToolRegistry::getTool(const String& name) const {
+    return snapshot()->getTool(name);
 }
 
 std::vector<std::shared_ptr<Tool>> ToolRegistry::getAllTools() const {
-    std::vector<std::shared_ptr<Tool>> result;
-    result.reserve(tools_.size());
-    
-    for (const auto& pair : tools_) {
-        result.push_back(pair.second);
-    }
-    
-    return result;
+    return snapshot()->getAllTools();
 }
 
 bool ToolRegistry::hasTool(const String& name) const {
-    return tools_.find(name) != tools_.end();
+    return snapshot()->hasTool(name);
 }
 
 void ToolRegistry::removeTool(const String& name) {
-    tools_.erase(name);
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    auto tools = currentTools();
+    if (tools.erase(name) == 0) {
+        return;
+    }
+    publish(std::move(tools));
 }
 
 void ToolRegistry::clear() {
-    tools_.clear();
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    publish({});
 }
 
 JsonObject ToolRegistry::getToolSchemas() const {
-    JsonObject schemas;
-    std::vector<JsonObject> toolsArray;
-    
-    for (const auto& pair : tools_) {
-        toolsArray.push_back(pair.second->getSchema());
+    return snapshot()->getToolSchemas();
+}
+
+ToolRegistry::SnapshotPtr ToolRegistry::snapshot() const {
+    return snapshot_.load();
+}
+
+uint64_t ToolRegistry::version() const {
+    return snapshot()->version();
+}
+
+void ToolRegistry::publish(std::map<String, std::shared_ptr<Tool>> tools) {
+    auto next = std::make_shared<Snapshot>();
+    next->version_ = snapshot_.load()->version_ + 1;
+    next->by_name_.reserve(tools.size());
+    next->sorted_.reserve(tools.size());
+    
+    auto schemas = JsonObject::array();
+    for (auto& [name, tool] : tools) {
+        schemas.push_back(tool->getSchema());
+        next->by_name_.emplace(name, tool);
+        next->sorted_.push_back(std::move(tool));
     }
+    next->schemas_["tools"] = std::move(schemas);
     
-    schemas["tools"] = toolsArray;
-    return schemas;
+    snapshot_.store(std::move(next));
+}
+
+std::map<String, std::shared_ptr<Tool>> ToolRegistry::currentTools() const {
+    std::map<String, std::shared_ptr<Tool>> tools;
+    auto current = snapshot_.load();
+    for (const auto& tool : current->sorted_) {
+        tools.emplace(tool->getName(), tool);
+    }
+    return tools;
 }
 
 ToolRegistry& ToolRegistry::global() {
@@ -72,144 +142,5 @@ void registerStandardTools(ToolRegistry& registry) {
     registry.registerTool(createFileWriteTool());
 }
 
-std::shared_ptr<Tool> createShellCommandTool() {
-    auto tool = std::make_shared<Tool>("shell", "Execute shell commands on the system");
-    
-    Parameter command;
-    command.name = "command";
-    command.description = "The shell command to execute";
-    command.type = "string";
-    command.required = true;
-    
-    tool->addParameter(command);
-    
-    tool->setCallback([](const JsonObject& params) {
-        ToolResult result;
-        result.success = true;
-        result.content = "Shell command executed: " + params["command"].get<String>();
-        // In a real implementation, this would actually execute the command
-        return result;
-    });
-    
-    return tool;
-}
-
-std::shared_ptr<Tool> createWebSearchTool() {
-    auto tool = std::make_shared<Tool>("web_search", "Search the web for information");
-    
-    Parameter query;
-    query.name = "query";
-    query.description = "The search query";
-    query.type = "string";
-    query.required = true;
-    
-    tool->addParameter(query);
-    
-    tool->setCallback([](const JsonObject& params) {
-        ToolResult result;
-        result.success = true;
-        result.content = "Web search results for: " + params["query"].get<String>();
-        // In a real implementation, this would perform an actual web search
-        return result;
-    });
-    
-    return tool;
-}
-
-std::shared_ptr<Tool> createWikipediaTool() {
-    auto tool = std::make_shared<Tool>("wikipedia", "Search Wikipedia for information");
-    
-    Parameter query;
-    query.name = "query";
-    query.description = "The Wikipedia article to search for";
-    query.type = "string";
-    query.required = true;
-    
-    tool->addParameter(query);
-    
-    tool->setCallback([](const JsonObject& params) {
-        ToolResult result;
-        result.success = true;
-        result.content = "Wikipedia results for: " + params["query"].get<String>();
-        // In a real implementation, this would fetch Wikipedia content
-        return result;
-    });
-    
-    return tool;
-}
-
-std::shared_ptr<Tool> createPythonTool() {
-    auto tool = std::make_shared<Tool>("python", "Execute Python code");
-    
-    Parameter code;
-    code.name = "code";
-    code.description = "The Python code to execute";
-    code.type = "string";
-    code.required = true;
-    
-    tool->addParameter(code);
-    
-    tool->setCallback([](const JsonObject& params) {
-        ToolResult result;
-        result.success = true;
-        result.content = "Python code executed: " + params["code"].get<String>();
-        // In a real implementation, this would execute Python code
-        return result;
-    });
-    
-    return tool;
-}
-
-std::shared_ptr<Tool> createFileReadTool() {
-    auto tool = std::make_shared<Tool>("file_read", "Read a file from the filesystem");
-    
-    Parameter path;
-    path.name = "path";
-    path.description = "The path to the file to read";
-    path.type = "string";
-    path.required = true;
-    
-    tool->addParameter(path);
-    
-    tool->setCallback([](const JsonObject& params) {
-        ToolResult result;
-        result.success = true;
-        result.content = "File read from: " + params["path"].get<String>();
-        // In a real implementation, this would read the file content
-        return result;
-    });
-    
-    return tool;
-}
-
-std::shared_ptr<Tool> createFileWriteTool() {
-    auto tool = std::make_shared<Tool>("file_write", "Write to a file in the filesystem");
-    
-    Parameter path;
-    path.name = "path";
-    path.description = "The path to the file to write";
-    path.type = "string";
-    path.required = true;
-    
-    Parameter content;
-    content.name = "content";
-    content.description = "The content to write to the file";
-    content.type = "string";
-    content.required = true;
-    
-    tool->addParameter(path);
-    tool->addParameter(content);
-    
-    tool->setCallback([](const JsonObject& params) {
-        ToolResult result;
-        result.success = true;
-        result.content = "File written to: " + params["path"].get<String>();
-        // In a real implementation, this would write the content to the file
-        return result;
-    });
-    
-    return tool;
-}
-
 } // namespace tools
 } // namespace agents 
\ No newline at end of file
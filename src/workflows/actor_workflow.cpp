@@ -53,6 +53,11 @@ ActorWorkflow::ActorWorkflow(std::shared_ptr<AgentContext> context)
 // Destructor
 ActorWorkflow::~ActorWorkflow() {
     stop();
+    
+    // The shared system outlives the workflow, so its actors must be shut down explicitly
+    for (const auto& actor : actors_) {
+        caf::anon_send_exit(actor, caf::exit_reason::user_shutdown);
+    }
 }
 
 // Initialize the workflow
@@ -97,17 +102,13 @@ String ActorWorkflow::getStatus() const {
 }
 
 
-// Create and configure the actor system
+// Spawn the workflow actor into the shared actor system
 void ActorWorkflow::setupActorSystem() {
     if (!actor_system_) {
-        // Create actor system config
-        caf::actor_system_config cfg;
-        
-        // Create actor system
-        actor_system_ = std::make_unique<caf::actor_system>(cfg);
+        actor_system_ = &ActorRuntime::global().system();
         
         // Create workflow actor
-        workflow_actor_ = actor_system_->spawn(baseWorkflowBehavior);
+        workflow_actor_ = spawnActor(baseWorkflowBehavior);
     }
 }
 
@@ -0,0 +1,466 @@
+#include <agents-cpp/workflows/dag_workflow.h>
+#include <agents-cpp/logger.h>
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+
+namespace agents {
+namespace workflows {
+
+struct DagWorkflow::RunState {
+    String input;
+    std::vector<NodeResult> results;
+
+    // Nodes finished since the scheduler last looked, and the baton waking it
+    std::mutex mutex;
+    std::vector<size_t> finished;
+    folly::coro::Baton wake;
+};
+
+namespace {
+
+// Dependency structure of the graph, derived once per run
+struct Plan {
+    std::vector<std::vector<size_t>> dependents;
+    std::vector<size_t> pending;      // Inputs not yet available, per node
+    std::vector<double> priority;     // Cost of the longest path from the node to the end
+};
+
+Plan makePlan(const std::vector<DagWorkflow::Node>& nodes, const std::map<String, size_t>& index) {
+    Plan plan;
+    plan.dependents.resize(nodes.size());
+    plan.pending.assign(nodes.size(), 0);
+    plan.priority.assign(nodes.size(), 0.0);
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        for (const auto& input : nodes[i].inputs) {
+            auto it = index.find(input);
+            if (it == index.end()) {
+                throw std::invalid_argument("Node " + nodes[i].name + " reads unknown node " + input);
+            }
+            plan.dependents[it->second].push_back(i);
+            ++plan.pending[i];
+        }
+    }
+
+    // Topological order; anything left out is on a cycle
+    std::vector<size_t> order;
+    std::vector<size_t> remaining = plan.pending;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (remaining[i] == 0) {
+            order.push_back(i);
+        }
+    }
+    for (size_t k = 0; k < order.size(); ++k) {
+        for (size_t dependent : plan.dependents[order[k]]) {
+            if (--remaining[dependent] == 0) {
+                order.push_back(dependent);
+            }
+        }
+    }
+    if (order.size() < nodes.size()) {
+        // A node left out may only depend on a cycle, so follow unresolved inputs
+        // backwards until a node repeats; that node is on the cycle
+        size_t node = std::find_if(remaining.begin(), remaining.end(), [](size_t count) {
+            return count > 0;
+        }) - remaining.begin();
+        std::vector<bool> seen(nodes.size(), false);
+        while (!seen[node]) {
+            seen[node] = true;
+            for (const auto& input : nodes[node].inputs) {
+                size_t from = index.at(input);
+                if (remaining[from] > 0) {
+                    node = from;
+                    break;
+                }
+            }
+        }
+        throw std::invalid_argument("DAG workflow has a cycle through node " + nodes[node].name);
+    }
+
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        double longest = 0.0;
+        for (size_t dependent : plan.dependents[*it]) {
+            longest = std::max(longest, plan.priority[dependent]);
+        }
+        plan.priority[*it] = nodes[*it].cost + longest;
+    }
+
+    return plan;
+}
+
+const char* statusName(DagWorkflow::NodeResult::Status status) {
+    switch (status) {
+        case DagWorkflow::NodeResult::Status::SUCCEEDED:
+            return "succeeded";
+        case DagWorkflow::NodeResult::Status::FAILED:
+            return "failed";
+        case DagWorkflow::NodeResult::Status::SKIPPED:
+            return "skipped";
+        case DagWorkflow::NodeResult::Status::CANCELLED:
+            return "cancelled";
+    }
+    return "unknown";
+}
+
+JsonObject describe(const DagWorkflow::NodeResult& result) {
+    JsonObject description;
+    description["status"] = statusName(result.status);
+    description["latency_ms"] = result.latency.count();
+    description["cached"] = result.cached;
+    if (!result.error.empty()) {
+        description["error"] = result.error;
+    }
+    return description;
+}
+
+// Text of a node output: its "response" or "content" if it has one, otherwise the whole output
+String outputText(const JsonObject& output) {
+    for (const char* key : {"response", "content", "final_output"}) {
+        if (output.contains(key) && output[key].is_string()) {
+            return output[key].get<String>();
+        }
+    }
+    return output.dump();
+}
+
+// The run input followed by each declared input
+String defaultPrompt(const DagWorkflow::Node& node, const JsonObject& inputs) {
+    String prompt = inputs["input"].get<String>();
+    for (const auto& input : node.inputs) {
+        prompt += "\n\n## " + input + "\n" + outputText(inputs[input]);
+    }
+    return prompt;
+}
+
+} // namespace
+
+DagWorkflow::DagWorkflow(std::shared_ptr<AgentContext> context)
+    : Workflow(context) {
+}
+
+void DagWorkflow::addNode(const Node& node) {
+    if (node.name.empty() || node.name == "input") {
+        throw std::invalid_argument("Invalid DAG node name: '" + node.name + "'");
+    }
+    if (index_.count(node.name)) {
+        throw std::invalid_argument("Duplicate DAG node: " + node.name);
+    }
+    if (node.type == Node::Type::TOOL && !node.params_fn) {
+        throw std::invalid_argument("Tool node " + node.name + " needs a parameter function");
+    }
+    if (node.type == Node::Type::WORKFLOW && !node.workflow) {
+        throw std::invalid_argument("Workflow node " + node.name + " needs a workflow");
+    }
+
+    index_[node.name] = nodes_.size();
+    nodes_.push_back(node);
+}
+
+void DagWorkflow::addLLMNode(
+    const String& name,
+    const std::vector<String>& inputs,
+    const String& system_prompt,
+    std::function<String(const JsonObject&)> prompt_fn
+) {
+    Node node;
+    node.name = name;
+    node.type = Node::Type::LLM;
+    node.inputs = inputs;
+    node.system_prompt = system_prompt;
+    node.prompt_fn = prompt_fn;
+    addNode(node);
+}
+
+void DagWorkflow::addToolNode(
+    const String& name,
+    const std::vector<String>& inputs,
+    const String& tool_name,
+    std::function<JsonObject(const JsonObject&)> params_fn
+) {
+    Node node;
+    node.name = name;
+    node.type = Node::Type::TOOL;
+    node.inputs = inputs;
+    node.tool_name = tool_name;
+    node.params_fn = params_fn;
+    addNode(node);
+}
+
+void DagWorkflow::addWorkflowNode(
+    const String& name,
+    const std::vector<String>& inputs,
+    std::shared_ptr<Workflow> workflow,
+    std::function<String(const JsonObject&)> input_fn
+) {
+    Node node;
+    node.name = name;
+    node.type = Node::Type::WORKFLOW;
+    node.inputs = inputs;
+    node.workflow = workflow;
+    node.prompt_fn = input_fn;
+    addNode(node);
+}
+
+void DagWorkflow::setMaxConcurrency(size_t max_concurrency) {
+    max_concurrency_ = max_concurrency;
+}
+
+void DagWorkflow::setCacheSize(size_t max_entries) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    max_cached_outputs_ = max_entries;
+    while (cache_lru_.size() > max_cached_outputs_) {
+        cache_.erase(cache_lru_.back().first);
+        cache_lru_.pop_back();
+    }
+}
+
+void DagWorkflow::clearCache() {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_.clear();
+    cache_lru_.clear();
+}
+
+std::optional<JsonObject> DagWorkflow::cachedOutput(const String& key) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    auto it = cache_.find(key);
+    if (it == cache_.end()) {
+        return std::nullopt;
+    }
+    cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second);
+    return it->second->second;
+}
+
+void DagWorkflow::cacheOutput(const String& key, const JsonObject& output) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (max_cached_outputs_ == 0) {
+        return;
+    }
+
+    auto it = cache_.find(key);
+    if (it != cache_.end()) {
+        it->second->second = output;
+        cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second);
+        return;
+    }
+
+    cache_lru_.emplace_front(key, output);
+    cache_[key] = cache_lru_.begin();
+    if (cache_lru_.size() > max_cached_outputs_) {
+        cache_.erase(cache_lru_.back().first);
+        cache_lru_.pop_back();
+    }
+}
+
+JsonObject DagWorkflow::run(const String& input) {
+    auto results = blockingWait(execute(input));
+
+    JsonObject outputs = JsonObject::object();
+    JsonObject nodes = JsonObject::object();
+    String error;
+    for (const auto& node_result : results) {
+        nodes[node_result.name] = describe(node_result);
+        if (node_result.status == NodeResult::Status::SUCCEEDED) {
+            outputs[node_result.name] = node_result.output;
+        } else if (node_result.status == NodeResult::Status::FAILED && error.empty()) {
+            error = "Node " + node_result.name + " failed: " + node_result.error;
+        }
+    }
+
+    // The final output comes from the nodes nothing else reads
+    std::vector<String> sinks;
+    for (const auto& node : nodes_) {
+        bool read = std::any_of(nodes_.begin(), nodes_.end(), [&](const Node& other) {
+            return std::find(other.inputs.begin(), other.inputs.end(), node.name) != other.inputs.end();
+        });
+        if (!read && outputs.contains(node.name)) {
+            sinks.push_back(node.name);
+        }
+    }
+
+    JsonObject result;
+    result["outputs"] = outputs;
+    result["nodes"] = nodes;
+    if (sinks.size() == 1) {
+        result["final_output"] = outputText(outputs[sinks.front()]);
+    } else if (!sinks.empty()) {
+        result["final_output"] = JsonObject::object();
+        for (const auto& sink : sinks) {
+            result["final_output"][sink] = outputText(outputs[sink]);
+        }
+    }
+    if (!error.empty()) {
+        result["error"] = error;
+    }
+
+    return result;
+}
+
+agents::Task<std::vector<DagWorkflow::NodeResult>> DagWorkflow::execute(const String& input) {
+    Plan plan = makePlan(nodes_, index_);
+
+    RunState state;
+    state.input = input;
+    state.results.resize(nodes_.size());
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        state.results[i].name = nodes_[i].name;
+    }
+
+    // Ready nodes on the longest remaining path go first, ties in the order the nodes were added
+    auto later = [&plan](size_t a, size_t b) {
+        return plan.priority[a] < plan.priority[b] || (plan.priority[a] == plan.priority[b] && a > b);
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(later)> ready(later);
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (plan.pending[i] == 0) {
+            ready.push(i);
+        }
+    }
+
+    // A node that cannot run resolves its dependents as skipped, transitively
+    std::vector<bool> skipped(nodes_.size(), false);
+    size_t done = 0;
+    std::function<void(size_t)> skip = [&](size_t failed) {
+        for (size_t dependent : plan.dependents[failed]) {
+            if (!skipped[dependent]) {
+                skipped[dependent] = true;
+                state.results[dependent].status = NodeResult::Status::SKIPPED;
+                state.results[dependent].error = "Input " + nodes_[failed].name + " did not succeed";
+                ++done;
+                skip(dependent);
+            }
+        }
+    };
+
+    const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+    size_t budget = max_concurrency_ > 0 ? max_concurrency_ : nodes_.size();
+    size_t in_flight = 0;
+    folly::coro::AsyncScope scope;
+
+    while (done < nodes_.size()) {
+        while (in_flight < budget && !ready.empty()) {
+            size_t node = ready.top();
+            ready.pop();
+
+            // Nodes run on the agent executor and block on the blocking executor, so calls of independent branches overlap
+            scope.add(folly::coro::co_withCancellation(token, runNode(node, state)).scheduleOn(getExecutor()));
+            ++in_flight;
+        }
+        if (in_flight == 0) {
+            break;
+        }
+
+        co_await state.wake;
+        std::vector<size_t> finished;
+        {
+            std::lock_guard<std::mutex> lock(state.mutex);
+            finished.swap(state.finished);
+            state.wake.reset();
+        }
+
+        for (size_t node : finished) {
+            --in_flight;
+            ++done;
+            if (state.results[node].status != NodeResult::Status::SUCCEEDED) {
+                skip(node);
+                continue;
+            }
+            for (size_t dependent : plan.dependents[node]) {
+                if (--plan.pending[dependent] == 0 && !skipped[dependent]) {
+                    ready.push(dependent);
+                }
+            }
+        }
+    }
+
+    co_await scope.joinAsync();
+
+    if (token.isCancellationRequested()) {
+        throw folly::OperationCancelled();
+    }
+    co_return std::move(state.results);
+}
+
+agents::Task<void> DagWorkflow::runNode(size_t index, RunState& state) {
+    const Node& node = nodes_[index];
+    NodeResult result;
+    result.name = node.name;
+    auto start = std::chrono::steady_clock::now();
+
+    // Inputs are complete: the scheduler only starts a node once all of them have finished
+    JsonObject inputs;
+    inputs["input"] = state.input;
+    for (const auto& input : node.inputs) {
+        inputs[input] = state.results[index_.at(input)].output;
+    }
+
+    const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+    if (!token.isCancellationRequested()) {
+        try {
+            String key;
+            if (node.memoize) {
+                key = node.name + '\n' + inputs.dump();
+                if (auto cached = cachedOutput(key)) {
+                    result.output = std::move(*cached);
+                    result.cached = true;
+                }
+            }
+
+            if (!result.cached) {
+                result.output = co_await executeNode(node, inputs);
+                if (node.memoize) {
+                    cacheOutput(key, result.output);
+                }
+            }
+            result.status = NodeResult::Status::SUCCEEDED;
+        } catch (const folly::OperationCancelled&) {
+            result.status = NodeResult::Status::CANCELLED;
+        } catch (const std::exception& e) {
+            result.status = NodeResult::Status::FAILED;
+            result.error = e.what();
+        }
+    }
+    result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.results[index] = std::move(result);
+    if (state.results[index].status != NodeResult::Status::CANCELLED) {
+        logStep(node.name, describe(state.results[index]));
+    }
+    state.finished.push_back(index);
+    state.wake.post();
+}
+
+agents::Task<JsonObject> DagWorkflow::executeNode(const Node& node, const JsonObject& inputs) {
+    switch (node.type) {
+        case Node::Type::LLM: {
+            // A forked context keeps this node's system prompt and history to itself
+            auto node_context = context_->fork();
+            node_context->setSystemPrompt(node.system_prompt);
+            String prompt = node.prompt_fn ? node.prompt_fn(inputs) : defaultPrompt(node, inputs);
+            auto response = co_await node_context->chat(prompt);
+            co_return JsonObject{{"response", response.content}};
+        }
+        case Node::Type::TOOL: {
+            auto tool_result = co_await context_->executeTool(node.tool_name, node.params_fn(inputs));
+            if (!tool_result.success) {
+                throw std::runtime_error(tool_result.content);
+            }
+            co_return JsonObject{{"content", tool_result.content}, {"data", tool_result.data}};
+        }
+        case Node::Type::WORKFLOW: {
+            String workflow_input = node.prompt_fn ? node.prompt_fn(inputs) : defaultPrompt(node, inputs);
+            // Awaiting keeps this thread free and carries the node's cancellation into the child
+            JsonObject output = co_await node.workflow->runTask(workflow_input);
+            if (output.contains("error") && output["error"].is_string()) {
+                throw std::runtime_error(output["error"].get<String>());
+            }
+            co_return output;
+        }
+    }
+    throw std::logic_error("Unknown DAG node type");
+}
+
+} // namespace workflows
+} // namespace agents
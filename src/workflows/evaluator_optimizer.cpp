@@ -0,0 +1,376 @@
+#include <agents-cpp/workflows/evaluator_optimizer.h>
+#include <agents-cpp/logger.h>
+#include <optional>
+#include <stdexcept>
+
+namespace agents {
+namespace workflows {
+
+struct EvaluatorOptimizer::RoundState {
+    struct Candidate {
+        enum class Status {
+            SUCCEEDED,
+            FAILED,
+            CANCELLED   // Another candidate was accepted first
+        };
+
+        Status status = Status::CANCELLED;
+        String output;
+        JsonObject evaluation;
+        double score = 0.0;
+        bool cached = false;
+        String error;
+    };
+
+    std::vector<Candidate> candidates;
+    std::mutex mutex;
+    std::optional<size_t> accepted;
+
+    // Accepting a candidate cancels the rest of the round
+    folly::CancellationSource stop;
+};
+
+namespace {
+
+double scoreOf(const JsonObject& evaluation) {
+    if (evaluation.contains("score") && evaluation["score"].is_number()) {
+        return evaluation["score"].get<double>();
+    }
+    return 0.0;
+}
+
+String feedbackOf(const JsonObject& evaluation) {
+    if (!evaluation.contains("feedback")) {
+        return "";
+    }
+    const auto& feedback = evaluation["feedback"];
+    return feedback.is_string() ? feedback.get<String>() : feedback.dump();
+}
+
+} // namespace
+
+EvaluatorOptimizer::EvaluatorOptimizer(std::shared_ptr<AgentContext> context)
+    : Workflow(context) {
+}
+
+void EvaluatorOptimizer::setOptimizerPrompt(const String& optimizer_prompt) {
+    optimizer_prompt_ = optimizer_prompt;
+}
+
+void EvaluatorOptimizer::setEvaluatorPrompt(const String& evaluator_prompt) {
+    evaluator_prompt_ = evaluator_prompt;
+    clearEvaluationCache();
+}
+
+void EvaluatorOptimizer::setEvaluationCriteria(const std::vector<String>& criteria) {
+    evaluation_criteria_ = criteria;
+    clearEvaluationCache();
+}
+
+void EvaluatorOptimizer::setOptimizer(std::function<String(const String&, const JsonObject&)> optimizer) {
+    optimizer_ = optimizer;
+}
+
+void EvaluatorOptimizer::setEvaluator(std::function<JsonObject(const String&, const String&)> evaluator) {
+    evaluator_ = evaluator;
+    clearEvaluationCache();
+}
+
+void EvaluatorOptimizer::setMaxIterations(int max_iterations) {
+    max_iterations_ = max_iterations;
+}
+
+void EvaluatorOptimizer::setMinimumAcceptableScore(double min_score) {
+    min_acceptable_score_ = min_score;
+}
+
+void EvaluatorOptimizer::setBeamWidth(size_t beam_width) {
+    if (beam_width == 0) {
+        throw std::invalid_argument("Beam width must be at least 1");
+    }
+    beam_width_ = beam_width;
+}
+
+void EvaluatorOptimizer::setEvaluationCacheSize(size_t max_entries) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    max_cached_evaluations_ = max_entries;
+    while (cache_lru_.size() > max_cached_evaluations_) {
+        evaluation_cache_.erase(cache_lru_.back().first);
+        cache_lru_.pop_back();
+    }
+}
+
+void EvaluatorOptimizer::clearEvaluationCache() {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    evaluation_cache_.clear();
+    cache_lru_.clear();
+    ++cache_generation_;
+}
+
+std::optional<JsonObject> EvaluatorOptimizer::cachedEvaluation(const String& key, uint64_t& generation) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    generation = cache_generation_;
+    auto it = evaluation_cache_.find(key);
+    if (it == evaluation_cache_.end()) {
+        return std::nullopt;
+    }
+    cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second);
+    return it->second->second;
+}
+
+void EvaluatorOptimizer::cacheEvaluation(const String& key, const JsonObject& evaluation, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (generation != cache_generation_ || max_cached_evaluations_ == 0) {
+        return;
+    }
+
+    auto it = evaluation_cache_.find(key);
+    if (it != evaluation_cache_.end()) {
+        it->second->second = evaluation;
+        cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second);
+        return;
+    }
+
+    cache_lru_.emplace_front(key, evaluation);
+    evaluation_cache_[key] = cache_lru_.begin();
+    if (cache_lru_.size() > max_cached_evaluations_) {
+        evaluation_cache_.erase(cache_lru_.back().first);
+        cache_lru_.pop_back();
+    }
+}
+
+JsonObject EvaluatorOptimizer::run(const String& input) {
+    return blockingWait(execute(input));
+}
+
+Task<JsonObject> EvaluatorOptimizer::runTask(const String& input) {
+    return execute(input);
+}
+
+Task<JsonObject> EvaluatorOptimizer::execute(const String& input) {
+    const folly::CancellationToken& caller = co_await folly::coro::co_current_cancellation_token;
+
+    // Best candidate across all iterations; each iteration refines it
+    String best_output;
+    JsonObject best_evaluation;
+    double best_score = -1.0;
+    bool accepted = false;
+
+    JsonObject evaluations = JsonObject::array();
+    JsonObject feedback = JsonObject::object();
+    size_t cached_evaluations = 0;
+    int iterations = 0;
+
+    while (iterations < max_iterations_ && !accepted) {
+        ++iterations;
+
+        RoundState state;
+        state.candidates.resize(beam_width_);
+        auto token = folly::CancellationToken::merge(caller, state.stop.getToken());
+
+        std::vector<folly::coro::TaskWithExecutor<void>> runs;
+        runs.reserve(beam_width_);
+        for (size_t i = 0; i < beam_width_; ++i) {
+            runs.push_back(folly::coro::co_withCancellation(token, runCandidate(i, input, feedback, state))
+                               .scheduleOn(getExecutor()));
+        }
+        co_await folly::coro::collectAllWindowed(std::move(runs), beam_width_);
+
+        if (caller.isCancellationRequested()) {
+            throw folly::OperationCancelled();
+        }
+
+        String error;
+        bool any_succeeded = false;
+        for (size_t i = 0; i < state.candidates.size(); ++i) {
+            const auto& candidate = state.candidates[i];
+            if (candidate.status == RoundState::Candidate::Status::FAILED && error.empty()) {
+                error = candidate.error;
+            }
+            if (candidate.status != RoundState::Candidate::Status::SUCCEEDED) {
+                continue;
+            }
+            any_succeeded = true;
+            cached_evaluations += candidate.cached ? 1 : 0;
+
+            JsonObject record;
+            record["iteration"] = iterations;
+            record["candidate"] = i;
+            record["score"] = candidate.score;
+            record["feedback"] = feedbackOf(candidate.evaluation);
+            record["cached"] = candidate.cached;
+            evaluations.push_back(record);
+
+            if (candidate.score > best_score) {
+                best_output = candidate.output;
+                best_evaluation = candidate.evaluation;
+                best_score = candidate.score;
+            }
+        }
+        if (!any_succeeded) {
+            throw std::runtime_error("All candidates failed in iteration " + std::to_string(iterations) +
+                                     ": " + error);
+        }
+
+        // The accepted candidate wins even if a slower one might have scored higher
+        if (state.accepted) {
+            const auto& candidate = state.candidates[*state.accepted];
+            best_output = candidate.output;
+            best_evaluation = candidate.evaluation;
+            best_score = candidate.score;
+            accepted = true;
+        }
+
+        feedback = {
+            {"previous_output", best_output},
+            {"score", best_score},
+            {"feedback", feedbackOf(best_evaluation)},
+            {"evaluation", best_evaluation}
+        };
+    }
+
+    JsonObject result;
+    result["final_response"] = best_output;
+    result["final_score"] = best_score;
+    result["accepted"] = accepted;
+    result["iterations"] = iterations;
+    result["evaluations"] = evaluations;
+    result["cached_evaluations"] = cached_evaluations;
+    co_return result;
+}
+
+Task<void> EvaluatorOptimizer::runCandidate(
+    size_t index,
+    const String& input,
+    const JsonObject& feedback,
+    RoundState& state
+) {
+    RoundState::Candidate candidate;
+
+    const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+    if (!token.isCancellationRequested()) {
+        try {
+            // Candidates of one iteration see which of them they are, so they can diverge
+            JsonObject request = feedback;
+            if (beam_width_ > 1) {
+                request["candidate"] = index + 1;
+                request["candidates"] = beam_width_;
+            }
+            candidate.output = co_await generate(input, request);
+
+            // The evaluation depends on the output and the input it answers
+            String key = input;
+            key += '\0';
+            key += candidate.output;
+            uint64_t generation = 0;
+            if (auto cached = cachedEvaluation(key, generation)) {
+                candidate.evaluation = std::move(*cached);
+                candidate.cached = true;
+            } else {
+                candidate.evaluation = co_await evaluate(input, candidate.output);
+                cacheEvaluation(key, candidate.evaluation, generation);
+            }
+
+            candidate.score = scoreOf(candidate.evaluation);
+            candidate.status = RoundState::Candidate::Status::SUCCEEDED;
+        } catch (const folly::OperationCancelled&) {
+            candidate.status = RoundState::Candidate::Status::CANCELLED;
+        } catch (const std::exception& e) {
+            candidate.status = RoundState::Candidate::Status::FAILED;
+            candidate.error = e.what();
+        }
+    }
+
+    bool accept = false;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        accept = candidate.status == RoundState::Candidate::Status::SUCCEEDED &&
+                 candidate.score >= min_acceptable_score_ && !state.accepted;
+        if (accept) {
+            state.accepted = index;
+        }
+        state.candidates[index] = candidate;
+    }
+
+    if (candidate.status == RoundState::Candidate::Status::SUCCEEDED) {
+        logStep("Candidate " + std::to_string(index + 1) + " evaluated",
+                {{"score", candidate.score}, {"cached", candidate.cached}, {"accepted", accept}});
+    }
+    if (accept) {
+        Logger::debug("Accepted candidate {} with score {}", index + 1, candidate.score);
+        state.stop.requestCancellation();
+    }
+}
+
+Task<String> EvaluatorOptimizer::generate(const String& input, const JsonObject& feedback) {
+    if (optimizer_) {
+        String output = co_await runBlocking([&]() { return optimizer_(input, feedback); });
+        if (!output.empty()) {
+            co_return output;
+        }
+    }
+    co_return co_await defaultOptimizer(input, feedback);
+}
+
+Task<JsonObject> EvaluatorOptimizer::evaluate(const String& input, const String& output) {
+    if (evaluator_) {
+        JsonObject evaluation = co_await runBlocking([&]() { return evaluator_(input, output); });
+        if (!evaluation.empty()) {
+            co_return evaluation;
+        }
+    }
+    co_return co_await defaultEvaluator(input, output);
+}
+
+Task<String> EvaluatorOptimizer::defaultOptimizer(const String& input, const JsonObject& feedback) {
+    // Each call gets its own context, so concurrent candidates never share a history
+    auto optimizer = context_->fork();
+    optimizer->setSystemPrompt(optimizer_prompt_);
+
+    String prompt = input;
+    if (feedback.contains("previous_output")) {
+        prompt += "\n\nPrevious response:\n" + feedback["previous_output"].get<String>();
+        prompt += "\n\nEvaluator feedback (score " + std::to_string(feedback.value("score", 0.0)) + "):\n";
+        prompt += feedback.value("feedback", "");
+        prompt += "\n\nWrite an improved response that addresses the feedback.";
+    }
+    if (feedback.contains("candidates")) {
+        prompt += "\n\nYou are writing candidate " + std::to_string(feedback["candidate"].get<size_t>()) +
+                  " of " + std::to_string(feedback["candidates"].get<size_t>()) +
+                  " written in parallel; take your own approach.";
+    }
+
+    auto response = co_await optimizer->chat(prompt);
+    co_return response.content;
+}
+
+Task<JsonObject> EvaluatorOptimizer::defaultEvaluator(const String& input, const String& output) {
+    auto evaluator = context_->fork();
+
+    String system_prompt = evaluator_prompt_;
+    if (!evaluation_criteria_.empty()) {
+        system_prompt += "\n\nEvaluation criteria:\n";
+        for (const auto& criterion : evaluation_criteria_) {
+            system_prompt += "- " + criterion + "\n";
+        }
+    }
+    system_prompt += "\nRespond only with JSON of the form {\"score\": <number from 0 to 1>, "
+                     "\"feedback\": \"<specific improvements>\"}.";
+    evaluator->setSystemPrompt(system_prompt);
+
+    auto response = co_await evaluator->chat("Request:\n" + input + "\n\nResponse:\n" + output);
+
+    auto start = response.content.find('{');
+    auto end = response.content.rfind('}');
+    if (start != String::npos && end != String::npos && end > start) {
+        try {
+            co_return JsonObject::parse(response.content.substr(start, end - start + 1));
+        } catch (const JsonObject::exception& e) {
+            Logger::warn("Evaluator returned malformed JSON: {}", e.what());
+        }
+    }
+    co_return JsonObject{{"score", 0.0}, {"feedback", response.content}};
+}
+
+} // namespace workflows
+} // namespace agents
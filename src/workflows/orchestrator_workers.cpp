@@ -0,0 +1,415 @@
+#include <agents-cpp/workflows/orchestrator_workers.h>
+#include <agents-cpp/logger.h>
+#include <folly/fibers/Semaphore.h>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace agents {
+namespace workflows {
+
+struct OrchestratorWorkers::RunState {
+    // Replicas of each worker, and the global in-flight cap if there is one
+    std::map<String, std::unique_ptr<folly::fibers::Semaphore>> replicas;
+    std::unique_ptr<folly::fibers::Semaphore> in_flight;
+
+    // Subtasks run here; stopping the run cancels them
+    folly::coro::AsyncScope scope;
+    folly::CancellationSource stop;
+    folly::CancellationToken token;
+
+    // One entry per dispatched subtask, in plan order
+    std::mutex mutex;
+    std::vector<JsonObject> results;
+};
+
+namespace {
+
+// Slots held by one subtask, released when it is done
+struct Permits {
+    folly::fibers::Semaphore* replica = nullptr;
+    folly::fibers::Semaphore* global = nullptr;
+
+    ~Permits() {
+        if (global) {
+            global->signal();
+        }
+        if (replica) {
+            replica->signal();
+        }
+    }
+};
+
+// Pulls complete top-level JSON objects out of text that arrives in pieces
+class ObjectScanner {
+public:
+    // Append text; returns the objects it completed
+    std::vector<String> feed(const String& text) {
+        std::vector<String> objects;
+        for (char c : text) {
+            if (depth_ == 0) {
+                // Text between objects (list brackets, commas, prose) is skipped
+                if (c == '{') {
+                    current_ = c;
+                    depth_ = 1;
+                }
+                continue;
+            }
+
+            current_ += c;
+            if (in_string_) {
+                if (escaped_) {
+                    escaped_ = false;
+                } else if (c == '\\') {
+                    escaped_ = true;
+                } else if (c == '"') {
+                    in_string_ = false;
+                }
+            } else if (c == '"') {
+                in_string_ = true;
+            } else if (c == '{') {
+                ++depth_;
+            } else if (c == '}' && --depth_ == 0) {
+                objects.push_back(std::move(current_));
+                current_.clear();
+            }
+        }
+        return objects;
+    }
+
+private:
+    String current_;
+    size_t depth_ = 0;
+    bool in_string_ = false;
+    bool escaped_ = false;
+};
+
+// Subtasks in a parsed plan object: the object itself, or its "subtasks" list
+std::vector<JsonObject> subtasksIn(const JsonObject& object) {
+    std::vector<JsonObject> subtasks;
+    if (object.contains("subtasks") && object["subtasks"].is_array()) {
+        for (const auto& subtask : object["subtasks"]) {
+            if (subtask.is_object()) {
+                subtasks.push_back(subtask);
+            }
+        }
+    } else if (object.contains("worker") || object.contains("worker_name")) {
+        subtasks.push_back(object);
+    }
+    return subtasks;
+}
+
+// Text a worker produced: its "response" or "output" if it has one, otherwise the whole result
+String outputText(const JsonObject& result) {
+    for (const char* key : {"response", "output"}) {
+        if (result.contains(key) && result[key].is_string()) {
+            return result[key].get<String>();
+        }
+    }
+    return result.dump();
+}
+
+} // namespace
+
+OrchestratorWorkers::OrchestratorWorkers(std::shared_ptr<AgentContext> context)
+    : Workflow(context) {
+}
+
+void OrchestratorWorkers::setOrchestratorPrompt(const String& orchestrator_prompt) {
+    orchestrator_prompt_ = orchestrator_prompt;
+}
+
+void OrchestratorWorkers::registerWorker(const Worker& worker) {
+    if (worker.replicas == 0) {
+        throw std::invalid_argument("Worker " + worker.name + " needs at least one replica");
+    }
+    for (auto& existing : workers_) {
+        if (existing.name == worker.name) {
+            existing = worker;
+            return;
+        }
+    }
+    workers_.push_back(worker);
+}
+
+void OrchestratorWorkers::registerWorker(
+    const String& name,
+    const String& description,
+    const String& system_prompt
+) {
+    registerWorker(name, description, system_prompt, nullptr);
+}
+
+void OrchestratorWorkers::registerWorker(
+    const String& name,
+    const String& description,
+    const String& system_prompt,
+    std::function<JsonObject(const String&, const JsonObject&)> handler
+) {
+    Worker worker;
+    worker.name = name;
+    worker.description = description;
+    worker.system_prompt = system_prompt;
+    worker.handler = handler;
+    registerWorker(worker);
+}
+
+void OrchestratorWorkers::setWorkerReplicas(const String& name, size_t replicas) {
+    if (replicas == 0) {
+        throw std::invalid_argument("Worker " + name + " needs at least one replica");
+    }
+    for (auto& worker : workers_) {
+        if (worker.name == name) {
+            worker.replicas = replicas;
+            return;
+        }
+    }
+    throw std::invalid_argument("Unknown worker: " + name);
+}
+
+void OrchestratorWorkers::setMaxInFlight(size_t max_in_flight) {
+    max_in_flight_ = max_in_flight;
+}
+
+void OrchestratorWorkers::setIncrementalDispatch(bool incremental) {
+    incremental_dispatch_ = incremental;
+}
+
+void OrchestratorWorkers::setSynthesizer(std::function<JsonObject(const std::vector<JsonObject>&)> synthesizer) {
+    synthesizer_ = synthesizer;
+}
+
+JsonObject OrchestratorWorkers::run(const String& input) {
+    return blockingWait(execute(input));
+}
+
+Task<JsonObject> OrchestratorWorkers::runTask(const String& input) {
+    return execute(input);
+}
+
+Task<JsonObject> OrchestratorWorkers::execute(const String& input) {
+    if (workers_.empty()) {
+        throw std::runtime_error("No workers registered in orchestrator-workers workflow");
+    }
+
+    RunState state;
+    for (const auto& worker : workers_) {
+        state.replicas[worker.name] = std::make_unique<folly::fibers::Semaphore>(worker.replicas);
+    }
+    if (max_in_flight_ > 0) {
+        state.in_flight = std::make_unique<folly::fibers::Semaphore>(max_in_flight_);
+    }
+    const folly::CancellationToken& caller = co_await folly::coro::co_current_cancellation_token;
+    state.token = folly::CancellationToken::merge(caller, state.stop.getToken());
+
+    // The orchestrator plans on a context of its own, so its prompt never lands in the shared history
+    auto orchestrator = context_->fork();
+    orchestrator->setSystemPrompt(orchestratorSystemPrompt());
+
+    String plan;
+    ObjectScanner scanner;
+    auto take = [&](const String& text) {
+        plan += text;
+        for (const auto& object : scanner.feed(text)) {
+            try {
+                for (const auto& subtask : subtasksIn(JsonObject::parse(object))) {
+                    dispatch(subtask, state);
+                }
+            } catch (const JsonObject::exception& e) {
+                Logger::warn("Skipping malformed subtask in orchestrator plan: {}", e.what());
+            }
+        }
+    };
+
+    // Subtasks start as the plan is parsed; a failed plan cancels those already running
+    std::exception_ptr plan_error;
+    try {
+        if (incremental_dispatch_) {
+            auto stream = orchestrator->streamChat(input);
+            while (auto chunk = co_await stream.next()) {
+                take(*chunk);
+            }
+        } else {
+            auto response = co_await orchestrator->chat(input);
+            take(response.content);
+        }
+    } catch (...) {
+        plan_error = std::current_exception();
+        state.stop.requestCancellation();
+    }
+    co_await state.scope.joinAsync();
+
+    if (plan_error) {
+        std::rethrow_exception(plan_error);
+    }
+    if (caller.isCancellationRequested()) {
+        throw folly::OperationCancelled();
+    }
+
+    if (state.results.empty()) {
+        Logger::warn("Orchestrator plan contained no subtasks");
+        co_return JsonObject{{"answer", plan}, {"subtasks", JsonObject::array()}};
+    }
+
+    JsonObject result = synthesizer_ ? synthesizer_(state.results) : defaultSynthesizer(state.results);
+    JsonObject subtasks = JsonObject::array();
+    for (const auto& subtask : state.results) {
+        JsonObject summary = {
+            {"worker_name", subtask["worker_name"]},
+            {"task", subtask["task"]},
+            {"status", subtask["status"]},
+            {"latency_ms", subtask["latency_ms"]}
+        };
+        if (subtask.contains("error")) {
+            summary["error"] = subtask["error"];
+        }
+        subtasks.push_back(summary);
+    }
+    result["subtasks"] = subtasks;
+    co_return result;
+}
+
+void OrchestratorWorkers::dispatch(const JsonObject& subtask, RunState& state) {
+    String worker_name = subtask.value("worker", subtask.value("worker_name", ""));
+    size_t index;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        index = state.results.size();
+        state.results.push_back({
+            {"worker_name", worker_name},
+            {"task", subtask.value("task", "")},
+            {"status", "cancelled"},
+            {"latency_ms", 0}
+        });
+    }
+
+    Logger::debug("Dispatching subtask {} to {}", index, worker_name);
+    state.scope.add(
+        folly::coro::co_withCancellation(state.token, runSubtask(index, subtask, state))
+            .scheduleOn(getExecutor())
+    );
+}
+
+Task<void> OrchestratorWorkers::runSubtask(size_t index, JsonObject subtask, RunState& state) {
+    String worker_name = subtask.value("worker", subtask.value("worker_name", ""));
+    String task = subtask.value("task", "");
+    JsonObject context_data = subtask.value("context", JsonObject::object());
+
+    JsonObject outcome;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        auto replicas = state.replicas.find(worker_name);
+        if (replicas == state.replicas.end()) {
+            throw std::invalid_argument("Unknown worker: " + worker_name);
+        }
+
+        // Take a replica of the worker first so a backlog for one worker does not hold global slots
+        Permits permits;
+        co_await replicas->second->co_wait();
+        permits.replica = replicas->second.get();
+        if (state.in_flight) {
+            co_await state.in_flight->co_wait();
+            permits.global = state.in_flight.get();
+        }
+        start = std::chrono::steady_clock::now();
+
+        JsonObject output = co_await executeWorker(worker_name, task, context_data);
+        outcome["status"] = "succeeded";
+        outcome["output"] = outputText(output);
+        outcome["result"] = output;
+    } catch (const folly::OperationCancelled&) {
+        outcome["status"] = "cancelled";
+    } catch (const std::exception& e) {
+        outcome["status"] = "failed";
+        outcome["error"] = e.what();
+    }
+    outcome["latency_ms"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    JsonObject recorded;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.results[index].update(outcome);
+        recorded = state.results[index];
+    }
+    logStep("Subtask " + std::to_string(index) + " (" + worker_name + ")", recorded);
+}
+
+Task<JsonObject> OrchestratorWorkers::executeWorker(
+    const String& worker_name,
+    const String& task,
+    const JsonObject& context_data
+) {
+    const Worker* worker = nullptr;
+    for (const auto& candidate : workers_) {
+        if (candidate.name == worker_name) {
+            worker = &candidate;
+            break;
+        }
+    }
+    if (!worker) {
+        throw std::invalid_argument("Unknown worker: " + worker_name);
+    }
+
+    if (worker->handler) {
+        co_return co_await runBlocking([&]() { return worker->handler(task, context_data); });
+    }
+
+    // Each subtask gets its own context, so replicas never share a history
+    auto worker_context = context_->fork();
+    worker_context->setSystemPrompt(worker->system_prompt);
+    String prompt = task;
+    if (!context_data.empty()) {
+        prompt += "\n\nContext:\n" + context_data.dump(2);
+    }
+    auto response = co_await worker_context->chat(prompt);
+    co_return JsonObject{{"response", response.content}};
+}
+
+JsonObject OrchestratorWorkers::defaultSynthesizer(const std::vector<JsonObject>& results) {
+    String answer;
+    for (const auto& result : results) {
+        if (result["status"] != "succeeded") {
+            continue;
+        }
+        answer += "## " + result["worker_name"].get<String>() + ": " + result["task"].get<String>() + "\n\n";
+        answer += result["output"].get<String>() + "\n\n";
+    }
+
+    JsonObject synthesized;
+    synthesized["answer"] = answer;
+    return synthesized;
+}
+
+String OrchestratorWorkers::orchestratorSystemPrompt() const {
+    String prompt = orchestrator_prompt_;
+    prompt += "\n\nAvailable workers:\n";
+    for (const auto& worker : workers_) {
+        prompt += "- " + worker.name + ": " + worker.description + "\n";
+    }
+    prompt += "\nBreak the task into subtasks for these workers. Write each subtask on its own line "
+              "as a JSON object {\"worker\": \"<worker name>\", \"task\": \"<instructions>\", "
+              "\"context\": {<optional data>}} and write nothing else. Subtasks run in parallel, "
+              "so each one must be self-contained.";
+    return prompt;
+}
+
+JsonObject OrchestratorWorkers::getWorkersSchema() const {
+    JsonObject worker_names = JsonObject::array();
+    for (const auto& worker : workers_) {
+        worker_names.push_back(worker.name);
+    }
+
+    JsonObject schema;
+    schema["type"] = "object";
+    schema["properties"]["worker"] = {{"type", "string"}, {"enum", worker_names}};
+    schema["properties"]["task"] = {{"type", "string"}};
+    schema["properties"]["context"] = {{"type", "object"}};
+    schema["required"] = {"worker", "task"};
+    return schema;
+}
+
+} // namespace workflows
+} // namespace agents
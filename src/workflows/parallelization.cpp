@@ -0,0 +1,362 @@
+#include <agents-cpp/workflows/parallelization.h>
+#include <agents-cpp/logger.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace agents {
+namespace workflows {
+
+struct Parallelization::RunState {
+    std::vector<TaskResult> results;
+    std::mutex mutex;
+    size_t finished = 0;
+    size_t succeeded = 0;
+    bool stopped = false;
+    
+    // Running tally of normalized votes (VOTING mode)
+    std::map<String, size_t> votes;
+    size_t leader_votes = 0;
+    folly::CancellationSource stop;
+};
+
+namespace {
+
+const char* statusName(Parallelization::TaskResult::Status status) {
+    switch (status) {
+        case Parallelization::TaskResult::Status::SUCCEEDED:
+            return "succeeded";
+        case Parallelization::TaskResult::Status::FAILED:
+            return "failed";
+        case Parallelization::TaskResult::Status::TIMED_OUT:
+            return "timed_out";
+        case Parallelization::TaskResult::Status::CANCELLED:
+            return "cancelled";
+    }
+    return "unknown";
+}
+
+JsonObject describe(const Parallelization::TaskResult& result) {
+    JsonObject description;
+    description["name"] = result.name;
+    description["status"] = statusName(result.status);
+    description["latency_ms"] = result.latency.count();
+    if (!result.error.empty()) {
+        description["error"] = result.error;
+    }
+    return description;
+}
+
+// Text a task contributed: its "response" if it has one, otherwise the whole result
+String responseText(const JsonObject& result) {
+    if (result.contains("response") && result["response"].is_string()) {
+        return result["response"].get<String>();
+    }
+    return result.dump();
+}
+
+// Votes compare equal regardless of case, spacing and trailing punctuation
+String normalizeVote(const String& text) {
+    String normalized;
+    for (char c : text) {
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            if (!normalized.empty() && normalized.back() != ' ') {
+                normalized += ' ';
+            }
+        } else {
+            normalized += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    while (!normalized.empty() &&
+           (normalized.back() == ' ' || normalized.back() == '.' || normalized.back() == '!')) {
+        normalized.pop_back();
+    }
+    return normalized;
+}
+
+} // namespace
+
+Parallelization::Parallelization(std::shared_ptr<AgentContext> context, Mode mode)
+    : Workflow(context), mode_(mode) {
+}
+
+void Parallelization::addTask(const Task& task) {
+    tasks_.push_back(task);
+}
+
+void Parallelization::addTask(const String& name, const String& system_prompt) {
+    addTask(name, system_prompt, nullptr, nullptr);
+}
+
+void Parallelization::addTask(
+    const String& name,
+    const String& system_prompt,
+    std::function<String(const String&)> prompt_fn
+) {
+    addTask(name, system_prompt, prompt_fn, nullptr);
+}
+
+void Parallelization::addTask(
+    const String& name,
+    const String& system_prompt,
+    std::function<String(const String&)> prompt_fn,
+    std::function<JsonObject(const String&)> result_parser
+) {
+    Task task;
+    task.name = name;
+    task.system_prompt = system_prompt;
+
+    // Default prompt function passes the input through
+    task.prompt_fn = prompt_fn ? prompt_fn : [](const String& input) {
+        return input;
+    };
+
+    // Default parser keeps the raw response
+    task.result_parser = result_parser ? result_parser : [](const String& output) {
+        return JsonObject{{"response", output}};
+    };
+
+    addTask(task);
+}
+
+void Parallelization::setAggregator(std::function<JsonObject(const std::vector<JsonObject>&)> aggregator) {
+    aggregator_ = aggregator;
+}
+
+void Parallelization::setVotingThreshold(double threshold) {
+    if (threshold < 0.0 || threshold > 1.0) {
+        throw std::invalid_argument("Voting threshold must be between 0 and 1");
+    }
+    voting_threshold_ = threshold;
+}
+
+void Parallelization::setStopOnQuorum(bool stop_on_quorum) {
+    stop_on_quorum_ = stop_on_quorum;
+}
+
+void Parallelization::setMaxConcurrency(size_t max_concurrency) {
+    max_concurrency_ = max_concurrency;
+}
+
+void Parallelization::setTaskTimeout(std::chrono::milliseconds timeout) {
+    task_timeout_ = timeout;
+}
+
+void Parallelization::setMinResults(size_t min_results) {
+    min_results_ = min_results;
+}
+
+void Parallelization::setResultCallback(std::function<void(const TaskResult&)> callback) {
+    result_callback_ = callback;
+}
+
+JsonObject Parallelization::run(const String& input) {
+    if (tasks_.empty()) {
+        throw std::runtime_error("No tasks added to parallelization workflow");
+    }
+
+    auto results = blockingWait(runTasksInParallel(input));
+
+    // Aggregate whatever succeeded; failures are reported alongside
+    std::vector<JsonObject> outputs;
+    JsonObject tasks = JsonObject::array();
+    for (const auto& task_result : results) {
+        if (task_result.status == TaskResult::Status::SUCCEEDED) {
+            outputs.push_back(task_result.result);
+        }
+        tasks.push_back(describe(task_result));
+    }
+
+    JsonObject result;
+    if (outputs.empty()) {
+        result["error"] = "All parallel tasks failed";
+    } else if (aggregator_) {
+        result = aggregator_(outputs);
+    } else if (mode_ == Mode::VOTING) {
+        result = defaultVotingAggregator(outputs, tasks_.size());
+    } else {
+        result = defaultSectionAggregator(outputs);
+    }
+    result["tasks"] = tasks;
+
+    return result;
+}
+
+agents::Task<std::vector<Parallelization::TaskResult>> Parallelization::runTasksInParallel(const String& input) {
+    RunState state;
+    state.results.resize(tasks_.size());
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+        state.results[i].name = tasks_[i].name;
+    }
+
+    // Stopping early cancels the tasks in flight and those not started yet
+    const folly::CancellationToken& caller = co_await folly::coro::co_current_cancellation_token;
+    auto token = folly::CancellationToken::merge(caller, state.stop.getToken());
+
+    // Tasks are scheduled on the agent executor and their LLM calls block on the
+    // blocking executor, so calls overlap beyond the number of cores
+    std::vector<folly::coro::TaskWithExecutor<void>> runs;
+    runs.reserve(tasks_.size());
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+        runs.push_back(folly::coro::co_withCancellation(token, runTask(i, input, state)).scheduleOn(getExecutor()));
+    }
+
+    size_t window = max_concurrency_ > 0 ? max_concurrency_ : runs.size();
+    co_await folly::coro::collectAllWindowed(std::move(runs), window);
+
+    if (caller.isCancellationRequested()) {
+        throw folly::OperationCancelled();
+    }
+    co_return std::move(state.results);
+}
+
+agents::Task<void> Parallelization::runTask(size_t index, const String& input, RunState& state) {
+    const Task& task = tasks_[index];
+    TaskResult result;
+    result.name = task.name;
+    auto start = std::chrono::steady_clock::now();
+
+    const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+    if (!token.isCancellationRequested()) {
+        try {
+            // A forked context keeps this task's system prompt and history to itself
+            auto task_context = context_->fork();
+            task_context->setSystemPrompt(task.system_prompt);
+            String prompt = task.prompt_fn ? task.prompt_fn(input) : input;
+
+            LLMResponse response;
+            if (task_timeout_.count() > 0) {
+                response = co_await folly::coro::timeout(task_context->chat(prompt), task_timeout_);
+            } else {
+                response = co_await task_context->chat(prompt);
+            }
+
+            result.result = task.result_parser ? task.result_parser(response.content)
+                                               : JsonObject{{"response", response.content}};
+            result.status = TaskResult::Status::SUCCEEDED;
+        } catch (const folly::FutureTimeout&) {
+            result.status = TaskResult::Status::TIMED_OUT;
+            result.error = "Timed out after " + std::to_string(task_timeout_.count()) + " ms";
+        } catch (const folly::OperationCancelled&) {
+            result.status = TaskResult::Status::CANCELLED;
+        } catch (const std::exception& e) {
+            result.status = TaskResult::Status::FAILED;
+            result.error = e.what();
+        }
+    }
+    result.latency = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    if (recordResult(index, std::move(result), state)) {
+        state.stop.requestCancellation();
+    }
+}
+
+bool Parallelization::recordResult(size_t index, TaskResult result, RunState& state) {
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    ++state.finished;
+    if (result.status == TaskResult::Status::SUCCEEDED) {
+        ++state.succeeded;
+        if (mode_ == Mode::VOTING) {
+            size_t count = ++state.votes[normalizeVote(responseText(result.result))];
+            state.leader_votes = std::max(state.leader_votes, count);
+        }
+    }
+    state.results[index] = std::move(result);
+    const TaskResult& recorded = state.results[index];
+
+    // Stream every real outcome; tasks cancelled after the run stopped are only noise
+    if (recorded.status != TaskResult::Status::CANCELLED) {
+        if (result_callback_) {
+            result_callback_(recorded);
+        }
+        logStep(recorded.name, describe(recorded));
+    }
+
+    if (state.stopped) {
+        return false;
+    }
+    size_t remaining = state.results.size() - state.finished;
+    if (remaining == 0) {
+        return false;
+    }
+    
+    if (min_results_ > 0 && state.succeeded >= min_results_) {
+        Logger::debug("Parallelization has {} results, cancelling {} remaining tasks",
+                      state.succeeded, remaining);
+        state.stopped = true;
+    }
+    
+    // The vote is decided once the leader has the required votes, or once even
+    // winning every outstanding vote would not get it there
+    if (mode_ == Mode::VOTING && stop_on_quorum_) {
+        size_t required = requiredVotes(state.results.size());
+        if (state.leader_votes >= required || state.leader_votes + remaining < required) {
+            Logger::debug("Vote decided after {} of {} votes, cancelling {} remaining",
+                          state.finished, state.results.size(), remaining);
+            state.stopped = true;
+        }
+    }
+    return state.stopped;
+}
+
+size_t Parallelization::requiredVotes(size_t voters) const {
+    // A strict majority at 0.5, unanimity at 1.0
+    auto required = static_cast<size_t>(std::floor(voting_threshold_ * static_cast<double>(voters))) + 1;
+    return std::min(required, voters);
+}
+
+JsonObject Parallelization::defaultSectionAggregator(const std::vector<JsonObject>& results) {
+    JsonObject combined;
+    String answer;
+    combined["sections"] = JsonObject::array();
+
+    // Sections keep the order the tasks were added in
+    for (const auto& result : results) {
+        if (!answer.empty()) {
+            answer += "\n\n";
+        }
+        answer += responseText(result);
+        combined["sections"].push_back(result);
+    }
+    combined["answer"] = answer;
+
+    return combined;
+}
+
+JsonObject Parallelization::defaultVotingAggregator(const std::vector<JsonObject>& results, size_t voters) {
+    // Tally normalized answers, remembering the first wording of each
+    std::map<String, size_t> tally;
+    std::map<String, String> wording;
+    String winner;
+    size_t winner_votes = 0;
+    for (const auto& result : results) {
+        String text = responseText(result);
+        String vote = normalizeVote(text);
+        wording.emplace(vote, text);
+        size_t count = ++tally[vote];
+        if (count > winner_votes) {
+            winner = vote;
+            winner_votes = count;
+        }
+    }
+
+    JsonObject combined;
+    combined["answer"] = wording[winner];
+    combined["votes"] = JsonObject::object();
+    for (const auto& [vote, count] : tally) {
+        combined["votes"][wording[vote]] = count;
+    }
+    combined["agreement"] = static_cast<double>(winner_votes) / static_cast<double>(results.size());
+    combined["voters"] = voters;
+    combined["consensus"] = winner_votes >= requiredVotes(voters);
+
+    return combined;
+}
+
+} // namespace workflows
+} // namespace agents
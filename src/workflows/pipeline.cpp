@@ -0,0 +1,233 @@
+#include <agents-cpp/workflows/pipeline.h>
+#include <folly/fibers/Semaphore.h>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace agents {
+namespace workflows {
+
+namespace {
+
+// An item, its index and whether a stage has failed it
+struct Entry {
+    size_t index;
+    JsonObject item;
+    bool failed = false;
+};
+
+// An empty slot tells a worker to stop
+using Slot = std::optional<Entry>;
+using Queue = folly::coro::BoundedQueue<Slot, false, false>;
+
+// State of one run. Queue operations run without a cancellation token, so
+// cancelling a run drains it (stages fail fast) rather than abandoning items.
+struct Run {
+    const std::vector<Pipeline::Stage>& stages;
+    std::vector<size_t> workers;
+    std::vector<std::unique_ptr<Queue>> queues;   // queues[k] feeds stage k, the last one the collector
+    std::vector<std::atomic<size_t>> live;        // Workers still running, per stage
+    folly::fibers::Semaphore admission;           // Items admitted but not yet delivered
+    folly::CancellationToken token;
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    Run(const std::vector<Pipeline::Stage>& stages, std::vector<size_t> workers,
+        size_t capacity, size_t window, folly::CancellationToken token)
+        : stages(stages),
+          workers(std::move(workers)),
+          live(stages.size()),
+          admission(window),
+          token(std::move(token)) {
+        for (size_t k = 0; k <= stages.size(); ++k) {
+            queues.push_back(std::make_unique<Queue>(static_cast<uint32_t>(capacity)));
+        }
+        for (size_t k = 0; k < stages.size(); ++k) {
+            live[k] = this->workers[k];
+        }
+    }
+
+    void fail(std::exception_ptr exception) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+            error = exception;
+        }
+    }
+
+    bool failed() {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        return error != nullptr;
+    }
+
+    // Tell every consumer of queue k to stop
+    agents::Task<void> close(size_t k) {
+        size_t consumers = k < stages.size() ? workers[k] : 1;
+        for (size_t i = 0; i < consumers; ++i) {
+            co_await queues[k]->enqueue(Slot());
+        }
+    }
+};
+
+agents::Task<void> feed(Run& run, AsyncGenerator<JsonObject> items) {
+    try {
+        size_t index = 0;
+        while (!run.token.isCancellationRequested() && !run.failed()) {
+            co_await run.admission.co_wait();
+            auto next = co_await items.next();
+            if (!next) {
+                break;
+            }
+            co_await run.queues[0]->enqueue(Slot(Entry{index++, std::move(*next)}));
+        }
+    } catch (...) {
+        run.fail(std::current_exception());
+    }
+    co_await run.close(0);
+}
+
+// Record a stage failure on an item; a stage may have left it something other than an object
+void markFailed(JsonObject& item, const String& error, const String& stage) {
+    if (!item.is_object()) {
+        item = JsonObject{{"item", std::move(item)}};
+    }
+    item["error"] = error;
+    item["failed_stage"] = stage;
+}
+
+agents::Task<void> work(Run& run, size_t k) {
+    const auto& stage = run.stages[k];
+    while (true) {
+        Slot slot = co_await run.queues[k]->dequeue();
+        if (!slot) {
+            break;
+        }
+
+        // Failed items pass through the remaining stages untouched
+        if (!slot->failed) {
+            JsonObject& item = slot->item;
+            try {
+                co_await folly::coro::co_withCancellation(run.token, stage.process(item));
+            } catch (const folly::OperationCancelled&) {
+                markFailed(item, "Cancelled", stage.name);
+                slot->failed = true;
+            } catch (const std::exception& e) {
+                markFailed(item, e.what(), stage.name);
+                slot->failed = true;
+            }
+        }
+        co_await run.queues[k + 1]->enqueue(std::move(slot));
+    }
+
+    // The last worker of a stage to finish closes the next queue
+    if (--run.live[k] == 0) {
+        co_await run.close(k + 1);
+    }
+}
+
+AsyncGenerator<JsonObject> fromVector(std::vector<JsonObject> items) {
+    for (auto& item : items) {
+        co_yield std::move(item);
+    }
+}
+
+} // namespace
+
+Pipeline::Pipeline(std::vector<Stage> stages, const PipelineOptions& options)
+    : stages_(std::move(stages)), options_(options) {
+    if (stages_.empty()) {
+        throw std::invalid_argument("Pipeline needs at least one stage");
+    }
+    if (options_.queue_capacity == 0) {
+        throw std::invalid_argument("Pipeline queue capacity must be positive");
+    }
+    for (size_t k = 0; k < stages_.size(); ++k) {
+        if (!stages_[k].process) {
+            throw std::invalid_argument("Pipeline stage " + stages_[k].name + " has no process function");
+        }
+        if (workersFor(k) == 0) {
+            throw std::invalid_argument("Pipeline stage " + stages_[k].name + " needs at least one worker");
+        }
+    }
+}
+
+size_t Pipeline::workersFor(size_t stage) const {
+    auto it = options_.stage_workers.find(stages_[stage].name);
+    return it != options_.stage_workers.end() ? it->second : options_.workers;
+}
+
+agents::Task<void> Pipeline::run(
+    AsyncGenerator<JsonObject> items,
+    std::function<void(size_t, JsonObject)> on_result
+) {
+    std::vector<size_t> workers;
+    size_t window = (stages_.size() + 1) * options_.queue_capacity;
+    for (size_t k = 0; k < stages_.size(); ++k) {
+        workers.push_back(workersFor(k));
+        window += workers.back();
+    }
+
+    const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+    Run run(stages_, std::move(workers), options_.queue_capacity, window, token);
+
+    // Feeder and workers run on the agent executor; this coroutine collects
+    folly::coro::AsyncScope scope;
+    scope.add(feed(run, std::move(items)).scheduleOn(getExecutor()));
+    for (size_t k = 0; k < stages_.size(); ++k) {
+        for (size_t i = 0; i < run.workers[k]; ++i) {
+            scope.add(work(run, k).scheduleOn(getExecutor()));
+        }
+    }
+
+    // Out-of-order arrivals wait here until the items before them are delivered
+    std::map<size_t, JsonObject> arrived;
+    size_t next = 0;
+    auto deliver = [&](size_t index, JsonObject item) {
+        run.admission.signal();
+        if (run.failed()) {
+            return;
+        }
+        try {
+            on_result(index, std::move(item));
+        } catch (...) {
+            run.fail(std::current_exception());
+        }
+    };
+
+    while (true) {
+        Slot slot = co_await run.queues[stages_.size()]->dequeue();
+        if (!slot) {
+            break;
+        }
+        if (!options_.ordered) {
+            deliver(slot->index, std::move(slot->item));
+            continue;
+        }
+        arrived.emplace(slot->index, std::move(slot->item));
+        for (auto it = arrived.begin(); it != arrived.end() && it->first == next; it = arrived.erase(it)) {
+            deliver(next++, std::move(it->second));
+        }
+    }
+
+    co_await scope.joinAsync();
+
+    if (run.error) {
+        std::rethrow_exception(run.error);
+    }
+    if (token.isCancellationRequested()) {
+        throw folly::OperationCancelled();
+    }
+}
+
+agents::Task<std::vector<JsonObject>> Pipeline::run(std::vector<JsonObject> items) {
+    std::vector<JsonObject> results(items.size());
+    co_await run(fromVector(std::move(items)), [&results](size_t index, JsonObject item) {
+        results[index] = std::move(item);
+    });
+    co_return results;
+}
+
+} // namespace workflows
+} // namespace agents
@@ -1,14 +1,63 @@
 #include <agents-cpp/workflows/prompt_chain.h>
 #include <spdlog/spdlog.h>
+#include <algorithm>
+#include <stdexcept>
 
 namespace agents {
 namespace workflows {
 
+namespace {
+
+// Initial pipeline state of one input
+JsonObject pipelineState(const String& input) {
+    JsonObject state;
+    state["current"] = input;
+    state["steps"]["input"] = input;
+    return state;
+}
+
+AsyncGenerator<JsonObject> pipelineStates(AsyncGenerator<String> inputs) {
+    while (auto input = co_await inputs.next()) {
+        co_yield pipelineState(*input);
+    }
+}
+
+// Result of one pipelined input, shaped like the result of run()
+JsonObject pipelineResult(JsonObject state) {
+    JsonObject result;
+    result["steps"] = std::move(state["steps"]);
+    result["final_output"] = std::move(state["current"]);
+    if (state.contains("error")) {
+        result["error"] = std::move(state["error"]);
+        result["failed_step"] = std::move(state["failed_stage"]);
+    }
+    return result;
+}
+
+} // namespace
+
 PromptChain::PromptChain(std::shared_ptr<AgentContext> context)
     : Workflow(context) {
 }
 
 void PromptChain::addStep(const Step& step) {
+    if (step.name.empty() || step.name == "input") {
+        throw std::invalid_argument("Invalid step name: '" + step.name + "'");
+    }
+    bool duplicate = std::any_of(steps_.begin(), steps_.end(), [&](const Step& earlier) {
+        return earlier.name == step.name;
+    });
+    if (duplicate) {
+        throw std::invalid_argument("Duplicate step: " + step.name);
+    }
+    for (const auto& input : step.inputs) {
+        bool known = input == "input" || std::any_of(steps_.begin(), steps_.end(), [&](const Step& earlier) {
+            return earlier.name == input;
+        });
+        if (!known) {
+            throw std::invalid_argument("Step " + step.name + " reads unknown step " + input);
+        }
+    }
     steps_.push_back(step);
 }
 
@@ -63,67 +112,144 @@ void PromptChain::addStep(
     addStep(step);
 }
 
-JsonObject PromptChain::run(const String& input) {
-    // Initialize step outputs
-    step_outputs_ = JsonObject();
-    
-    // Store the input
-    step_outputs_["input"] = input;
+void PromptChain::addStep(
+    const String& name,
+    const String& system_prompt,
+    const std::vector<String>& inputs,
+    std::function<String(const String&, const JsonObject&)> prompt_fn
+) {
+    Step step;
+    step.name = name;
+    step.system_prompt = system_prompt;
+    step.inputs = inputs;
+    step.prompt_fn = prompt_fn;
     
-    // Initialize result
-    String current_result = input;
+    addStep(step);
+}
+
+JsonObject PromptChain::run(const String& input) {
+    return blockingWait(execute(input));
+}
+
+Task<JsonObject> PromptChain::runTask(const String& input) {
+    return execute(input);
+}
+
+Task<JsonObject> PromptChain::execute(const String& input) {
+    // Everything a run touches lives here, so concurrent runs do not interfere
+    JsonObject state = pipelineState(input);
     
     // Run each step in the chain
     for (size_t i = 0; i < steps_.size(); ++i) {
         const auto& step = steps_[i];
+        co_await runPipelineStep(i, state);
         
-        // Check if the step should be skipped
-        if (!step.gate_fn(current_result, step_outputs_)) {
-            spdlog::info("Skipping step {} based on gate function", step.name);
-            continue;
-        }
-        
-        // Format the prompt using the custom function
-        String formatted_prompt = step.prompt_fn(current_result, step_outputs_);
-        
-        // Set the system prompt for this step
-        context_->setSystemPrompt(step.system_prompt);
-        
-        // Decide whether to use tools or not for this step
-        LLMResponse response;
-        if (step.use_tools) {
-            response = context_->chatWithTools(formatted_prompt);
+        // A step that ran has recorded its output
+        if (state["steps"].contains(step.name)) {
+            logStep(step.name, state["steps"][step.name]);
         } else {
-            response = context_->chat(formatted_prompt);
+            spdlog::info("Skipping step {} based on gate function", step.name);
         }
-        
-        // Store the result
-        current_result = response.content;
-        
-        // Store the step output
-        JsonObject step_output;
-        step_output["prompt"] = formatted_prompt;
-        step_output["response"] = current_result;
-        if (!response.tool_calls.empty()) {
-            JsonObject tool_calls;
-            for (const auto& tool_call : response.tool_calls) {
-                tool_calls[tool_call.first] = tool_call.second;
+    }
+    
+    co_return pipelineResult(std::move(state));
+}
+
+std::vector<JsonObject> PromptChain::runBatch(
+    const std::vector<String>& inputs,
+    const PipelineOptions& options
+) {
+    std::vector<JsonObject> states;
+    states.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        states.push_back(pipelineState(input));
+    }
+    
+    Pipeline pipeline(pipelineStages(), options);
+    auto results = blockingWait(pipeline.run(std::move(states)));
+    for (auto& result : results) {
+        result = pipelineResult(std::move(result));
+    }
+    return results;
+}
+
+Task<void> PromptChain::runStream(
+    AsyncGenerator<String> inputs,
+    std::function<void(size_t, const JsonObject&)> on_result,
+    const PipelineOptions& options
+) {
+    Pipeline pipeline(pipelineStages(), options);
+    co_await pipeline.run(pipelineStates(std::move(inputs)), [&on_result](size_t index, JsonObject state) {
+        on_result(index, pipelineResult(std::move(state)));
+    });
+}
+
+std::vector<Pipeline::Stage> PromptChain::pipelineStages() {
+    if (steps_.empty()) {
+        throw std::runtime_error("No steps added to prompt chain");
+    }
+    
+    std::vector<Pipeline::Stage> stages;
+    for (size_t i = 0; i < steps_.size(); ++i) {
+        Pipeline::Stage stage;
+        stage.name = steps_[i].name;
+        stage.process = [this, i](JsonObject& state) {
+            return runPipelineStep(i, state);
+        };
+        stages.push_back(std::move(stage));
+    }
+    return stages;
+}
+
+Task<void> PromptChain::runPipelineStep(size_t index, JsonObject& state) {
+    const Step& step = steps_[index];
+    String current = state["current"].get<String>();
+    JsonObject& outputs = state["steps"];
+    
+    // A step that declares its inputs sees only those outputs
+    JsonObject declared;
+    if (!step.inputs.empty()) {
+        for (const auto& input : step.inputs) {
+            if (outputs.contains(input)) {
+                declared[input] = outputs[input];
             }
-            step_output["tool_calls"] = tool_calls;
         }
-        
-        step_outputs_[step.name] = step_output;
-        
-        // Log the step
-        logStep(step.name, step_output);
     }
+    const JsonObject& visible = step.inputs.empty() ? outputs : declared;
     
-    // Create final result
-    JsonObject result;
-    result["steps"] = step_outputs_;
-    result["final_output"] = current_result;
+    if (step.gate_fn && !step.gate_fn(current, visible)) {
+        co_return;
+    }
     
-    return result;
+    String prompt = step.prompt_fn ? step.prompt_fn(current, visible) : current;
+    JsonObject step_output = co_await runStep(step, prompt);
+    state["current"] = step_output["response"];
+    outputs[step.name] = std::move(step_output);
+}
+
+Task<JsonObject> PromptChain::runStep(const Step& step, const String& prompt) {
+    // A forked context keeps this step's system prompt and history to itself
+    auto step_context = context_->fork();
+    step_context->setSystemPrompt(step.system_prompt);
+    
+    LLMResponse response;
+    if (step.use_tools) {
+        response = co_await step_context->chatWithTools(prompt);
+    } else {
+        response = co_await step_context->chat(prompt);
+    }
+    
+    JsonObject step_output;
+    step_output["prompt"] = prompt;
+    step_output["response"] = response.content;
+    if (!response.tool_calls.empty()) {
+        JsonObject tool_calls;
+        for (const auto& tool_call : response.tool_calls) {
+            tool_calls[tool_call.first] = tool_call.second;
+        }
+        step_output["tool_calls"] = tool_calls;
+    }
+    co_return step_output;
 }
 
 } // namespace workflows
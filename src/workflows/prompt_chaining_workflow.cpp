@@ -24,6 +24,24 @@ struct ControllerState {
 // Forward declaration of controller behavior
 caf::behavior controllerBehavior(caf::stateful_actor<ControllerState>* self);
 
+namespace {
+
+// Replace each {{key}} with the matching field of the context
+String renderTemplate(const String& prompt_template, const JsonObject& context) {
+    String prompt = prompt_template;
+    for (const auto& [key, value] : context.items()) {
+        String placeholder = "{{" + key + "}}";
+        String text = value.is_string() ? value.get<String>() : value.dump();
+        for (size_t pos = prompt.find(placeholder); pos != String::npos;
+             pos = prompt.find(placeholder, pos + text.size())) {
+            prompt.replace(pos, placeholder.size(), text);
+        }
+    }
+    return prompt;
+}
+
+} // namespace
+
 
 // Constructor
 PromptChainingWorkflow::PromptChainingWorkflow(std::shared_ptr<AgentContext> context)
@@ -81,6 +99,72 @@ JsonObject PromptChainingWorkflow::run(const String& input) {
     }
 }
 
+// Run the steps over many inputs with the steps pipelined
+std::vector<JsonObject> PromptChainingWorkflow::runBatch(
+    const std::vector<String>& inputs,
+    const PipelineOptions& options
+) {
+    if (steps_.empty()) {
+        throw std::runtime_error("No steps added to prompt chaining workflow");
+    }
+    
+    std::vector<Pipeline::Stage> stages;
+    for (size_t i = 0; i < steps_.size(); ++i) {
+        Pipeline::Stage stage;
+        stage.name = steps_[i].name;
+        stage.process = [this, i](JsonObject& context) {
+            return runPipelineStep(i, context);
+        };
+        stages.push_back(std::move(stage));
+    }
+    
+    std::vector<JsonObject> contexts;
+    contexts.reserve(inputs.size());
+    for (const auto& input : inputs) {
+        contexts.push_back({{"input", input}});
+    }
+    
+    Pipeline pipeline(std::move(stages), options);
+    auto results = blockingWait(pipeline.run(std::move(contexts)));
+    
+    // Report failures by step, as PromptChain does
+    for (auto& result : results) {
+        if (result.contains("failed_stage")) {
+            result["failed_step"] = std::move(result["failed_stage"]);
+            result.erase("failed_stage");
+        }
+    }
+    return results;
+}
+
+// Same step semantics as the controller actor, on one input's context
+Task<void> PromptChainingWorkflow::runPipelineStep(size_t index, JsonObject& context) {
+    const auto& step = steps_[index];
+    
+    Message msg;
+    msg.role = Message::Role::USER;
+    msg.content = renderTemplate(step.prompt_template, context);
+    std::vector<Message> messages = {msg};
+    
+    auto llm_response = co_await llm_->chatAsync(messages);
+    
+    JsonObject step_result = {
+        {"name", step.name},
+        {"prompt", msg.content},
+        {"response", llm_response.content}
+    };
+    
+    if (step.validator && !step.validator(step_result)) {
+        throw std::runtime_error("Validation failed for step " + step.name);
+    }
+    
+    context = step.transformer ? step.transformer(step_result) : step_result;
+    
+    // Later templates read fields of the context, so keep it an object
+    if (!context.is_object()) {
+        context = JsonObject{{"response", std::move(context)}};
+    }
+}
 
 // Setup actor roles for this workflow
 void PromptChainingWorkflow::setupActorSystem() {
@@ -89,7 +173,7 @@ void PromptChainingWorkflow::setupActorSystem() {
     
     // Create controller actor
     if (actor_system_ && !controller_actor_) {
-        controller_actor_ = actor_system_->spawn(controllerBehavior);
+        controller_actor_ = spawnActor(controllerBehavior);
     }
 }
 
@@ -0,0 +1,230 @@
+#include <agents-cpp/workflows/route_classifier.h>
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+
+namespace agents {
+namespace workflows {
+
+namespace {
+
+// Relative weight of each feature kind in the hashed embedding
+constexpr float kWordWeight = 1.0f;
+constexpr float kBigramWeight = 0.7f;
+constexpr float kTrigramWeight = 0.3f;
+
+uint64_t fnv1a(std::string_view text, uint64_t hash = 14695981039346656037ull) {
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Lowercased words; non-ASCII bytes are kept as word characters
+std::vector<String> tokenize(const String& text) {
+    std::vector<String> tokens;
+    String token;
+    for (unsigned char c : text) {
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c >= 0x80) {
+            token.push_back(static_cast<char>(c));
+        } else if (c >= 'A' && c <= 'Z') {
+            token.push_back(static_cast<char>(c - 'A' + 'a'));
+        } else if (!token.empty()) {
+            tokens.push_back(std::move(token));
+            token.clear();
+        }
+    }
+    if (!token.empty()) {
+        tokens.push_back(std::move(token));
+    }
+    return tokens;
+}
+
+double dot(const std::vector<float>& a, const std::vector<float>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        sum += static_cast<double>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+// Scale a vector to unit length in place; returns false for the zero vector
+bool normalize(std::vector<float>& vector) {
+    double norm = std::sqrt(dot(vector, vector));
+    if (norm == 0.0) {
+        return false;
+    }
+    for (auto& value : vector) {
+        value = static_cast<float>(value / norm);
+    }
+    return true;
+}
+
+} // namespace
+
+RouteClassifier::RouteClassifier(const RouteClassifierOptions& options, Embedder embedder)
+    : options_(options), embedder_(std::move(embedder)) {
+    if (!embedder_ && options_.dimensions == 0) {
+        throw std::invalid_argument("Route classifier needs at least one dimension");
+    }
+    if (options_.temperature <= 0.0) {
+        throw std::invalid_argument("Route classifier temperature must be positive");
+    }
+    if (options_.min_confidence < 0.0 || options_.min_confidence > 1.0) {
+        throw std::invalid_argument("Route classifier min_confidence must be in [0, 1]");
+    }
+    if (!embedder_) {
+        dimensions_ = options_.dimensions;
+    }
+}
+
+void RouteClassifier::addExemplar(const String& route, const String& text) {
+    auto embedding = normalizedEmbedding(text);
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (dimensions_ == 0) {
+        dimensions_ = embedding.size();
+    } else if (embedding.size() != dimensions_) {
+        throw std::invalid_argument("Embedding has " + std::to_string(embedding.size()) +
+                                    " dimensions, expected " + std::to_string(dimensions_));
+    }
+
+    auto& centroid = centroids_[route];
+    if (centroid.sum.empty()) {
+        centroid.sum.assign(dimensions_, 0.0f);
+    }
+    for (size_t i = 0; i < dimensions_; ++i) {
+        centroid.sum[i] += embedding[i];
+    }
+    centroid.normalized = centroid.sum;
+    normalize(centroid.normalized);
+    ++centroid.count;
+}
+
+void RouteClassifier::addExemplars(const String& route, const std::vector<String>& texts) {
+    for (const auto& text : texts) {
+        addExemplar(route, text);
+    }
+}
+
+void RouteClassifier::learn(const String& route, const String& text) {
+    if (!options_.learn) {
+        return;
+    }
+    addExemplar(route, text);
+    ++learned_;
+}
+
+std::vector<RouteClassifier::Prediction> RouteClassifier::predict(const String& text) const {
+    auto embedding = normalizedEmbedding(text);
+
+    std::vector<Prediction> predictions;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (centroids_.empty()) {
+            return predictions;
+        }
+        if (embedding.size() != dimensions_) {
+            throw std::invalid_argument("Embedding has " + std::to_string(embedding.size()) +
+                                        " dimensions, expected " + std::to_string(dimensions_));
+        }
+        predictions.reserve(centroids_.size());
+        for (const auto& [route, centroid] : centroids_) {
+            predictions.push_back({route, dot(embedding, centroid.normalized), 0.0});
+        }
+    }
+
+    std::sort(predictions.begin(), predictions.end(), [](const Prediction& a, const Prediction& b) {
+        return a.similarity > b.similarity;
+    });
+
+    // Softmax over similarities, shifted by the best one for stability
+    double total = 0.0;
+    for (auto& prediction : predictions) {
+        prediction.confidence = std::exp((prediction.similarity - predictions.front().similarity) /
+                                         options_.temperature);
+        total += prediction.confidence;
+    }
+    for (auto& prediction : predictions) {
+        prediction.confidence /= total;
+    }
+    return predictions;
+}
+
+std::optional<RouteClassifier::Prediction> RouteClassifier::classify(const String& text) const {
+    ++queries_;
+    auto predictions = predict(text);
+    if (predictions.empty()) {
+        return std::nullopt;
+    }
+
+    const auto& best = predictions.front();
+    if (best.confidence < options_.min_confidence || best.similarity < options_.min_similarity) {
+        return std::nullopt;
+    }
+    ++confident_;
+    return best;
+}
+
+std::vector<float> RouteClassifier::embed(const String& text) const {
+    return embedder_ ? embedder_(text) : hashEmbed(text);
+}
+
+std::vector<String> RouteClassifier::routes() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::vector<String> names;
+    for (const auto& [route, centroid] : centroids_) {
+        names.push_back(route);
+    }
+    return names;
+}
+
+size_t RouteClassifier::exemplarCount(const String& route) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = centroids_.find(route);
+    return it != centroids_.end() ? it->second.count : 0;
+}
+
+RouteClassifier::Stats RouteClassifier::getStats() const {
+    Stats stats;
+    stats.queries = queries_;
+    stats.confident = confident_;
+    stats.learned = learned_;
+    return stats;
+}
+
+std::vector<float> RouteClassifier::hashEmbed(const String& text) const {
+    std::vector<float> embedding(options_.dimensions, 0.0f);
+
+    // The top bit of the hash picks the sign, so collisions cancel out on average
+    auto add = [&](uint64_t hash, float weight) {
+        embedding[hash % options_.dimensions] += (hash >> 63) ? -weight : weight;
+    };
+
+    auto tokens = tokenize(text);
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        add(fnv1a(tokens[i]), kWordWeight);
+        if (i + 1 < tokens.size()) {
+            add(fnv1a(tokens[i + 1], fnv1a(" ", fnv1a(tokens[i]))), kBigramWeight);
+        }
+
+        // Trigrams of the padded word match inflections and typos
+        String padded = "^" + tokens[i] + "$";
+        for (size_t j = 0; j + 3 <= padded.size(); ++j) {
+            add(fnv1a(std::string_view(padded).substr(j, 3), fnv1a("#")), kTrigramWeight);
+        }
+    }
+    return embedding;
+}
+
+std::vector<float> RouteClassifier::normalizedEmbedding(const String& text) const {
+    auto embedding = embed(text);
+    normalize(embedding);
+    return embedding;
+}
+
+} // namespace workflows
+} // namespace agents
@@ -0,0 +1,359 @@
+#include <agents-cpp/workflows/routing.h>
+#include <agents-cpp/logger.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace agents {
+namespace workflows {
+
+namespace {
+
+// Lowercase words of at least three characters, minus common filler
+std::set<String> words(const String& text) {
+    static const std::set<String> stop_words = {
+        "the", "and", "for", "are", "but", "not", "you", "all", "any", "can", "her", "was", "one",
+        "our", "out", "has", "how", "what", "when", "where", "who", "why", "with", "about", "this",
+        "that", "from", "into", "like", "such", "their", "there", "these", "those", "them", "then",
+        "than", "your", "have", "does", "questions", "query", "queries"
+    };
+
+    std::set<String> result;
+    String word;
+    auto flush = [&]() {
+        if (word.size() >= 3 && !stop_words.count(word)) {
+            result.insert(word);
+        }
+        word.clear();
+    };
+    for (char c : text) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            word += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else {
+            flush();
+        }
+    }
+    flush();
+    return result;
+}
+
+// Run a handler on the blocking executor on behalf of the awaiting coroutine, so LLM calls inside it observe cancellation
+Task<JsonObject> invokeHandler(Routing::RouteHandler handler, String input, JsonObject routing_info) {
+    co_return co_await runBlocking([&]() { return handler(input, routing_info); });
+}
+
+} // namespace
+
+double Routing::SpeculationStats::hitRate() const {
+    return speculated > 0 ? static_cast<double>(hits) / static_cast<double>(speculated) : 0.0;
+}
+
+Routing::Routing(std::shared_ptr<AgentContext> context)
+    : Workflow(context) {
+}
+
+void Routing::setRouterPrompt(const String& router_prompt) {
+    router_prompt_ = router_prompt;
+}
+
+void Routing::addRoute(const String& route_name, const String& route_description, RouteHandler handler) {
+    routes_[route_name] = {route_description, handler};
+
+    // Route names like "technical_query" contribute their parts as words
+    auto& route_words = route_words_[route_name];
+    for (const auto& word : words(route_name + " " + route_description)) {
+        route_words.insert(word);
+    }
+}
+
+void Routing::setDefaultRoute(RouteHandler handler) {
+    default_route_ = handler;
+}
+
+void Routing::addRouteKeywords(const String& route_name, const std::vector<String>& keywords) {
+    if (!routes_.count(route_name)) {
+        throw std::invalid_argument("Unknown route: " + route_name);
+    }
+    auto& route_words = route_words_[route_name];
+    for (const auto& keyword : keywords) {
+        for (const auto& word : words(keyword)) {
+            route_words.insert(word);
+        }
+    }
+}
+
+void Routing::setSpeculation(size_t max_routes, double min_confidence) {
+    speculation_routes_ = max_routes;
+    speculation_min_confidence_ = min_confidence;
+}
+
+void Routing::setRoutePredictor(RoutePredictor predictor) {
+    predictor_ = predictor;
+}
+
+void Routing::setLocalClassifier(std::shared_ptr<RouteClassifier> classifier) {
+    classifier_ = classifier;
+}
+
+std::vector<std::pair<String, double>> Routing::predictRoutes(const String& input) const {
+    if (predictor_) {
+        return predictor_(input);
+    }
+    if (classifier_) {
+        std::vector<std::pair<String, double>> predictions;
+        for (const auto& prediction : classifier_->predict(input)) {
+            predictions.emplace_back(prediction.route, prediction.confidence);
+        }
+        return predictions;
+    }
+    return predictByKeywords(input);
+}
+
+Routing::SpeculationStats Routing::getSpeculationStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return stats_;
+}
+
+JsonObject Routing::getRoutesSchema() const {
+    JsonObject route_names = JsonObject::array();
+    for (const auto& [name, route] : routes_) {
+        route_names.push_back(name);
+    }
+
+    JsonObject schema;
+    schema["type"] = "object";
+    schema["properties"]["route"] = {{"type", "string"}, {"enum", route_names}};
+    schema["properties"]["reasoning"] = {{"type", "string"}};
+    schema["required"] = {"route"};
+    return schema;
+}
+
+JsonObject Routing::run(const String& input) {
+    return blockingWait(execute(input));
+}
+
+Task<JsonObject> Routing::runTask(const String& input) {
+    return execute(input);
+}
+
+Task<JsonObject> Routing::execute(const String& input) {
+    if (routes_.empty() && !default_route_) {
+        throw std::runtime_error("No routes added to routing workflow");
+    }
+
+    // Inputs close to a route's exemplars skip the router LLM
+    if (classifier_) {
+        auto local = classifier_->classify(input);
+        if (local && routes_.count(local->route)) {
+            JsonObject routing_info = {
+                {"route", local->route},
+                {"classifier", "local"},
+                {"confidence", local->confidence},
+                {"similarity", local->similarity}
+            };
+            logStep("Routed to " + local->route, routing_info);
+
+            JsonObject result = co_await invokeHandler(handlerFor(local->route), input, routing_info)
+                .scheduleOn(getExecutor());
+            result["routing"] = routing_info;
+            co_return result;
+        }
+    }
+
+    // Start the handlers of the likely routes before the router has answered
+    struct Speculation {
+        String route;
+        folly::CancellationSource cancel;
+        folly::SemiFuture<JsonObject> result;
+    };
+    std::vector<Speculation> speculations;
+    if (speculation_routes_ > 0) {
+        for (const auto& [route, confidence] : predictRoutes(input)) {
+            if (speculations.size() >= speculation_routes_ || confidence < speculation_min_confidence_) {
+                break;
+            }
+            auto it = routes_.find(route);
+            if (it == routes_.end()) {
+                continue;
+            }
+
+            JsonObject routing_info = {{"route", route}, {"speculative", true}, {"confidence", confidence}};
+            Speculation speculation;
+            speculation.route = route;
+            speculation.result = folly::coro::co_withCancellation(
+                speculation.cancel.getToken(),
+                invokeHandler(it->second.second, input, routing_info)
+            ).scheduleOn(getExecutor()).start();
+            speculations.push_back(std::move(speculation));
+        }
+    }
+
+    JsonObject routing_info;
+    RouteHandler handler;
+    try {
+        routing_info = co_await classify(input);
+        handler = handlerFor(routing_info["route"].get<String>());
+    } catch (...) {
+        for (auto& speculation : speculations) {
+            speculation.cancel.requestCancellation();
+        }
+        throw;
+    }
+    String route = routing_info["route"].get<String>();
+    routing_info["classifier"] = "llm";
+    logStep("Routed to " + route, routing_info);
+
+    if (classifier_ && routes_.count(route)) {
+        classifier_->learn(route, input);
+    }
+
+    // Keep the correctly predicted handler, cancel the rest
+    auto hit = std::find_if(speculations.begin(), speculations.end(), [&](const Speculation& speculation) {
+        return speculation.route == route;
+    });
+    size_t wasted_tokens = 0;
+    for (auto it = speculations.begin(); it != speculations.end(); ++it) {
+        if (it == hit) {
+            continue;
+        }
+        it->cancel.requestCancellation();
+        wasted_tokens += estimateTokens(input);
+        if (it->result.isReady() && it->result.hasValue()) {
+            wasted_tokens += estimateTokens(it->result.value().dump());
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.requests;
+        if (!speculations.empty()) {
+            ++stats_.speculated;
+            ++(hit != speculations.end() ? stats_.hits : stats_.misses);
+            stats_.handlers_started += speculations.size();
+            stats_.handlers_wasted += speculations.size() - (hit != speculations.end() ? 1 : 0);
+            stats_.wasted_tokens += wasted_tokens;
+        }
+    }
+
+    JsonObject result;
+    if (hit != speculations.end()) {
+        Logger::debug("Speculative route {} confirmed by the router", route);
+
+        // Cancelling this run cancels the handler it is waiting for
+        const folly::CancellationToken& token = co_await folly::coro::co_current_cancellation_token;
+        folly::CancellationCallback forward(token, [&hit]() {
+            hit->cancel.requestCancellation();
+        });
+        result = co_await std::move(hit->result);
+    } else {
+        result = co_await invokeHandler(handler, input, routing_info).scheduleOn(getExecutor());
+    }
+
+    result["routing"] = routing_info;
+    co_return result;
+}
+
+Task<JsonObject> Routing::classify(const String& input) {
+    // The router gets a context of its own, so its prompt never lands in the shared history
+    auto router = context_->fork();
+    router->setSystemPrompt(routerSystemPrompt());
+    auto response = co_await router->chat(input);
+
+    String route;
+    String reasoning;
+    auto start = response.content.find('{');
+    auto end = response.content.rfind('}');
+    if (start != String::npos && end != String::npos && end > start) {
+        try {
+            auto parsed = JsonObject::parse(response.content.substr(start, end - start + 1));
+            route = parsed.value("route", "");
+            reasoning = parsed.value("reasoning", "");
+        } catch (const JsonObject::exception& e) {
+            Logger::warn("Router returned malformed JSON: {}", e.what());
+        }
+    }
+
+    // Fall back to the first route the reply mentions
+    if (!routes_.count(route)) {
+        for (const auto& [name, description] : routes_) {
+            if (response.content.find(name) != String::npos) {
+                route = name;
+                break;
+            }
+        }
+    }
+
+    co_return JsonObject{{"route", route}, {"reasoning", reasoning}};
+}
+
+String Routing::routerSystemPrompt() const {
+    String prompt = router_prompt_;
+    prompt += "\n\nAvailable routes:\n";
+    for (const auto& [name, route] : routes_) {
+        prompt += "- " + name + ": " + route.first + "\n";
+    }
+    prompt += "\nRespond only with JSON of the form {\"route\": \"<route name>\", "
+              "\"reasoning\": \"<one sentence>\"}.";
+    return prompt;
+}
+
+Routing::RouteHandler Routing::handlerFor(const String& route_name) const {
+    auto it = routes_.find(route_name);
+    if (it != routes_.end()) {
+        return it->second.second;
+    }
+    if (default_route_) {
+        return *default_route_;
+    }
+    throw std::runtime_error("No handler for route: " + route_name);
+}
+
+std::vector<std::pair<String, double>> Routing::predictByKeywords(const String& input) const {
+    auto input_words = words(input);
+
+    // Words shared by many routes say little about any of them
+    std::map<String, size_t> route_counts;
+    for (const auto& [name, route_words] : route_words_) {
+        for (const auto& word : route_words) {
+            ++route_counts[word];
+        }
+    }
+
+    std::vector<std::pair<String, double>> scores;
+    double total = 0.0;
+    for (const auto& [name, route_words] : route_words_) {
+        double score = 0.0;
+        for (const auto& word : input_words) {
+            if (route_words.count(word)) {
+                score += std::log(1.0 + static_cast<double>(route_words_.size()) /
+                                            static_cast<double>(route_counts[word]));
+            }
+        }
+        if (score > 0.0) {
+            scores.emplace_back(name, score);
+            total += score;
+        }
+    }
+
+    for (auto& [name, score] : scores) {
+        score /= total;
+    }
+    std::sort(scores.begin(), scores.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second;
+    });
+    return scores;
+}
+
+size_t Routing::estimateTokens(const String& text) const {
+    if (auto manager = context_->getContextManager()) {
+        Message message;
+        message.role = Message::Role::USER;
+        message.content = text;
+        return manager->countTokens(message);
+    }
+    return text.size() / 4;
+}
+
+} // namespace workflows
+} // namespace agents
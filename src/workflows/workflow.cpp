@@ -29,6 +29,10 @@ void Workflow::runAsync(
     thread.detach();
 }
 
+Task<JsonObject> Workflow::runTask(const String& input) {
+    co_return co_await runBlocking([&]() { return run(input); });
+}
+
 std::shared_ptr<AgentContext> Workflow::getContext() const {
     return context_;
 }